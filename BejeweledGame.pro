@@ -1,33 +1,39 @@
-QT       += core gui multimedia
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+TEMPLATE = subdirs
 
-CONFIG += c++11
+# gamecore: 不依赖 Qt 的游戏规则静态库
+# app:      Qt Widgets 界面程序，链接 gamecore
+# bench:    规则库微基准（命令行，输出 JSON 报告），链接 gamecore
+# playbench: 驱动 GameWidget 的端到端对局吞吐基准，链接 gamecore
+# corpus:   回放语料的构建与多线程批量分析（命令行），链接 gamecore
+# server:   多会话对局服务器（本地套接字 / 本机 TCP），链接 gamecore
+# gameload: gameserver 的压测客户端，链接 gamecore
+# sim:      多线程批量对局模拟（命令行，输出 JSON/CSV 报告），链接 gamecore
+# tests:    规则库的暴力等价测试（命令行，make check 运行），链接 gamecore
+SUBDIRS += \
+    gamecore \
+    app \
+    bench \
+    playbench \
+    corpus \
+    server \
+    gameload \
+    sim \
+    tests
 
-# 包含路径
-INCLUDEPATH += $$PWD/src/model \
-               $$PWD/src/view
-
-SOURCES += \
-    main.cpp \
-    src/model/GameMap.cpp \
-    src/view/GameWidget.cpp \
-    src/view/MenuWidget.cpp \
-    src/view/RankingWidget.cpp
-
-HEADERS += \
-    src/model/Const.h \
-    src/model/Gem.h \
-    src/model/GameMap.h \
-    src/view/GameWidget.h \
-    src/view/MenuWidget.h \
-    src/view/RankingWidget.h
-
-FORMS += \
-    src/view/GameWidget.ui \
-    src/view/MenuWidget.ui \
-    src/view/RankingWidget.ui
-
-RESOURCES += \
-    resources.qrc
-
-DESTDIR = bin
+gamecore.file = src/model/gamecore.pro
+app.file = src/view/app.pro
+app.depends = gamecore
+bench.file = src/bench/bench.pro
+bench.depends = gamecore
+playbench.file = src/playbench/playbench.pro
+playbench.depends = gamecore
+corpus.file = src/corpus/corpus.pro
+corpus.depends = gamecore
+server.file = src/server/server.pro
+server.depends = gamecore
+gameload.file = src/gameload/gameload.pro
+gameload.depends = gamecore
+sim.file = src/sim/sim.pro
+sim.depends = gamecore
+tests.file = src/tests/tests.pro
+tests.depends = gamecore
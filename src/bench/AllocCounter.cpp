@@ -0,0 +1,67 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> g_count(0); ///< 分配次数
+std::atomic<uint64_t> g_bytes(0); ///< 分配字节数
+
+/**
+ * @brief 计数并分配
+ * @param size 字节数
+ * @return 内存，失败时为 nullptr
+ */
+void *countedAlloc(std::size_t size) {
+  g_count.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+/**
+ * @brief 读取累计分配实现
+ * @return 累计计数
+ */
+AllocCounts allocCounts() {
+  return AllocCounts{g_count.load(std::memory_order_relaxed),
+                     g_bytes.load(std::memory_order_relaxed)};
+}
+
+void *operator new(std::size_t size) {
+  if (void *p = countedAlloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+  if (void *p = countedAlloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete[](void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
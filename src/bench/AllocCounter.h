@@ -0,0 +1,22 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief 堆分配计数
+ * 基准程序替换了全局 operator new，统计所有线程的分配次数与字节数
+ * （提示引擎的工作线程也计入）。对齐分配（C++17 align_val_t 重载）不计数
+ */
+struct AllocCounts {
+  uint64_t count; ///< 分配次数
+  uint64_t bytes; ///< 分配字节数
+};
+
+/**
+ * @brief 读取进程启动以来的累计分配
+ * @return 累计计数
+ */
+AllocCounts allocCounts();
+
+#endif // ALLOCCOUNTER_H
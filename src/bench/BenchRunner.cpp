@@ -0,0 +1,144 @@
+#include "BenchRunner.h"
+#include "Percentile.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int TIMER_CALIBRATION_SAMPLES = 10001; ///< 测量计时开销的空计时次数
+
+/**
+ * @brief 格式化数值
+ * @param value 数值
+ * @param digits 小数位数
+ */
+std::string number(double value, int digits = 1) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.*f", digits, value);
+  return text;
+}
+
+/**
+ * @brief 转义 JSON 字符串
+ */
+std::string quoted(const std::string &text) {
+  std::string out = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      out += '\\';
+    }
+    out += ch;
+  }
+  return out + "\"";
+}
+
+} // namespace
+
+/**
+ * @brief BenchRunner构造函数实现
+ * @param repeats 统计轮数
+ */
+BenchRunner::BenchRunner(int repeats)
+    : m_repeats(std::max(repeats, 1)), m_timerOverhead(0) {
+  std::vector<double> empty;
+  empty.reserve(TIMER_CALIBRATION_SAMPLES);
+  for (int i = 0; i < TIMER_CALIBRATION_SAMPLES; i++) {
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point end = Clock::now();
+    empty.push_back(
+        std::chrono::duration<double, std::nano>(end - start).count());
+  }
+  std::sort(empty.begin(), empty.end());
+  m_timerOverhead = empty[empty.size() / 2];
+}
+
+/**
+ * @brief 设置名称过滤实现
+ * @param filter 子串
+ */
+void BenchRunner::setFilter(const std::string &filter) { m_filter = filter; }
+
+/**
+ * @brief 判断基准是否需要执行实现
+ * @param name 基准名称
+ * @param corpus 语料名称
+ * @return true 表示需要执行
+ */
+bool BenchRunner::enabled(const std::string &name,
+                          const std::string &corpus) const {
+  return m_filter.empty() ||
+         (name + "/" + corpus).find(m_filter) != std::string::npos;
+}
+
+/**
+ * @brief 输出结果表格实现
+ * @param out 输出流
+ */
+void BenchRunner::writeTable(std::ostream &out) const {
+  char line[160];
+  std::snprintf(line, sizeof(line), "%-16s %-14s %8s %12s %9s %10s %10s %10s\n",
+                "benchmark", "corpus", "ops", "ns/op", "allocs/op", "p50",
+                "p90", "p99");
+  out << line;
+  for (const BenchResult &r : m_results) {
+    std::snprintf(line, sizeof(line),
+                  "%-16s %-14s %8d %12.1f %9.2f %10.1f %10.1f %10.1f\n",
+                  r.name.c_str(), r.corpus.c_str(), r.ops, r.nsPerOp,
+                  r.allocsPerOp, r.p50, r.p90, r.p99);
+    out << line;
+  }
+}
+
+/**
+ * @brief 输出 JSON 结果数组实现
+ * @param out 输出流
+ * @param indent 缩进
+ */
+void BenchRunner::writeJsonResults(std::ostream &out,
+                                   const std::string &indent) const {
+  out << "[";
+  for (size_t i = 0; i < m_results.size(); i++) {
+    const BenchResult &r = m_results[i];
+    out << (i ? "," : "") << "\n"
+        << indent << "  {\"name\": " << quoted(r.name)
+        << ", \"corpus\": " << quoted(r.corpus) << ", \"ops\": " << r.ops
+        << ", \"nsPerOp\": " << number(r.nsPerOp)
+        << ", \"allocsPerOp\": " << number(r.allocsPerOp, 3)
+        << ", \"bytesPerOp\": " << number(r.bytesPerOp)
+        << ", \"p50Ns\": " << number(r.p50) << ", \"p90Ns\": " << number(r.p90)
+        << ", \"p99Ns\": " << number(r.p99) << ", \"maxNs\": " << number(r.max)
+        << "}";
+  }
+  out << "\n" << indent << "]";
+}
+
+/**
+ * @brief 汇总样本实现
+ * @param name 基准名称
+ * @param corpus 语料名称
+ * @param samples 逐次延迟
+ * @param allocs 分配合计
+ */
+void BenchRunner::record(const std::string &name, const std::string &corpus,
+                         std::vector<double> &samples,
+                         const AllocCounts &allocs) {
+  double total = 0;
+  for (double &sample : samples) {
+    sample = std::max(sample - m_timerOverhead, 0.0);
+    total += sample;
+  }
+  std::sort(samples.begin(), samples.end());
+
+  BenchResult result;
+  result.name = name;
+  result.corpus = corpus;
+  result.ops = static_cast<int>(samples.size());
+  result.nsPerOp = total / samples.size();
+  result.allocsPerOp = double(allocs.count) / samples.size();
+  result.bytesPerOp = double(allocs.bytes) / samples.size();
+  result.p50 = nearestRank(samples, 0.50);
+  result.p90 = nearestRank(samples, 0.90);
+  result.p99 = nearestRank(samples, 0.99);
+  result.max = samples.back();
+  m_results.push_back(result);
+}
@@ -0,0 +1,139 @@
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include "AllocCounter.h"
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一项基准的统计结果
+ * 延迟均已扣除计时本身的开销
+ */
+struct BenchResult {
+  std::string name;   ///< 基准名称
+  std::string corpus; ///< 语料名称
+  int ops;            ///< 计时的操作次数（含重复轮次）
+  double nsPerOp;     ///< 平均耗时（纳秒）
+  double allocsPerOp; ///< 平均堆分配次数
+  double bytesPerOp;  ///< 平均堆分配字节数
+  double p50;         ///< 延迟中位数（纳秒）
+  double p90;         ///< 90 分位延迟（纳秒）
+  double p99;         ///< 99 分位延迟（纳秒）
+  double max;         ///< 最大延迟（纳秒）
+};
+
+/**
+ * @brief 基准执行器
+ * 每次操作前调用 setup 准备状态（不计时），再单独计时 body，
+ * 逐次记录延迟与分配数。先完整预热一轮，再重复若干轮统计
+ */
+class BenchRunner {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief 构造函数
+   * 测量计时开销
+   * @param repeats 统计轮数（至少为 1）
+   */
+  explicit BenchRunner(int repeats);
+
+  /**
+   * @brief 设置名称过滤
+   * @param filter 子串，基准名称或“名称/语料”包含它才执行；空串表示全部执行
+   */
+  void setFilter(const std::string &filter);
+
+  /**
+   * @brief 判断基准是否需要执行
+   * @param name 基准名称
+   * @param corpus 语料名称
+   * @return true 表示需要执行
+   */
+  bool enabled(const std::string &name, const std::string &corpus) const;
+
+  /**
+   * @brief 执行一项基准
+   * @param name 基准名称
+   * @param corpus 语料名称
+   * @param ops 每轮的操作次数，第 i 次操作调用 setup(i) 与 body(i)
+   * @param setup 准备函数（不计时）
+   * @param body 被测操作
+   */
+  template <class Setup, class Body>
+  void run(const std::string &name, const std::string &corpus, int ops,
+           Setup setup, Body body) {
+    if (!enabled(name, corpus) || ops <= 0) {
+      return;
+    }
+    for (int i = 0; i < ops; i++) {
+      setup(i);
+      body(i);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(ops) * m_repeats);
+    AllocCounts allocs = {0, 0};
+    for (int rep = 0; rep < m_repeats; rep++) {
+      for (int i = 0; i < ops; i++) {
+        setup(i);
+        const AllocCounts before = allocCounts();
+        const Clock::time_point start = Clock::now();
+        body(i);
+        const Clock::time_point end = Clock::now();
+        const AllocCounts after = allocCounts();
+        samples.push_back(
+            std::chrono::duration<double, std::nano>(end - start).count());
+        allocs.count += after.count - before.count;
+        allocs.bytes += after.bytes - before.bytes;
+      }
+    }
+    record(name, corpus, samples, allocs);
+  }
+
+  /**
+   * @brief 获取全部结果
+   * @return 按执行顺序排列的结果
+   */
+  const std::vector<BenchResult> &results() const { return m_results; }
+
+  /**
+   * @brief 获取计时开销
+   * @return 一次空计时的中位耗时（纳秒）
+   */
+  double timerOverhead() const { return m_timerOverhead; }
+
+  /**
+   * @brief 输出结果表格
+   * @param out 输出流
+   */
+  void writeTable(std::ostream &out) const;
+
+  /**
+   * @brief 输出 JSON 报告的 results 数组
+   * @param out 输出流
+   * @param indent 每行前的缩进
+   */
+  void writeJsonResults(std::ostream &out, const std::string &indent) const;
+
+private:
+  /**
+   * @brief 汇总一项基准的样本
+   * @param name 基准名称
+   * @param corpus 语料名称
+   * @param samples 逐次延迟（纳秒，未扣除计时开销）
+   * @param allocs 计时区间内的分配合计
+   */
+  void record(const std::string &name, const std::string &corpus,
+              std::vector<double> &samples, const AllocCounts &allocs);
+
+  int m_repeats;                      ///< 统计轮数
+  double m_timerOverhead;             ///< 计时开销（纳秒）
+  std::string m_filter;               ///< 名称过滤
+  std::vector<BenchResult> m_results; ///< 结果
+};
+
+#endif // BENCHRUNNER_H
@@ -0,0 +1,168 @@
+#include "BoardCorpus.h"
+
+namespace {
+
+const int SPARSE_CLEAR_PERCENT = 35; ///< 稀疏语料清空的格子比例
+const int NEAR_DEADLOCK_MOVES = 3;   ///< 近死局语料允许的最多合法交换数
+const int CASCADE_MIN_ROUNDS = 3;    ///< 连锁语料要求的最少消除轮数
+
+} // namespace
+
+/**
+ * @brief BoardCorpus构造函数实现
+ * 语料随机流只决定每次尝试的地图种子与棋盘改写，
+ * 不满足条件的尝试直接丢弃，生成结果只由参数决定
+ * @param kind 语料类型
+ * @param size 棋盘数
+ * @param seed 随机种子
+ */
+BoardCorpus::BoardCorpus(CorpusKind kind, int size, uint64_t seed)
+    : m_kind(kind) {
+  Random rng(seed ^ (uint64_t(kind) << 56));
+  GameMap map(0);
+  m_boards.reserve(size);
+  while (static_cast<int>(m_boards.size()) < size) {
+    Entry entry;
+    entry.seed = rng.next();
+    entry.hasMove = false;
+    map.setSeed(entry.seed);
+    if (generate(map, rng, entry)) {
+      m_boards.push_back(entry);
+    }
+  }
+}
+
+/**
+ * @brief 装入棋盘实现
+ * @param map 地图
+ * @param i 棋盘下标
+ */
+void BoardCorpus::load(GameMap &map, int i) const {
+  map.setSeed(m_boards[i].seed);
+  map.loadSnapshot(m_boards[i].board);
+}
+
+/**
+ * @brief 获取记录的交换实现
+ * @param i 棋盘下标
+ * @param move 输出交换
+ * @return false 表示没有记录交换
+ */
+bool BoardCorpus::move(int i, Move &move) const {
+  move = m_boards[i].move;
+  return m_boards[i].hasMove;
+}
+
+/**
+ * @brief 稳定性判断实现
+ * @return true 表示稳定
+ */
+bool BoardCorpus::stable() const {
+  return m_kind == CORPUS_NEAR_DEADLOCK || m_kind == CORPUS_CASCADE_HEAVY;
+}
+
+/**
+ * @brief 获取语料名称实现
+ * @param kind 语料类型
+ * @return 名称
+ */
+const char *BoardCorpus::kindName(CorpusKind kind) {
+  switch (kind) {
+  case CORPUS_SPARSE:
+    return "sparse";
+  case CORPUS_DENSE:
+    return "dense";
+  case CORPUS_NEAR_DEADLOCK:
+    return "near-deadlock";
+  case CORPUS_CASCADE_HEAVY:
+    return "cascade-heavy";
+  default:
+    return "unknown";
+  }
+}
+
+/**
+ * @brief 生成棋盘实现
+ * @param map 工作地图
+ * @param rng 语料随机流
+ * @param entry 输出条目
+ * @return false 表示需要重试
+ */
+bool BoardCorpus::generate(GameMap &map, Random &rng, Entry &entry) const {
+  map.init();
+  switch (m_kind) {
+  case CORPUS_SPARSE: {
+    GameMap::Mask holes = GameMap::Mask();
+    for (int i = 0; i < ROW * COL; i++) {
+      if (rng.bounded(100) < SPARSE_CLEAR_PERCENT) {
+        holes |= maskBit<GameMap::Mask>(i);
+      }
+    }
+    map.eliminate(holes);
+    break;
+  }
+  case CORPUS_DENSE:
+    // 逐格与随机格子交换，得到现有宝石的均匀随机排列
+    for (int i = ROW * COL - 1; i > 0; i--) {
+      const int j = static_cast<int>(rng.bounded(i + 1));
+      map.swap(i / COL, i % COL, j / COL, j % COL);
+    }
+    if (!map.matchMask()) {
+      return false;
+    }
+    break;
+  case CORPUS_NEAR_DEADLOCK: {
+    GameMap::MoveList moves;
+    if (map.findMoves(moves) > NEAR_DEADLOCK_MOVES) {
+      return false;
+    }
+    entry.move = moves[0];
+    entry.hasMove = true;
+    break;
+  }
+  case CORPUS_CASCADE_HEAVY: {
+    GameMap::Snapshot start;
+    map.saveSnapshot(start);
+    GameMap::MoveList moves;
+    map.findMoves(moves);
+    for (const Move &move : moves) {
+      map.setSeed(entry.seed);
+      map.loadSnapshot(start);
+      if (cascadeRounds(map, move) >= CASCADE_MIN_ROUNDS) {
+        entry.move = move;
+        entry.hasMove = true;
+        break;
+      }
+    }
+    map.loadSnapshot(start);
+    if (!entry.hasMove) {
+      return false;
+    }
+    break;
+  }
+  default:
+    return false;
+  }
+  map.saveSnapshot(entry.board);
+  return true;
+}
+
+/**
+ * @brief 结算交换实现
+ * @param map 地图
+ * @param move 交换
+ * @return 消除轮数
+ */
+int BoardCorpus::cascadeRounds(GameMap &map, const Move &move) {
+  map.swap(move.r1, move.c1, move.r2, move.c2);
+  int rounds = 0;
+  for (;;) {
+    const GameMap::Mask mask = map.checkMatchMask();
+    if (!mask) {
+      return rounds;
+    }
+    map.eliminate(mask);
+    map.applyGravity();
+    rounds++;
+  }
+}
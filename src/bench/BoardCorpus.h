@@ -0,0 +1,103 @@
+#ifndef BOARDCORPUS_H
+#define BOARDCORPUS_H
+
+#include "GameMap.h"
+#include <vector>
+
+/**
+ * @brief 基准语料类型
+ */
+enum CorpusKind {
+  CORPUS_SPARSE,        ///< 稳定棋盘上约三分之一的格子被清空，等待下落填充
+  CORPUS_DENSE,         ///< 颜色随机排列，布满现成的三连
+  CORPUS_NEAR_DEADLOCK, ///< 稳定棋盘，只剩 1 ~ 3 个合法交换
+  CORPUS_CASCADE_HEAVY, ///< 稳定棋盘，记录的交换在对应种子下至少连锁三轮
+  CORPUS_KIND_COUNT     ///< 语料类型数
+};
+
+/**
+ * @brief 固定种子的棋盘语料
+ * 相同的类型、数量与种子总是生成相同的棋盘，不同版本的规则库之间可直接对比。
+ * 每个棋盘附带一个补充种子：基准在每次操作前用它重设地图的随机流，
+ * 下落补充与连锁过程也完全可复现
+ */
+class BoardCorpus {
+public:
+  typedef GameMap::Snapshot Snapshot;
+
+  /**
+   * @brief 构造函数
+   * @param kind 语料类型
+   * @param size 棋盘数
+   * @param seed 随机种子
+   */
+  BoardCorpus(CorpusKind kind, int size, uint64_t seed);
+
+  // 获取语料类型
+  CorpusKind kind() const { return m_kind; }
+
+  // 获取棋盘数
+  int size() const { return static_cast<int>(m_boards.size()); }
+
+  // 获取第 i 个棋盘的快照
+  const Snapshot &board(int i) const { return m_boards[i].board; }
+
+  /**
+   * @brief 把第 i 个棋盘装入地图
+   * 重设地图种子并恢复快照；有打开的撤销步骤时改动照常登记
+   * @param map 地图
+   * @param i 棋盘下标
+   */
+  void load(GameMap &map, int i) const;
+
+  /**
+   * @brief 获取第 i 个棋盘记录的交换
+   * @param i 棋盘下标
+   * @param move 输出交换
+   * @return false 表示该棋盘没有记录交换（稀疏、密集语料）
+   */
+  bool move(int i, Move &move) const;
+
+  /**
+   * @brief 棋盘是否稳定（无空格、无现成匹配）
+   * @return true 表示稳定
+   */
+  bool stable() const;
+
+  /**
+   * @brief 获取语料名称
+   * @param kind 语料类型
+   * @return 名称（"sparse" / "dense" / "near-deadlock" / "cascade-heavy"）
+   */
+  static const char *kindName(CorpusKind kind);
+
+private:
+  /**
+   * @brief 语料中的一个棋盘
+   */
+  struct Entry {
+    Snapshot board; ///< 棋盘快照
+    uint64_t seed;  ///< 补充种子
+    Move move;      ///< 记录的交换
+    bool hasMove;   ///< 是否记录了交换
+  };
+
+  /**
+   * @brief 按类型生成一个棋盘
+   * @param map 工作地图（已设定种子）
+   * @param rng 语料随机流
+   * @param entry 输出条目
+   * @return false 表示不满足该类型的条件，需换种子重试
+   */
+  bool generate(GameMap &map, Random &rng, Entry &entry) const;
+
+  /**
+   * @brief 执行交换并结算到稳定，返回消除轮数
+   */
+  static int cascadeRounds(GameMap &map, const Move &move);
+
+  CorpusKind m_kind;           ///< 语料类型
+  std::vector<Entry> m_boards; ///< 棋盘
+};
+
+#endif // BOARDCORPUS_H
@@ -0,0 +1,22 @@
+TEMPLATE = app
+TARGET = gamebench
+
+# 规则库微基准：命令行程序，不链接任何 Qt 模块
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+SOURCES += \
+    AllocCounter.cpp \
+    BenchRunner.cpp \
+    BoardCorpus.cpp \
+    main.cpp
+
+HEADERS += \
+    AllocCounter.h \
+    BenchRunner.h \
+    BoardCorpus.h
+
+DESTDIR = $$top_builddir/bin
@@ -0,0 +1,514 @@
+// gamebench: 规则库内核的微基准。
+// 在固定种子的棋盘语料上逐次计时 GameMap 的各个内核、局面缓存、批量评估与提示搜索，
+// 输出 ns/op、分配次数/op 与分位延迟的 JSON 报告，用于对比优化前后的规则库；
+// 另做一次多线程共享局面缓存的冒烟检查，缓存结果与直接计算不一致时返回非零
+
+#include "BenchRunner.h"
+#include "BoardBatch.h"
+#include "BoardCorpus.h"
+#include "DynamicGameMap.h"
+#include "HintEngine.h"
+#include "PositionCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_BOARDS = 256;           ///< 默认每种语料的棋盘数
+const int DEFAULT_REPEATS = 5;            ///< 默认统计轮数
+const int DEFAULT_HINT_BOARDS = 16;       ///< 默认提示搜索使用的棋盘数
+const int HINT_BUDGET_MS = 60000;         ///< 提示搜索的时间预算，足够完成全部采样
+const uint64_t DEFAULT_SEED = 20240;      ///< 默认语料种子
+const size_t MISS_CACHE_BYTES = 64 << 10; ///< 未命中基准的缓存大小（每次清空）
+const size_t SMOKE_CACHE_BYTES = 4 << 10; ///< 冒烟检查的缓存大小（槽位争用激烈）
+const int SMOKE_LOOKUPS = 200000;         ///< 冒烟检查每个线程的查询次数
+const int BATCH_BLOCK = 64;               ///< 批量评估基准每次操作的棋盘数
+
+// 大棋盘基准的边长；每轮操作次数按边长缩减，格子总数约为 --boards 个 64x64 棋盘
+const int DYNAMIC_SIZES[] = {64, 512, 4096};
+
+volatile uint64_t g_sink = 0; ///< 吸收查询结果，防止被测调用被优化掉
+
+/**
+ * @brief 命令行选项
+ */
+struct Options {
+  uint64_t seed;      ///< 语料种子
+  int boards;         ///< 每种语料的棋盘数
+  int repeats;        ///< 统计轮数
+  int hintBoards;     ///< 提示搜索使用的棋盘数
+  std::string filter; ///< 名称过滤
+  std::string out;    ///< JSON 输出文件，空表示标准输出
+  bool quiet;         ///< 不输出表格
+};
+
+/**
+ * @brief 多线程局面缓存冒烟检查的结果
+ */
+struct SmokeResult {
+  bool ran;            ///< 是否执行（被名称过滤排除时为 false）
+  int threads;         ///< 线程数
+  uint64_t lookups;    ///< 查询总数
+  uint64_t hits;       ///< 命中数
+  uint64_t mismatches; ///< 与 GameMap::findMoves() 不一致的次数
+};
+
+void usage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s [--seed N] [--boards N] [--repeats N] "
+               "[--hint-boards N] [--filter TEXT] [--out FILE] [--quiet]\n",
+               program);
+}
+
+/**
+ * @brief 解析命令行
+ * @return false 表示参数有误
+ */
+bool parseOptions(int argc, char *argv[], Options &options) {
+  options.seed = DEFAULT_SEED;
+  options.boards = DEFAULT_BOARDS;
+  options.repeats = DEFAULT_REPEATS;
+  options.hintBoards = DEFAULT_HINT_BOARDS;
+  options.quiet = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--quiet") {
+      options.quiet = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++i];
+    if (arg == "--seed") {
+      options.seed = std::strtoull(value, nullptr, 0);
+    } else if (arg == "--boards") {
+      options.boards = std::atoi(value);
+    } else if (arg == "--repeats") {
+      options.repeats = std::atoi(value);
+    } else if (arg == "--hint-boards") {
+      options.hintBoards = std::atoi(value);
+    } else if (arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "--out") {
+      options.out = value;
+    } else {
+      return false;
+    }
+  }
+  return options.boards > 0 && options.repeats > 0 && options.hintBoards >= 0;
+}
+
+/**
+ * @brief 装入棋盘，并执行语料记录的交换
+ * 稳定语料由此得到一块现成的匹配
+ */
+void loadAndSwap(GameMap &map, const BoardCorpus &corpus, int i) {
+  corpus.load(map, i);
+  Move move;
+  if (corpus.move(i, move)) {
+    map.swap(move.r1, move.c1, move.r2, move.c2);
+  }
+}
+
+/**
+ * @brief 结算到稳定：下落、匹配、消除，直到没有匹配
+ */
+void settle(GameMap &map) {
+  for (;;) {
+    map.applyGravity();
+    const GameMap::Mask mask = map.checkMatchMask();
+    if (!mask) {
+      return;
+    }
+    map.eliminate(mask);
+  }
+}
+
+/**
+ * @brief 生成左右镜像的局面
+ * @param map 地图
+ * @param mirror 输出镜像局面
+ */
+void mirrorBoard(const GameMap &map, GameMap &mirror) {
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      mirror.setGemType(r, c, map.getGemType(r, COL - 1 - c));
+    }
+  }
+}
+
+/**
+ * @brief 局面缓存基准
+ * 未命中：每次操作前清空一个小缓存；命中：先写入全部棋盘再查询原局面；
+ * 镜像命中：写入原局面后查询其左右镜像，走规范化与交换翻转路径
+ * @param corpus 稳定语料
+ */
+void runCache(BenchRunner &runner, const BoardCorpus &corpus) {
+  const char *name = BoardCorpus::kindName(corpus.kind());
+  const int n = corpus.size();
+  GameMap map(0);
+  GameMap::MoveList moves;
+
+  std::vector<GameMap::Snapshot> mirrored(n);
+  GameMap mirror(0);
+  for (int i = 0; i < n; i++) {
+    corpus.load(map, i);
+    mirrorBoard(map, mirror);
+    mirror.saveSnapshot(mirrored[i]);
+  }
+
+  PositionCache small(MISS_CACHE_BYTES);
+  runner.run(
+      "cacheMovesMiss", name, n,
+      [&](int i) {
+        small.clear();
+        corpus.load(map, i);
+      },
+      [&](int) { g_sink += small.findMoves(map, moves); });
+  runner.run(
+      "cacheDeadMiss", name, n,
+      [&](int i) {
+        small.clear();
+        corpus.load(map, i);
+      },
+      [&](int) { g_sink += small.hasAnyMove(map); });
+
+  PositionCache cache;
+  for (int i = 0; i < n; i++) {
+    corpus.load(map, i);
+    cache.findMoves(map, moves);
+  }
+  runner.run(
+      "cacheMovesHit", name, n, [&](int i) { corpus.load(map, i); },
+      [&](int) { g_sink += cache.findMoves(map, moves); });
+  runner.run(
+      "cacheDeadHit", name, n, [&](int i) { corpus.load(map, i); },
+      [&](int) { g_sink += cache.hasAnyMove(map); });
+  runner.run(
+      "cacheMovesMirror", name, n,
+      [&](int i) { map.loadSnapshot(mirrored[i]); },
+      [&](int) { g_sink += cache.findMoves(map, moves); });
+}
+
+/**
+ * @brief 批量评估基准
+ * 每次操作评估从第 i 个棋盘起的 BATCH_BLOCK 个棋盘（越过末尾时回绕），
+ * 按当前 CPU 支持的各指令集分别计时；batch-gamemap 对同一批棋盘逐个调用
+ * GameMap 的 matchMask()、findMoves() 与 maskScore()，作为对照
+ * @param corpus 语料
+ */
+void runBatch(BenchRunner &runner, const BoardCorpus &corpus) {
+  const char *name = BoardCorpus::kindName(corpus.kind());
+  const int n = corpus.size();
+  GameMap map(0);
+  std::vector<PackedBoard> packed(n + BATCH_BLOCK);
+  for (int i = 0; i < n + BATCH_BLOCK; i++) {
+    corpus.load(map, i % n);
+    packed[i] = BoardBatch::pack(map);
+  }
+  BoardEval results[BATCH_BLOCK];
+
+  for (int k = BATCH_SCALAR; k <= BoardBatch::bestIsa(); k++) {
+    const BatchIsa isa = static_cast<BatchIsa>(k);
+    runner.run(
+        std::string("batch-") + BoardBatch::isaName(isa), name, n,
+        [&](int) {},
+        [&](int i) {
+          BoardBatch::evaluate(&packed[i], BATCH_BLOCK, results, isa);
+          g_sink += results[0].moves;
+        });
+  }
+
+  GameMap::MoveList moves;
+  runner.run(
+      "batch-gamemap", name, n, [&](int) {},
+      [&](int i) {
+        for (int b = 0; b < BATCH_BLOCK; b++) {
+          map.loadSnapshot(corpus.board((i + b) % n));
+          g_sink += map.maskScore(map.matchMask()) + map.findMoves(moves);
+        }
+      });
+}
+
+/**
+ * @brief 大棋盘基准
+ * 每种边长各准备一张开局、一张随机交换出大量匹配的棋盘和一张消除后待下落的棋盘，
+ * 分别计时开局、匹配标记、下落填充与死局检测
+ */
+void runDynamic(BenchRunner &runner, const Options &options) {
+  Random rng(options.seed);
+  for (int size : DYNAMIC_SIZES) {
+    const std::string name = std::to_string(size) + "x" + std::to_string(size);
+    const int n = std::max(1, options.boards / (size / 64) / (size / 64));
+    DynamicGameMap map(size, size, GEM_KIND, options.seed);
+    runner.run(
+        "dynamicInit", name, n, [&](int) {}, [&](int) { map.init(); });
+
+    map.init();
+    DynamicGameMap swapped = map;
+    for (int k = size * size / 8; k > 0; k--) {
+      const int r = rng.bounded(size - 1);
+      const int c = rng.bounded(size - 1);
+      swapped.swap(r, c, r + (k & 1), c + 1 - (k & 1));
+    }
+    DynamicGameMap holes = swapped;
+    holes.findMatches();
+    holes.eliminateMatched();
+
+    runner.run(
+        "dynamicFindMatches", name, n, [&](int) {},
+        [&](int) { g_sink += swapped.findMatches(); });
+    runner.run(
+        "dynamicGravity", name, n, [&](int) { map = holes; },
+        [&](int) { map.applyGravity(); });
+    // 开局几乎总有合法交换，计时的是找到第一个合法交换的耗时
+    runner.run(
+        "dynamicHasMove", name, n, [&](int) { map.init(); },
+        [&](int) { g_sink += map.hasPossibleMove(); });
+  }
+}
+
+/**
+ * @brief 多线程共享局面缓存的冒烟检查
+ * 各线程在同一个很小的缓存上交替查询原局面与镜像局面，槽位被不断并发改写；
+ * 每次结果都与直接计算比较，校验字一旦失效就会读到别的局面的交换
+ * @param corpus 稳定语料
+ * @return 检查结果
+ */
+SmokeResult runCacheSmoke(const BoardCorpus &corpus) {
+  const int n = corpus.size();
+  std::vector<GameMap::Snapshot> boards(2 * n);
+  std::vector<GameMap::MoveList> expected(2 * n);
+  GameMap map(0);
+  GameMap mirror(0);
+  for (int i = 0; i < n; i++) {
+    corpus.load(map, i);
+    mirrorBoard(map, mirror);
+    map.saveSnapshot(boards[2 * i]);
+    mirror.saveSnapshot(boards[2 * i + 1]);
+    map.findMoves(expected[2 * i]);
+    mirror.findMoves(expected[2 * i + 1]);
+  }
+
+  SmokeResult result = {true, 0, 0, 0, 0};
+  result.threads =
+      std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  PositionCache cache(SMOKE_CACHE_BYTES);
+  std::atomic<uint64_t> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < result.threads; t++) {
+    threads.emplace_back([&, t]() {
+      GameMap local(0);
+      GameMap::MoveList moves;
+      uint64_t bad = 0;
+      for (int k = 0; k < SMOKE_LOOKUPS; k++) {
+        const int i = (k * 7 + t * 13) % (2 * n);
+        local.loadSnapshot(boards[i]);
+        const bool dead = !cache.hasAnyMove(local);
+        cache.findMoves(local, moves);
+        const GameMap::MoveList &want = expected[i];
+        bool same = moves.size() == want.size() && dead == want.empty();
+        for (int m = 0; same && m < moves.size(); m++) {
+          same = moves[m] == want[m];
+        }
+        bad += !same;
+      }
+      mismatches += bad;
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  result.lookups = 2ULL * SMOKE_LOOKUPS * result.threads;
+  result.hits = cache.hits();
+  result.mismatches = mismatches.load();
+  return result;
+}
+
+/**
+ * @brief 执行全部基准
+ * 初始化按种子计时；其余内核在每种适用的语料上各计时一次
+ */
+void runAll(BenchRunner &runner, const Options &options, SmokeResult &smoke) {
+  GameMap map(0);
+  runner.run(
+      "init", "seeded", options.boards,
+      [&](int i) { map.setSeed(options.seed + i); },
+      [&](int) { map.init(); });
+
+  std::vector<std::unique_ptr<BoardCorpus>> corpora;
+  for (int k = 0; k < CORPUS_KIND_COUNT; k++) {
+    corpora.emplace_back(new BoardCorpus(static_cast<CorpusKind>(k),
+                                         options.boards, options.seed));
+  }
+
+  GameMap::Mask mask = GameMap::Mask();
+  GameMap::CellList cells;
+  GameMap::MoveList moves;
+  for (const std::unique_ptr<BoardCorpus> &owned : corpora) {
+    const BoardCorpus &corpus = *owned;
+    const char *name = BoardCorpus::kindName(corpus.kind());
+    const int n = corpus.size();
+
+    runner.run(
+        "loadSnapshot", name, n, [&](int) {},
+        [&](int i) { map.loadSnapshot(corpus.board(i)); });
+
+    runner.run(
+        "checkMatches", name, n,
+        [&](int i) { loadAndSwap(map, corpus, i); },
+        [&](int) { g_sink += map.checkMatches().size(); });
+    runner.run(
+        "checkMatchCells", name, n,
+        [&](int i) { loadAndSwap(map, corpus, i); },
+        [&](int) { g_sink += map.checkMatches(cells); });
+    runner.run(
+        "checkMatchMask", name, n,
+        [&](int i) { loadAndSwap(map, corpus, i); },
+        [&](int) { g_sink += maskPopCount(map.checkMatchMask()); });
+
+    if (corpus.kind() != CORPUS_SPARSE) {
+      runner.run(
+          "eliminate", name, n,
+          [&](int i) {
+            loadAndSwap(map, corpus, i);
+            mask = map.matchMask();
+          },
+          [&](int) { map.eliminate(mask); });
+    }
+    runner.run(
+        "applyGravity", name, n,
+        [&](int i) {
+          loadAndSwap(map, corpus, i);
+          map.eliminate(map.matchMask());
+        },
+        [&](int) { map.applyGravity(); });
+
+    if (corpus.stable()) {
+      runner.run(
+          "hasPossibleMove", name, n,
+          [&](int i) { corpus.load(map, i); },
+          [&](int) { g_sink += map.hasPossibleMove(); });
+      runner.run(
+          "findMoves", name, n, [&](int i) { corpus.load(map, i); },
+          [&](int) { g_sink += map.findMoves(moves); });
+    }
+
+    // 撤销：准备阶段打开一步并完整结算一个回合，分别计时封存与回退。
+    // 清空历史保留环形缓冲，先封存一步使其分配在计时之外
+    map.saveCurState(0);
+    map.saveCurState(0);
+    auto playTurn = [&](int i) {
+      map.clearHistory();
+      corpus.load(map, i);
+      map.saveCurState(0);
+      loadAndSwap(map, corpus, i);
+      settle(map);
+    };
+    runner.run(
+        "saveCurState", name, n, playTurn, [&](int) { map.saveCurState(1); });
+    runner.run(
+        "undo", name, n, playTurn, [&](int) { g_sink += map.undo(); });
+
+    if (corpus.stable()) {
+      runCache(runner, corpus);
+    }
+    runBatch(runner, corpus);
+  }
+
+  // 冒烟检查用合法交换最多的稳定语料，条目内容差异最大
+  smoke = SmokeResult{false, 0, 0, 0, 0};
+  if (runner.enabled("cacheSmoke", "threads")) {
+    smoke = runCacheSmoke(*corpora[CORPUS_CASCADE_HEAVY]);
+  }
+
+  runDynamic(runner, options);
+
+  // 提示搜索：与界面相同的引擎与默认参数，时间预算足够完成全部采样
+  if (options.hintBoards > 0) {
+    HintEngine hint;
+    hint.setSeed(options.seed);
+    for (const std::unique_ptr<BoardCorpus> &owned : corpora) {
+      const BoardCorpus &corpus = *owned;
+      if (!corpus.stable()) {
+        continue;
+      }
+      runner.run(
+          "hint", BoardCorpus::kindName(corpus.kind()),
+          std::min(options.hintBoards, corpus.size()),
+          [&](int i) { corpus.load(map, i); },
+          [&](int) {
+            g_sink += hint.findBestMove(map, HINT_BUDGET_MS).samples;
+          });
+    }
+  }
+}
+
+/**
+ * @brief 输出 JSON 报告
+ */
+void writeReport(std::ostream &out, const BenchRunner &runner,
+                 const Options &options, const SmokeResult &smoke) {
+  out << "{\n"
+      << "  \"benchmark\": \"gamecore\",\n"
+      << "  \"board\": {\"rows\": " << ROW << ", \"cols\": " << COL
+      << ", \"kinds\": " << GEM_KIND << "},\n"
+      << "  \"seed\": " << options.seed << ",\n"
+      << "  \"boards\": " << options.boards << ",\n"
+      << "  \"repeats\": " << options.repeats << ",\n"
+      << "  \"hardwareThreads\": " << std::thread::hardware_concurrency()
+      << ",\n"
+      << "  \"timerOverheadNs\": " << runner.timerOverhead() << ",\n";
+  if (smoke.ran) {
+    out << "  \"cacheSmoke\": {\"threads\": " << smoke.threads
+        << ", \"lookups\": " << smoke.lookups << ", \"hits\": " << smoke.hits
+        << ", \"mismatches\": " << smoke.mismatches << "},\n";
+  }
+  out << "  \"results\": ";
+  runner.writeJsonResults(out, "  ");
+  out << "\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  BenchRunner runner(options.repeats);
+  runner.setFilter(options.filter);
+  SmokeResult smoke;
+  runAll(runner, options, smoke);
+
+  if (!options.quiet) {
+    runner.writeTable(std::cerr);
+  }
+  if (smoke.mismatches > 0) {
+    std::fprintf(stderr, "cacheSmoke: %llu mismatches in %llu lookups\n",
+                 static_cast<unsigned long long>(smoke.mismatches),
+                 static_cast<unsigned long long>(smoke.lookups));
+  }
+  const int status = smoke.mismatches > 0 ? 1 : 0;
+  if (options.out.empty()) {
+    writeReport(std::cout, runner, options, smoke);
+    return status;
+  }
+  std::ofstream file(options.out);
+  if (!file) {
+    std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+    return 1;
+  }
+  writeReport(file, runner, options, smoke);
+  return file ? status : 1;
+}
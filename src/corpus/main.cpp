@@ -0,0 +1,368 @@
+// gamecorpus: 回放语料的构建与批量分析。
+// add 把 .bjr 回放追加进列式语料文件，generate 用随机策略批量生成对局，
+// analyze 内存映射语料并多线程统计得分曲线、连锁深度分布与各格消除热力图，输出 JSON 报告
+
+#include "ReplayCorpus.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const int DEFAULT_GAMES = 10000;   ///< generate 默认对局数
+const int DEFAULT_TURNS = 200;     ///< generate 默认每局事件数上限
+const uint64_t DEFAULT_SEED = 1;   ///< generate 默认首局种子
+const int MAX_CASCADE_BUCKET = 16; ///< 连锁深度分布的最后一档（含更深）
+const int UNDO_PERCENT = 3;        ///< generate 中每步撤销的概率（百分比）
+
+/**
+ * @brief 命令行选项
+ */
+struct Options {
+  std::string command;            ///< 子命令
+  std::string corpus;             ///< 语料文件
+  std::vector<std::string> paths; ///< add 的回放文件或目录
+  int games;                      ///< generate 的对局数
+  int turns;                      ///< generate 的每局事件数上限
+  uint64_t seed;                  ///< generate 的首局种子
+  int threads;                    ///< analyze 的线程数，0 表示硬件并发数
+  bool simulate;                  ///< analyze 是否重新模拟
+  std::string out;                ///< JSON 输出文件，空表示标准输出
+};
+
+void usage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s add CORPUS REPLAY|DIR...\n"
+               "       %s generate CORPUS [--games N] [--turns N] [--seed N]\n"
+               "       %s analyze CORPUS [--threads N] [--no-sim] "
+               "[--out FILE]\n",
+               program, program, program);
+}
+
+/**
+ * @brief 解析命令行
+ * @return false 表示参数有误
+ */
+bool parseOptions(int argc, char *argv[], Options &options) {
+  options.games = DEFAULT_GAMES;
+  options.turns = DEFAULT_TURNS;
+  options.seed = DEFAULT_SEED;
+  options.threads = 0;
+  options.simulate = true;
+  if (argc < 3) {
+    return false;
+  }
+  options.command = argv[1];
+  options.corpus = argv[2];
+  for (int i = 3; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (options.command == "add") {
+      options.paths.push_back(arg);
+      continue;
+    }
+    if (arg == "--no-sim") {
+      options.simulate = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const char *value = argv[++i];
+    if (arg == "--games") {
+      options.games = std::atoi(value);
+    } else if (arg == "--turns") {
+      options.turns = std::atoi(value);
+    } else if (arg == "--seed") {
+      options.seed = std::strtoull(value, nullptr, 0);
+    } else if (arg == "--threads") {
+      options.threads = std::atoi(value);
+    } else if (arg == "--out") {
+      options.out = value;
+    } else {
+      return false;
+    }
+  }
+  if (options.command == "add") {
+    return !options.paths.empty();
+  }
+  if (options.command == "generate") {
+    return options.games > 0 && options.turns > 0;
+  }
+  return options.command == "analyze" && options.threads >= 0;
+}
+
+/**
+ * @brief 打开语料以追加
+ * 上次写入中断留下的不完整块会被截掉，截掉的字节数报告到标准错误
+ * @return false 表示打开失败（已报告原因）
+ */
+bool openWriter(ReplayCorpusWriter &writer, const std::string &path) {
+  std::string error;
+  if (!writer.open(path, &error)) {
+    std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+    return false;
+  }
+  if (writer.truncatedBytes() > 0) {
+    std::fprintf(stderr, "%s: truncated %llu bytes of an incomplete block\n",
+                 path.c_str(),
+                 static_cast<unsigned long long>(writer.truncatedBytes()));
+  }
+  return true;
+}
+
+/**
+ * @brief 追加回放文件
+ * 目录按文件名顺序追加其中的 .bjr 文件；无效或与规则不符的回放跳过并报告
+ */
+int addReplays(const Options &options) {
+  ReplayCorpusWriter writer;
+  std::string error;
+  if (!openWriter(writer, options.corpus)) {
+    return 1;
+  }
+  std::vector<std::string> files;
+  for (const std::string &path : options.paths) {
+    if (!std::filesystem::is_directory(path)) {
+      files.push_back(path);
+      continue;
+    }
+    std::vector<std::string> entries;
+    for (const auto &entry : std::filesystem::directory_iterator(path)) {
+      if (entry.path().extension() == ".bjr") {
+        entries.push_back(entry.path().string());
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    files.insert(files.end(), entries.begin(), entries.end());
+  }
+  int skipped = 0;
+  Replay replay;
+  for (const std::string &file : files) {
+    if (!replay.load(file, &error) || !writer.add(replay, &error)) {
+      std::fprintf(stderr, "%s: %s\n", file.c_str(), error.c_str());
+      skipped++;
+    }
+  }
+  if (!writer.close()) {
+    std::fprintf(stderr, "cannot write %s\n", options.corpus.c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "added %llu games, skipped %d\n",
+               static_cast<unsigned long long>(writer.gamesAdded()), skipped);
+  return skipped ? 1 : 0;
+}
+
+/**
+ * @brief 批量生成对局
+ * 每局以“种子 + 局号”开局，用由种子派生的随机数从合法交换中均匀选择，偶尔撤销，
+ * 直到达到事件数上限或死局重置
+ */
+int generateGames(const Options &options) {
+  ReplayCorpusWriter writer;
+  std::string error;
+  if (!openWriter(writer, options.corpus)) {
+    return 1;
+  }
+  GameSession session(0);
+  session.map().setRefillPolicy(REFILL_PLAYABLE);
+  Replay replay;
+  for (int g = 0; g < options.games; g++) {
+    const uint64_t seed = options.seed + g;
+    Random policy(seed ^ 0x9e3779b97f4a7c15ULL);
+    session.map().setSeed(seed);
+    session.newGame();
+    replay.begin(session);
+    for (int t = 0; t < options.turns; t++) {
+      if (policy.bounded(100) < UNDO_PERCENT && session.undo()) {
+        replay.recordUndo(0, session);
+        continue;
+      }
+      GameMap::MoveList moves;
+      if (session.map().findMoves(moves) == 0) {
+        break;
+      }
+      const Move move = moves[policy.bounded(moves.size())];
+      const TurnResult result = session.playMove(move);
+      replay.recordMove(move, 0, session);
+      if (result.reshuffled) {
+        break;
+      }
+    }
+    if (!writer.add(replay, &error)) {
+      std::fprintf(stderr, "game %d: %s\n", g, error.c_str());
+      return 1;
+    }
+  }
+  if (!writer.close()) {
+    std::fprintf(stderr, "cannot write %s\n", options.corpus.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief 单个工作线程的累加器
+ * 重新模拟时也作为 CorpusSimulator 的观察者
+ */
+struct Accumulator {
+  std::vector<double> scoreSum;     ///< 各事件结算后分数之和
+  std::vector<uint64_t> scoreCount; ///< 各事件的对局数
+  std::vector<uint64_t> cascades;   ///< 各连锁深度的交换数
+  uint64_t heat[ROW][COL];          ///< 各格被消除的次数
+  uint64_t mismatches;              ///< 重新模拟与记录不符的对局数
+
+  Accumulator()
+      : cascades(MAX_CASCADE_BUCKET + 1, 0), heat(), mismatches(0) {}
+
+  void eliminated(int, GameMap::Mask matched) {
+    while (matched) {
+      const int i = maskLowestBit(matched);
+      heat[i / COL][i % COL]++;
+      matched = maskClearLowest(matched);
+    }
+  }
+
+  void eventDone(int, const GameSession &, int depth) {
+    if (depth > 0) {
+      cascades[std::min(depth, MAX_CASCADE_BUCKET)]++;
+    }
+  }
+
+  // 得分曲线只读分数列，不需要棋盘状态
+  void addScores(const CorpusGame &game) {
+    if (scoreSum.size() < static_cast<size_t>(game.turns)) {
+      scoreSum.resize(game.turns, 0);
+      scoreCount.resize(game.turns, 0);
+    }
+    for (int i = 0; i < game.turns; i++) {
+      scoreSum[i] += game.scores[i];
+      scoreCount[i]++;
+    }
+  }
+
+  void merge(const Accumulator &o) {
+    if (scoreSum.size() < o.scoreSum.size()) {
+      scoreSum.resize(o.scoreSum.size(), 0);
+      scoreCount.resize(o.scoreSum.size(), 0);
+    }
+    for (size_t i = 0; i < o.scoreSum.size(); i++) {
+      scoreSum[i] += o.scoreSum[i];
+      scoreCount[i] += o.scoreCount[i];
+    }
+    for (size_t i = 0; i < cascades.size(); i++) {
+      cascades[i] += o.cascades[i];
+    }
+    for (int r = 0; r < ROW; r++) {
+      for (int c = 0; c < COL; c++) {
+        heat[r][c] += o.heat[r][c];
+      }
+    }
+    mismatches += o.mismatches;
+  }
+};
+
+/**
+ * @brief 写出分析报告
+ */
+void writeReport(std::ostream &out, const ReplayCorpus &corpus,
+                 const Accumulator &total, const Options &options,
+                 int threads, double seconds) {
+  out << "{\n  \"benchmark\": \"corpus\",\n"
+      << "  \"games\": " << corpus.gameCount() << ",\n"
+      << "  \"events\": " << corpus.eventCount() << ",\n"
+      << "  \"blocks\": " << corpus.blockCount() << ",\n"
+      << "  \"tornBytes\": " << corpus.tornBytes() << ",\n"
+      << "  \"threads\": " << threads << ",\n"
+      << "  \"simulate\": " << (options.simulate ? "true" : "false") << ",\n"
+      << "  \"seconds\": " << seconds << ",\n"
+      << "  \"gamesPerSec\": " << corpus.gameCount() / seconds << ",\n"
+      << "  \"eventsPerSec\": " << corpus.eventCount() / seconds << ",\n"
+      << "  \"meanScoreByEvent\": [";
+  for (size_t i = 0; i < total.scoreSum.size(); i++) {
+    out << (i ? ", " : "") << total.scoreSum[i] / total.scoreCount[i];
+  }
+  out << "]";
+  if (options.simulate) {
+    out << ",\n  \"mismatches\": " << total.mismatches
+        << ",\n  \"cascadeDepth\": [";
+    for (size_t i = 1; i < total.cascades.size(); i++) {
+      out << (i > 1 ? ", " : "") << total.cascades[i];
+    }
+    out << "],\n  \"matchHeatmap\": [";
+    for (int r = 0; r < ROW; r++) {
+      out << (r ? ",\n    [" : "\n    [");
+      for (int c = 0; c < COL; c++) {
+        out << (c ? ", " : "") << total.heat[r][c];
+      }
+      out << "]";
+    }
+    out << "\n  ]";
+  }
+  out << "\n}\n";
+}
+
+/**
+ * @brief 分析语料
+ * 各工作线程零拷贝读取对局并累加到自己的累加器，最后合并；
+ * 连锁深度与热力图需要棋盘状态，才重新模拟
+ */
+int analyze(const Options &options) {
+  ReplayCorpus corpus;
+  std::string error;
+  if (!corpus.open(options.corpus, &error)) {
+    std::fprintf(stderr, "%s: %s\n", options.corpus.c_str(), error.c_str());
+    return 1;
+  }
+  ThreadPool pool(options.threads);
+  std::vector<Accumulator> accumulators(pool.size());
+  std::vector<CorpusSimulator> simulators(pool.size());
+
+  const auto start = std::chrono::steady_clock::now();
+  corpus.forEachGame(pool, [&](int worker, const CorpusGame &game) {
+    Accumulator &acc = accumulators[worker];
+    acc.addScores(game);
+    if (options.simulate && simulators[worker].run(game, acc) >= 0) {
+      acc.mismatches++;
+    }
+  });
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  Accumulator total;
+  for (const Accumulator &acc : accumulators) {
+    total.merge(acc);
+  }
+  if (options.out.empty()) {
+    writeReport(std::cout, corpus, total, options, pool.size(), seconds);
+    return 0;
+  }
+  std::ofstream file(options.out);
+  if (!file) {
+    std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+    return 1;
+  }
+  writeReport(file, corpus, total, options, pool.size(), seconds);
+  return file ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (options.command == "add") {
+    return addReplays(options);
+  }
+  if (options.command == "generate") {
+    return generateGames(options);
+  }
+  return analyze(options);
+}
@@ -0,0 +1,25 @@
+QT       += core network
+QT       -= gui
+
+TEMPLATE = app
+TARGET = gameload
+
+# gameserver 的压测客户端：输出吞吐与延迟分位的 JSON 报告
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 游戏规则库（按返回的棋盘推算合法交换）
+include(../model/gamecore.pri)
+
+# 与服务器共用协议编解码
+INCLUDEPATH += ../server
+DEPENDPATH += ../server
+
+SOURCES += \
+    ../server/Protocol.cpp \
+    main.cpp
+
+HEADERS += \
+    ../server/Protocol.h
+
+DESTDIR = $$top_builddir/bin
@@ -0,0 +1,282 @@
+// gameload: 对局服务器的压测客户端。
+// 在一个连接上同时打开大量会话，每个会话按本地推算的合法交换随机走棋，
+// 同一时刻每个会话只有一个请求在途；输出吞吐与往返延迟分位的 JSON 报告
+
+#include "GameMap.h"
+#include "Percentile.h"
+#include "Protocol.h"
+#include "Replay.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_SESSIONS = 1000;   ///< 默认会话数
+const int DEFAULT_MOVES = 100;       ///< 默认每个会话的交换数
+const int CONNECT_TIMEOUT_MS = 5000; ///< 连接超时
+
+/**
+ * @brief 压测客户端
+ * 全部逻辑在应答到达时推进：创建 -> 交换 ... 交换 -> 关闭
+ */
+class LoadClient {
+public:
+  /**
+   * @brief 客户端侧的会话状态
+   */
+  struct Session {
+    uint32_t id;   ///< 服务器分配的会话编号
+    int moves;     ///< 已完成的交换数
+    qint64 sentNs; ///< 在途请求的发送时刻
+    Random policy; ///< 选择交换的随机数
+  };
+
+  LoadClient(QIODevice *socket, int sessions, int moves, uint64_t seed)
+      : m_socket(socket), m_sessions(sessions), m_movesPerSession(moves),
+        m_seed(seed), m_closed(0), m_accepted(0), m_errors(0), m_map(0) {}
+
+  /**
+   * @brief 发出全部会话的创建请求
+   */
+  void start() {
+    m_clock.start();
+    for (int i = 0; i < static_cast<int>(m_sessions.size()); i++) {
+      Session &session = m_sessions[i];
+      session.moves = 0;
+      session.policy.setSeed(m_seed + i);
+      session.sentNs = m_clock.nsecsElapsed();
+      FrameWriter w(MSG_NEW, i);
+      w.u64(m_seed + i);
+      w.u8(1); // REFILL_PLAYABLE
+      send(w.finish());
+    }
+  }
+
+  /**
+   * @brief 处理收到的数据
+   * @return false 表示全部会话已关闭或流已损坏
+   */
+  bool receive() {
+    const QByteArray bytes = m_socket->readAll();
+    m_reader.append(bytes.constData(), static_cast<size_t>(bytes.size()));
+    std::vector<uint8_t> body;
+    while (m_reader.next(body)) {
+      handle(body);
+    }
+    return !m_reader.broken() &&
+           m_closed < static_cast<int>(m_sessions.size());
+  }
+
+  /**
+   * @brief 生成报告
+   * @param seconds 总耗时
+   * @return JSON 报告
+   */
+  QJsonObject report(double seconds) {
+    std::sort(m_latencyNs.begin(), m_latencyNs.end());
+    QJsonObject object;
+    object["benchmark"] = "server";
+    object["sessions"] = static_cast<int>(m_sessions.size());
+    object["movesPerSession"] = m_movesPerSession;
+    object["requests"] = static_cast<qint64>(m_latencyNs.size());
+    object["acceptedMoves"] = m_accepted;
+    object["errors"] = m_errors;
+    object["seconds"] = seconds;
+    object["requestsPerSec"] = m_latencyNs.size() / seconds;
+    object["latencyP50Us"] = percentileUs(0.50);
+    object["latencyP99Us"] = percentileUs(0.99);
+    object["latencyMaxUs"] = percentileUs(1.0);
+    return object;
+  }
+
+private:
+  QIODevice *m_socket;             ///< 连接
+  std::vector<Session> m_sessions; ///< 各会话，下标即创建请求的标签
+  int m_movesPerSession;           ///< 每个会话的交换数
+  uint64_t m_seed;                 ///< 首个会话的种子
+  int m_closed;                    ///< 已关闭的会话数
+  qint64 m_accepted;               ///< 被接受的交换数
+  qint64 m_errors;                 ///< 错误应答数
+  FrameReader m_reader;            ///< 分帧缓冲
+  QElapsedTimer m_clock;           ///< 计时
+  std::vector<qint64> m_latencyNs; ///< 各请求的往返延迟
+  GameMap m_map;                   ///< 按应答中的棋盘推算合法交换
+
+  void send(const std::vector<uint8_t> &frame) {
+    m_socket->write(reinterpret_cast<const char *>(frame.data()),
+                    static_cast<qint64>(frame.size()));
+  }
+
+  double percentileUs(double q) const {
+    return nearestRank(m_latencyNs, q) / 1000.0;
+  }
+
+  /**
+   * @brief 处理一条应答
+   * 标签即会话下标；棋盘应答后走下一步，走满后关闭
+   * @param body 消息体
+   */
+  void handle(const std::vector<uint8_t> &body) {
+    if (body.size() < 5) {
+      m_errors++;
+      return;
+    }
+    const uint8_t type = body[0];
+    const uint32_t tag = readLittle<uint32_t>(body.data() + 1);
+    if (tag >= m_sessions.size()) {
+      m_errors++;
+      return;
+    }
+    Session &session = m_sessions[tag];
+    m_latencyNs.push_back(m_clock.nsecsElapsed() - session.sentNs);
+    const uint8_t *p = body.data() + 5;
+    const uint8_t *board = nullptr;
+    switch (type) {
+    case MSG_CREATED:
+      session.id = readLittle<uint32_t>(p);
+      board = p + 8;
+      break;
+    case MSG_MOVED:
+      m_accepted += p[4];
+      session.moves++;
+      board = p + 25;
+      break;
+    case MSG_CLOSED:
+      m_closed++;
+      return;
+    default:
+      // 出错的会话直接计为关闭，不再继续
+      m_errors++;
+      m_closed++;
+      return;
+    }
+    if (session.moves < m_movesPerSession && nextMove(tag, board)) {
+      return;
+    }
+    FrameWriter w(MSG_CLOSE, tag);
+    w.u32(session.id);
+    session.sentNs = m_clock.nsecsElapsed();
+    send(w.finish());
+  }
+
+  /**
+   * @brief 按应答中的棋盘随机选择一个合法交换并发出
+   * @param tag 会话下标
+   * @param board 棋盘
+   * @return false 表示没有合法交换
+   */
+  bool nextMove(uint32_t tag, const uint8_t *board) {
+    Session &session = m_sessions[tag];
+    for (int r = 0; r < ROW; r++) {
+      for (int c = 0; c < COL; c++) {
+        m_map.setGemType(r, c, static_cast<GemType>(board[r * COL + c]));
+      }
+    }
+    GameMap::MoveList moves;
+    uint8_t code;
+    if (m_map.findMoves(moves) == 0 ||
+        !Replay::encodeMove(moves[session.policy.bounded(moves.size())],
+                            code)) {
+      return false;
+    }
+    FrameWriter w(MSG_MOVE, tag);
+    w.u32(session.id);
+    w.u8(code);
+    session.sentNs = m_clock.nsecsElapsed();
+    send(w.finish());
+    return true;
+  }
+};
+
+} // namespace
+
+/**
+ * @brief 程序主函数
+ */
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Load generator for gameserver");
+  parser.addHelpOption();
+  QCommandLineOption localOption("local", "Local socket name.", "name",
+                                 "bejeweled");
+  QCommandLineOption tcpOption("tcp", "Connect to this localhost port.",
+                               "port");
+  QCommandLineOption sessionsOption("sessions", "Concurrent sessions.", "n",
+                                    QString::number(DEFAULT_SESSIONS));
+  QCommandLineOption movesOption("moves", "Moves per session.", "n",
+                                 QString::number(DEFAULT_MOVES));
+  QCommandLineOption seedOption("seed", "Seed of the first session.", "seed",
+                                "1");
+  QCommandLineOption outOption("out", "Write the JSON report to a file.",
+                               "file");
+  parser.addOption(localOption);
+  parser.addOption(tcpOption);
+  parser.addOption(sessionsOption);
+  parser.addOption(movesOption);
+  parser.addOption(seedOption);
+  parser.addOption(outOption);
+  parser.process(app);
+
+  QTextStream err(stderr);
+  QLocalSocket localSocket;
+  QTcpSocket tcpSocket;
+  QIODevice *socket = nullptr;
+  if (parser.isSet(tcpOption)) {
+    tcpSocket.connectToHost(QHostAddress::LocalHost,
+                            parser.value(tcpOption).toUShort());
+    if (!tcpSocket.waitForConnected(CONNECT_TIMEOUT_MS)) {
+      err << "cannot connect: " << tcpSocket.errorString() << "\n";
+      return 1;
+    }
+    tcpSocket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket = &tcpSocket;
+  } else {
+    localSocket.connectToServer(parser.value(localOption));
+    if (!localSocket.waitForConnected(CONNECT_TIMEOUT_MS)) {
+      err << "cannot connect: " << localSocket.errorString() << "\n";
+      return 1;
+    }
+    socket = &localSocket;
+  }
+
+  LoadClient client(socket, qMax(parser.value(sessionsOption).toInt(), 1),
+                    qMax(parser.value(movesOption).toInt(), 0),
+                    parser.value(seedOption).toULongLong());
+  QElapsedTimer clock;
+  clock.start();
+  QObject::connect(socket, &QIODevice::readyRead, [&]() {
+    if (!client.receive()) {
+      app.quit();
+    }
+  });
+  // 服务器断开时提前结束，报告中未完成的会话不计入请求数
+  QObject::connect(socket, &QIODevice::readChannelFinished, &app,
+                   &QCoreApplication::quit);
+  client.start();
+  app.exec();
+  const double seconds = clock.nsecsElapsed() / 1e9;
+
+  const QByteArray json = QJsonDocument(client.report(seconds)).toJson();
+  if (!parser.isSet(outOption)) {
+    QTextStream(stdout) << json;
+    return 0;
+  }
+  QFile file(parser.value(outOption));
+  if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+    err << "cannot write " << file.fileName() << "\n";
+    return 1;
+  }
+  return 0;
+}
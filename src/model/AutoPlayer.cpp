@@ -0,0 +1,6 @@
+#include "AutoPlayerImpl.h"
+
+// 显式实例化：与 GameMap.cpp 中的地图尺寸一致
+template class BasicAutoPlayer<8, 8, GEM_KIND>;
+template class BasicAutoPlayer<9, 9, GEM_KIND>;
+template class BasicAutoPlayer<10, 10, GEM_KIND>;
@@ -0,0 +1,212 @@
+#ifndef AUTOPLAYER_H
+#define AUTOPLAYER_H
+
+#include "GameSession.h"
+#include "SearchJob.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 自动对局单步决策结果
+ */
+struct AutoPlayResult {
+  bool found;           ///< 是否找到合法交换
+  Move move;            ///< 选定的交换
+  double expectedScore; ///< 选定交换在搜索视野内的平均得分
+  int iterations;       ///< 完成的搜索迭代次数（所有线程合计）
+  int nodes;            ///< 展开的树节点数（所有线程合计）
+  bool timedOut;        ///< 是否因时间预算耗尽而停止
+};
+
+/**
+ * @brief 无界面连续对局的统计
+ */
+struct AutoPlayStats {
+  int turns;            ///< 完成的回合数
+  int points;           ///< 获得的分数
+  int cascades;         ///< 消除轮数合计
+  int gemsCleared;      ///< 消除的宝石总数
+  int reshuffles;       ///< 死局重置次数
+  long long iterations; ///< 搜索迭代次数合计
+};
+
+/**
+ * @brief 蒙特卡洛树搜索自动对局器
+ * 每次迭代从根局面出发，沿树按 UCB1 选择交换并结算连锁，到达新节点后
+ * 用随机或贪心策略继续走子直到视野上限，以视野内的总得分回传。
+ * 补充宝石是随机的，树节点只按交换序列区分（开环搜索），
+ * 每次迭代重新抽样补充结果，节点统计即为期望得分。
+ * 每个工作线程独立建树（根并行），结束时按根交换合并访问次数；
+ * 截止时间在两次迭代之间检查，是硬性的单步时间预算。
+ * 不依赖 Qt，界面通过 chooseMoveAsync() 在后台线程决策，
+ * 模拟程序用 play() 直接驱动 GameSession
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
+ */
+template <int Rows, int Cols, int Kinds> class BasicAutoPlayer {
+public:
+  typedef BasicGameMap<Rows, Cols, Kinds> MapType;         ///< 对应尺寸的地图
+  typedef BasicGameSession<Rows, Cols, Kinds> SessionType; ///< 对应尺寸的会话
+  typedef std::function<void(const AutoPlayResult &)> Callback; ///< 异步回调
+
+  static const int DEFAULT_HORIZON = 4;          ///< 默认搜索视野（步数）
+  static const int MAX_HORIZON = 16;             ///< 视野上限
+  static const int MAX_NODES_PER_TREE = 1 << 16; ///< 单棵树的节点上限
+
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数（即并行的树数），0 表示使用硬件并发数
+   */
+  explicit BasicAutoPlayer(int threads = 0);
+
+  BasicAutoPlayer(const BasicAutoPlayer &) = delete;
+  BasicAutoPlayer &operator=(const BasicAutoPlayer &) = delete;
+
+  /**
+   * @brief 设置搜索视野
+   * @param moves 每次迭代（树内 + 模拟）最多走的步数，范围 [1, MAX_HORIZON]
+   */
+  void setHorizon(int moves);
+
+  /**
+   * @brief 设置模拟走子策略
+   * @param policy 随机或贪心
+   */
+  void setRolloutPolicy(RolloutPolicy policy);
+
+  /**
+   * @brief 设置 UCB1 探索系数
+   * @param c 系数（得分已按树内最大值归一化到 [0, 1]）
+   */
+  void setExploration(double c);
+
+  /**
+   * @brief 设置每棵树的迭代上限
+   * 设置后只要预算内能跑完，结果只由种子决定，与线程调度无关
+   * @param iterations 上限，0 表示只受时间预算限制
+   */
+  void setIterationLimit(int iterations);
+
+  /**
+   * @brief 设置随机种子
+   * @param seed 随机种子
+   */
+  void setSeed(uint64_t seed);
+
+  /**
+   * @brief 同步选择下一步
+   * @param map 当前地图（只在调用期间读取）
+   * @param timeBudgetMs 时间预算（毫秒）
+   * @return 决策结果
+   */
+  AutoPlayResult chooseMove(const MapType &map, int timeBudgetMs);
+
+  /**
+   * @brief 异步选择下一步
+   * 在调用线程中复制局面后立即返回，决策完成时在后台线程调用 done；
+   * 上一次异步决策尚未结束时将其作废（尽快停止，不再回调），调用方不等待
+   * @param map 当前地图
+   * @param timeBudgetMs 时间预算（毫秒）
+   * @param done 完成回调（在后台线程执行）
+   */
+  void chooseMoveAsync(const MapType &map, int timeBudgetMs, Callback done);
+
+  /**
+   * @brief 无界面连续对局
+   * 每回合先结算会话中未完成的回合，再决策并执行一个完整回合
+   * @param session 游戏会话
+   * @param turns 回合数
+   * @param timeBudgetMs 每步时间预算（毫秒）
+   * @return 对局统计
+   */
+  AutoPlayStats play(SessionType &session, int turns, int timeBudgetMs);
+
+private:
+  typedef typename MapType::MoveList MoveList;
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief 一次决策的输入
+   * 全部按值保存，可安全地交给其他线程
+   */
+  struct Job : BasicSearchJob<MapType> {
+    int horizon;           ///< 搜索视野
+    RolloutPolicy rollout; ///< 模拟走子策略
+    double exploration;    ///< 探索系数
+    int iterationLimit;    ///< 每棵树的迭代上限
+  };
+
+  /**
+   * @brief 树节点
+   * 子节点以单链表串联，节点存放在每棵树自己的数组中
+   */
+  struct Node {
+    Move move;       ///< 到达本节点的交换
+    int firstChild;  ///< 第一个子节点，-1 表示没有
+    int nextSibling; ///< 下一个兄弟节点，-1 表示没有
+    int visits;      ///< 访问次数
+    double total;    ///< 回传得分之和
+  };
+
+  /**
+   * @brief 单棵树的根节点统计
+   */
+  struct TreeResult {
+    std::vector<int> visits;   ///< 按根交换下标的访问次数
+    std::vector<double> total; ///< 按根交换下标的得分之和
+    int iterations;            ///< 完成的迭代次数
+    int nodes;                 ///< 节点数
+  };
+
+  /**
+   * @brief 根据地图构造决策输入
+   */
+  Job makeJob(const MapType &map, int timeBudgetMs) const;
+
+  /**
+   * @brief 执行决策
+   * 每个工作线程建一棵树，结束后按根交换合并，选访问次数最多者
+   */
+  AutoPlayResult search(const Job &job);
+
+  /**
+   * @brief 在一棵树上迭代直到截止时间、迭代上限或决策作废
+   * @param job 决策输入
+   * @param tree 树编号（决定随机流）
+   * @return 根节点统计
+   */
+  static TreeResult grow(const Job &job, int tree);
+
+  /**
+   * @brief 按模拟策略选择一步
+   * @param sim 模拟地图
+   * @param moves 当前合法交换
+   * @param policy 模拟策略
+   * @return 选中的下标
+   */
+  static int rolloutChoice(MapType &sim, const MoveList &moves,
+                           RolloutPolicy policy);
+
+  ThreadPool m_pool;          ///< 搜索线程池
+  mutable std::mutex m_mutex; ///< 保护参数
+  int m_horizon;              ///< 搜索视野
+  RolloutPolicy m_rollout;    ///< 模拟走子策略
+  double m_exploration;       ///< 探索系数
+  int m_iterationLimit;       ///< 每棵树的迭代上限
+  uint64_t m_seed;            ///< 随机种子
+  /// 异步决策的协调线程；最后声明，析构时先于线程池停止
+  LatestSearchWorker<Job, AutoPlayResult> m_async;
+};
+
+// 常用尺寸在 AutoPlayer.cpp 中显式实例化
+extern template class BasicAutoPlayer<8, 8, GEM_KIND>;
+extern template class BasicAutoPlayer<9, 9, GEM_KIND>;
+extern template class BasicAutoPlayer<10, 10, GEM_KIND>;
+
+typedef BasicAutoPlayer<ROW, COL, GEM_KIND> AutoPlayer; ///< 标准尺寸自动对局器
+
+#endif // AUTOPLAYER_H
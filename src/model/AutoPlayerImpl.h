@@ -0,0 +1,371 @@
+#ifndef AUTOPLAYERIMPL_H
+#define AUTOPLAYERIMPL_H
+
+// BasicAutoPlayer 模板的成员实现。
+// 常用尺寸已在 AutoPlayer.cpp 中显式实例化；其他尺寸的使用方需包含本文件
+
+#include "AutoPlayer.h"
+#include "GameSessionImpl.h"
+#include "GreedyPolicy.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief AutoPlayer构造函数实现
+ * @param threads 工作线程数
+ */
+template <int Rows, int Cols, int Kinds>
+BasicAutoPlayer<Rows, Cols, Kinds>::BasicAutoPlayer(int threads)
+    : m_pool(threads), m_horizon(DEFAULT_HORIZON), m_rollout(ROLLOUT_GREEDY),
+      m_exploration(0.7), m_iterationLimit(0), m_seed(Random::entropySeed()),
+      m_async([this](const Job &job) { return search(job); }) {}
+
+// 设置搜索视野
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::setHorizon(int moves) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_horizon = std::max(1, std::min(moves, int(MAX_HORIZON)));
+}
+
+// 设置模拟走子策略
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::setRolloutPolicy(
+    RolloutPolicy policy) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_rollout = policy;
+}
+
+// 设置探索系数
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::setExploration(double c) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_exploration = std::max(0.0, c);
+}
+
+// 设置每棵树的迭代上限
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::setIterationLimit(int iterations) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_iterationLimit = std::max(0, iterations);
+}
+
+// 设置随机种子
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::setSeed(uint64_t seed) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_seed = seed;
+}
+
+/**
+ * @brief 同步决策实现
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @return 决策结果
+ */
+template <int Rows, int Cols, int Kinds>
+AutoPlayResult
+BasicAutoPlayer<Rows, Cols, Kinds>::chooseMove(const MapType &map,
+                                               int timeBudgetMs) {
+  return search(makeJob(map, timeBudgetMs));
+}
+
+/**
+ * @brief 异步决策实现
+ * 只复制局面并登记任务，决策在协调线程中进行
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @param done 完成回调
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicAutoPlayer<Rows, Cols, Kinds>::chooseMoveAsync(const MapType &map,
+                                                         int timeBudgetMs,
+                                                         Callback done) {
+  m_async.post(makeJob(map, timeBudgetMs), std::move(done));
+}
+
+/**
+ * @brief 无界面连续对局实现
+ * @param session 游戏会话
+ * @param turns 回合数
+ * @param timeBudgetMs 每步时间预算（毫秒）
+ * @return 对局统计
+ */
+template <int Rows, int Cols, int Kinds>
+AutoPlayStats BasicAutoPlayer<Rows, Cols, Kinds>::play(SessionType &session,
+                                                       int turns,
+                                                       int timeBudgetMs) {
+  AutoPlayStats stats = {0, 0, 0, 0, 0, 0};
+  for (int t = 0; t < turns; t++) {
+    if (session.isResolving()) {
+      session.resolve();
+    }
+    const AutoPlayResult choice = chooseMove(session.map(), timeBudgetMs);
+    stats.iterations += choice.iterations;
+    if (!choice.found) {
+      break;
+    }
+    // 与界面点击交换走同一个入口：trySwap() 后结算到回合结束
+    const TurnResult turn = session.playMove(choice.move);
+    if (!turn.accepted) {
+      break;
+    }
+    stats.turns++;
+    stats.points += turn.points;
+    stats.cascades += turn.cascades;
+    stats.gemsCleared += turn.gemsCleared;
+    if (turn.reshuffled) {
+      stats.reshuffles++;
+    }
+  }
+  return stats;
+}
+
+/**
+ * @brief 构造决策输入实现
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @return 决策输入
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicAutoPlayer<Rows, Cols, Kinds>::Job
+BasicAutoPlayer<Rows, Cols, Kinds>::makeJob(const MapType &map,
+                                            int timeBudgetMs) const {
+  Job job;
+  uint64_t seed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    job.horizon = m_horizon;
+    job.rollout = m_rollout;
+    job.exploration = m_exploration;
+    job.iterationLimit = m_iterationLimit;
+    seed = m_seed;
+  }
+  job.capture(map, seed, timeBudgetMs);
+  return job;
+}
+
+/**
+ * @brief 决策实现
+ * @param job 决策输入
+ * @return 决策结果
+ */
+template <int Rows, int Cols, int Kinds>
+AutoPlayResult BasicAutoPlayer<Rows, Cols, Kinds>::search(const Job &job) {
+  AutoPlayResult result = {false, Move{-1, -1, -1, -1}, 0.0, 0, 0, false};
+  const int n = job.moves.size();
+  if (n == 0) {
+    return result;
+  }
+  if (n == 1) {
+    // 只有一种走法，无需搜索
+    result.found = true;
+    result.move = job.moves[0];
+    return result;
+  }
+
+  const int trees = m_pool.size();
+  std::vector<TreeResult> grown(trees);
+  std::vector<std::future<void>> pending;
+  for (int t = 0; t < trees; t++) {
+    pending.push_back(
+        m_pool.submit([&job, &grown, t]() { grown[t] = grow(job, t); }));
+  }
+  for (std::future<void> &f : pending) {
+    f.get();
+  }
+
+  std::vector<int> visits(n, 0);
+  std::vector<double> totals(n, 0.0);
+  for (const TreeResult &tree : grown) {
+    result.iterations += tree.iterations;
+    result.nodes += tree.nodes;
+    for (int m = 0; m < n; m++) {
+      visits[m] += tree.visits[m];
+      totals[m] += tree.total[m];
+    }
+  }
+  // 各树都跑满迭代上限时不算超时；否则以结束时是否已过截止时间为准
+  const bool finished = job.iterationLimit > 0 &&
+                        result.iterations >= trees * job.iterationLimit;
+  result.timedOut = !finished && Clock::now() >= job.deadline;
+
+  // 访问次数最多的交换最可靠，次数相同时取平均得分较高者
+  int best = -1;
+  for (int m = 0; m < n; m++) {
+    if (visits[m] == 0) {
+      continue;
+    }
+    if (best < 0 || visits[m] > visits[best] ||
+        (visits[m] == visits[best] &&
+         totals[m] / visits[m] > totals[best] / visits[best])) {
+      best = m;
+    }
+  }
+  if (best >= 0) {
+    result.found = true;
+    result.move = job.moves[best];
+    result.expectedScore = totals[best] / visits[best];
+    return result;
+  }
+
+  // 预算内一次迭代也没完成，退回只看第一步直接消除的得分
+  if (job.cancel.cancelled()) {
+    return result;
+  }
+  MapType sim(0);
+  sim.loadSnapshot(job.root);
+  const int m = rolloutChoice(sim, job.moves, ROLLOUT_GREEDY);
+  result.found = true;
+  result.move = job.moves[m];
+  return result;
+}
+
+/**
+ * @brief 单棵树搜索实现
+ * 每次迭代：选择（UCB1）-> 展开一个未尝试的合法交换 -> 模拟到视野上限 ->
+ * 回传。节点的得分只统计从该节点的交换开始获得的分数，
+ * 使兄弟节点的比较不受之前随机补充的影响
+ * @param job 决策输入
+ * @param tree 树编号
+ * @return 根节点统计
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicAutoPlayer<Rows, Cols, Kinds>::TreeResult
+BasicAutoPlayer<Rows, Cols, Kinds>::grow(const Job &job, int tree) {
+  const int n = job.moves.size();
+  TreeResult result;
+  result.visits.assign(n, 0);
+  result.total.assign(n, 0.0);
+  result.iterations = 0;
+
+  std::vector<Node> nodes;
+  nodes.reserve(1024);
+  nodes.push_back(Node{Move{-1, -1, -1, -1}, -1, -1, 0, 0.0});
+
+  MapType sim(0);
+  sim.setRefillPolicy(job.refill);
+  uint64_t stream = job.seed ^ (uint64_t(tree + 1) * 0x9e3779b97f4a7c15ULL);
+  double scale = 1.0; // 树内最大回传得分，用于把均值归一化
+
+  MoveList moves;
+  int path[MAX_HORIZON + 1];   // 本次迭代经过的节点
+  int before[MAX_HORIZON + 1]; // 到达各节点前已获得的分数
+
+  for (;;) {
+    if ((job.iterationLimit > 0 && result.iterations >= job.iterationLimit) ||
+        Clock::now() >= job.deadline || job.cancel.cancelled()) {
+      break;
+    }
+    sim.rng().setSeed(Random::splitMix64(stream));
+    sim.loadSnapshot(job.root);
+
+    int length = 0;
+    int reward = 0;
+    int node = 0;
+    path[length] = 0;
+    before[length] = 0;
+    length++;
+
+    // 选择与展开
+    bool expanded = false;
+    while (length <= job.horizon && !expanded) {
+      const MoveList *legal = &job.moves;
+      if (node != 0) {
+        if (sim.findMoves(moves) == 0) {
+          break;
+        }
+        legal = &moves;
+      }
+
+      int chosen = -1;
+      double bestValue = 0.0;
+      const double logVisits = std::log(double(nodes[node].visits) + 1.0);
+      for (const Move &move : *legal) {
+        int child = nodes[node].firstChild;
+        while (child >= 0 && nodes[child].move != move) {
+          child = nodes[child].nextSibling;
+        }
+        if (child < 0) {
+          if (int(nodes.size()) >= MAX_NODES_PER_TREE) {
+            continue;
+          }
+          // 展开第一个未尝试过的合法交换
+          child = int(nodes.size());
+          nodes.push_back(Node{move, -1, nodes[node].firstChild, 0, 0.0});
+          nodes[node].firstChild = child;
+          chosen = child;
+          expanded = true;
+          break;
+        }
+        const Node &c = nodes[child];
+        const double value =
+            c.total / (c.visits * scale) +
+            job.exploration * std::sqrt(logVisits / c.visits);
+        if (chosen < 0 || value > bestValue) {
+          chosen = child;
+          bestValue = value;
+        }
+      }
+      if (chosen < 0) {
+        break; // 节点数已达上限，从这里开始模拟
+      }
+
+      path[length] = chosen;
+      before[length] = reward;
+      length++;
+      reward += search_detail::playMove(sim, nodes[chosen].move);
+      node = chosen;
+    }
+
+    // 模拟：按策略走完剩余视野
+    for (int depth = length - 1; depth < job.horizon; depth++) {
+      if (sim.findMoves(moves) == 0) {
+        break;
+      }
+      const int m = rolloutChoice(sim, moves, job.rollout);
+      reward += search_detail::playMove(sim, moves[m]);
+    }
+
+    // 回传
+    scale = std::max(scale, double(reward));
+    for (int i = 0; i < length; i++) {
+      nodes[path[i]].visits++;
+      nodes[path[i]].total += reward - before[i];
+    }
+    result.iterations++;
+  }
+
+  // 根节点的子节点按交换对应回根交换下标
+  for (int child = nodes[0].firstChild; child >= 0;
+       child = nodes[child].nextSibling) {
+    for (int m = 0; m < n; m++) {
+      if (job.moves[m] == nodes[child].move) {
+        result.visits[m] = nodes[child].visits;
+        result.total[m] = nodes[child].total;
+        break;
+      }
+    }
+  }
+  result.nodes = int(nodes.size());
+  return result;
+}
+
+/**
+ * @brief 模拟走子选择实现
+ * 贪心策略见 greedyMoveIndex()，只看交换后立即形成的匹配得分
+ * @param sim 模拟地图
+ * @param moves 当前合法交换（非空）
+ * @param policy 模拟策略
+ * @return 选中的下标
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicAutoPlayer<Rows, Cols, Kinds>::rolloutChoice(MapType &sim,
+                                                      const MoveList &moves,
+                                                      RolloutPolicy policy) {
+  if (policy == ROLLOUT_RANDOM) {
+    return int(sim.rng().bounded(uint32_t(moves.size())));
+  }
+  return greedyMoveIndex(sim, moves);
+}
+
+#endif // AUTOPLAYERIMPL_H
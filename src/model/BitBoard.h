@@ -0,0 +1,198 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "BitMask.h"
+#include "CellPos.h"
+#include "Const.h"
+#include <vector>
+
+/**
+ * @brief 位棋盘类
+ * 为每种宝石颜色维护一张占用掩码（第 r 行第 c 列对应第 r*Cols+c 位），
+ * 用移位与按位与完成横向/纵向三连及以上的检测，全程无分支。
+ * 掩码类型在编译期按格子数选择：8x8 使用 uint64_t，更大的棋盘使用 WideMask
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
+ */
+template <int Rows, int Cols, int Kinds> class BasicBitBoard {
+public:
+  static const int CELLS = Rows * Cols;       ///< 格子数
+  typedef typename MaskFor<CELLS>::type Mask; ///< 掩码类型
+
+  /**
+   * @brief 构造函数
+   * 创建一个全空的位棋盘
+   */
+  BasicBitBoard() { clear(); }
+
+  /**
+   * @brief 清空所有掩码
+   */
+  void clear() {
+    for (int k = 0; k <= Kinds; k++) {
+      m_masks[k] = Mask();
+    }
+  }
+
+  /**
+   * @brief 设置指定格子的宝石类型
+   * 对每种颜色用掩码运算清除或置位
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param type 宝石类型，EMPTY 表示清空该格
+   */
+  void set(int r, int c, GemType type) {
+    const Mask bit = cellBit(bitIndex(r, c));
+    for (int k = 1; k <= Kinds; k++) {
+      // k == type 时保留 bit，否则为 0
+      const Mask select = (k == type) ? bit : Mask();
+      m_masks[k] = (m_masks[k] & ~bit) | select;
+    }
+  }
+
+  /**
+   * @brief 批量清空格子
+   * 每种颜色的掩码各做一次与非运算
+   * @param mask 要清空的格子
+   */
+  void clearMask(Mask mask) {
+    for (int k = 1; k <= Kinds; k++) {
+      m_masks[k] &= ~mask;
+    }
+  }
+
+  /**
+   * @brief 获取指定格子的宝石类型
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 宝石类型，空格返回 EMPTY
+   */
+  GemType get(int r, int c) const {
+    const Mask bit = cellBit(bitIndex(r, c));
+    int type = EMPTY;
+    for (int k = 1; k <= Kinds; k++) {
+      type |= k & -int(bool(m_masks[k] & bit));
+    }
+    return static_cast<GemType>(type);
+  }
+
+  /**
+   * @brief 获取某种颜色的占用掩码
+   * @param type 宝石类型
+   * @return 该颜色所在格子的位掩码，EMPTY 返回 0
+   */
+  Mask occupancy(GemType type) const {
+    if (type <= EMPTY || type > Kinds) {
+      return Mask();
+    }
+    return m_masks[type];
+  }
+
+  /**
+   * @brief 匹配检测内核
+   * 横向：m & (m>>1) & (m>>2) 得到三连起点，再左移 1、2 位回填整段；
+   * 纵向：同理以 Cols 为步长移位。连续 4、5 个时起点会重叠，回填后自然覆盖整段
+   * @return 所有需要消除的格子组成的位掩码
+   */
+  Mask matchMask() const {
+    Mask result = Mask();
+    for (int k = 1; k <= Kinds; k++) {
+      const Mask m = m_masks[k];
+
+      Mask h = m & (m >> 1) & (m >> 2) & kHorizontalStart;
+      h |= (h << 1) | (h << 2);
+
+      Mask v = m & (m >> Cols) & (m >> (2 * Cols));
+      v |= (v << Cols) | (v << (2 * Cols));
+
+      result |= h | v;
+    }
+    return result;
+  }
+
+  /**
+   * @brief 是否存在任意匹配
+   * 与 matchMask 相同的内核，但找到第一种有三连的颜色即返回，且不回填整段
+   * @return true 表示存在匹配
+   */
+  bool hasMatch() const {
+    for (int k = 1; k <= Kinds; k++) {
+      const Mask m = m_masks[k];
+      if ((m & (m >> 1) & (m >> 2) & kHorizontalStart) ||
+          (m & (m >> Cols) & (m >> (2 * Cols)))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief 计算掩码内宝石的总分
+   * 按颜色统计置位数再乘以分值，不逐格访问
+   * @param mask 格子掩码
+   * @return 总分
+   */
+  int score(Mask mask) const {
+    int total = 0;
+    for (int k = 1; k <= Kinds; k++) {
+      total += maskPopCount(m_masks[k] & mask) * GEM_SCORES[k];
+    }
+    return total;
+  }
+
+  /**
+   * @brief 将掩码转换为坐标集合
+   * 逐个取出最低位 1，按行列顺序追加
+   * @param mask 位掩码
+   * @param points 输出坐标集合（std::vector 或 FixedVector），追加写入
+   */
+  template <class Container>
+  static void maskToPoints(Mask mask, Container &points) {
+    while (mask) {
+      int i = maskLowestBit(mask);
+      points.push_back(CellPos{i / Cols, i % Cols});
+      mask = maskClearLowest(mask);
+    }
+  }
+
+  /**
+   * @brief 行列坐标转位序号
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 对应的位序号
+   */
+  static int bitIndex(int r, int c) { return r * Cols + c; }
+
+  /**
+   * @brief 构造单个格子的掩码
+   * @param i 位序号
+   * @return 只有第 i 位为 1 的掩码
+   */
+  static Mask cellBit(int i) { return maskBit<Mask>(i); }
+
+private:
+  /**
+   * @brief 生成横向三连起点掩码
+   * 只有列号不超过 Cols-3 的格子才能作为横向三连的起点，
+   * 以此屏蔽移位时跨行串位的情况
+   * @return 起点掩码
+   */
+  static constexpr Mask horizontalStartMask() {
+    Mask mask = Mask();
+    for (int i = 0; i < CELLS; i++) {
+      if (i % Cols <= Cols - 3) {
+        mask |= maskBit<Mask>(i);
+      }
+    }
+    return mask;
+  }
+
+  static constexpr Mask kHorizontalStart = horizontalStartMask(); ///< 横向起点
+
+  Mask m_masks[Kinds + 1]; ///< 各颜色占用掩码，下标为 GemType，EMPTY 位置恒为 0
+};
+
+typedef BasicBitBoard<ROW, COL, GEM_KIND> BitBoard; ///< 标准尺寸位棋盘
+
+#endif // BITBOARD_H
@@ -0,0 +1,227 @@
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief 多字位掩码
+ * 棋盘格子数超过 64 时使用，支持位运算与跨字移位，全部为 constexpr
+ * @tparam Words 64 位字数
+ */
+template <int Words> struct WideMask {
+  uint64_t w[Words]; ///< 各字，w[0] 为最低 64 位
+
+  constexpr WideMask() : w{} {}
+
+  /**
+   * @brief 构造只有第 i 位为 1 的掩码
+   * @param i 位序号
+   * @return 掩码
+   */
+  static constexpr WideMask bit(int i) {
+    WideMask m;
+    m.w[i / 64] = uint64_t(1) << (i % 64);
+    return m;
+  }
+
+  constexpr WideMask operator&(const WideMask &o) const {
+    WideMask r;
+    for (int i = 0; i < Words; i++) {
+      r.w[i] = w[i] & o.w[i];
+    }
+    return r;
+  }
+
+  constexpr WideMask operator|(const WideMask &o) const {
+    WideMask r;
+    for (int i = 0; i < Words; i++) {
+      r.w[i] = w[i] | o.w[i];
+    }
+    return r;
+  }
+
+  constexpr WideMask operator^(const WideMask &o) const {
+    WideMask r;
+    for (int i = 0; i < Words; i++) {
+      r.w[i] = w[i] ^ o.w[i];
+    }
+    return r;
+  }
+
+  constexpr WideMask operator~() const {
+    WideMask r;
+    for (int i = 0; i < Words; i++) {
+      r.w[i] = ~w[i];
+    }
+    return r;
+  }
+
+  constexpr WideMask operator<<(int n) const {
+    WideMask r;
+    const int q = n / 64;
+    const int b = n % 64;
+    for (int i = Words - 1; i >= 0; i--) {
+      const int src = i - q;
+      uint64_t v = 0;
+      if (src >= 0) {
+        v = w[src] << b;
+        if (b != 0 && src >= 1) {
+          v |= w[src - 1] >> (64 - b);
+        }
+      }
+      r.w[i] = v;
+    }
+    return r;
+  }
+
+  constexpr WideMask operator>>(int n) const {
+    WideMask r;
+    const int q = n / 64;
+    const int b = n % 64;
+    for (int i = 0; i < Words; i++) {
+      const int src = i + q;
+      uint64_t v = 0;
+      if (src < Words) {
+        v = w[src] >> b;
+        if (b != 0 && src + 1 < Words) {
+          v |= w[src + 1] << (64 - b);
+        }
+      }
+      r.w[i] = v;
+    }
+    return r;
+  }
+
+  constexpr WideMask &operator&=(const WideMask &o) { return *this = *this & o; }
+  constexpr WideMask &operator|=(const WideMask &o) { return *this = *this | o; }
+  constexpr WideMask &operator^=(const WideMask &o) { return *this = *this ^ o; }
+
+  constexpr bool operator==(const WideMask &o) const {
+    for (int i = 0; i < Words; i++) {
+      if (w[i] != o.w[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr bool operator!=(const WideMask &o) const { return !(*this == o); }
+
+  constexpr bool operator!() const {
+    for (int i = 0; i < Words; i++) {
+      if (w[i] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr explicit operator bool() const { return !!*this; }
+};
+
+/**
+ * @brief 按位数选择最窄的掩码类型
+ * 不超过 32 位用 uint32_t，不超过 64 位用 uint64_t，否则用 WideMask
+ * @tparam Bits 需要的位数
+ */
+template <int Bits> struct MaskFor {
+  typedef typename std::conditional<
+      (Bits <= 32), uint32_t,
+      typename std::conditional<(Bits <= 64), uint64_t,
+                                WideMask<(Bits + 63) / 64>>::type>::type type;
+};
+
+/**
+ * @brief 构造只有第 i 位为 1 的掩码
+ * @tparam M 掩码类型
+ * @param i 位序号
+ * @return 掩码
+ */
+template <class M> constexpr M maskBit(int i) {
+  if constexpr (std::is_integral<M>::value) {
+    return M(1) << i;
+  } else {
+    return M::bit(i);
+  }
+}
+
+// 统计置位数
+inline int maskPopCount(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(mask);
+#else
+  int count = 0;
+  while (mask) {
+    mask &= mask - 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+inline int maskPopCount(uint32_t mask) {
+  return maskPopCount(static_cast<uint64_t>(mask));
+}
+
+template <int Words> inline int maskPopCount(const WideMask<Words> &mask) {
+  int count = 0;
+  for (int i = 0; i < Words; i++) {
+    count += maskPopCount(mask.w[i]);
+  }
+  return count;
+}
+
+// 最低位 1 的序号（掩码必须非零）
+inline int maskLowestBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(mask);
+#elif defined(_MSC_VER) && defined(_WIN64)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return static_cast<int>(index);
+#else
+  int index = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+inline int maskLowestBit(uint32_t mask) {
+  return maskLowestBit(static_cast<uint64_t>(mask));
+}
+
+template <int Words> inline int maskLowestBit(const WideMask<Words> &mask) {
+  for (int i = 0; i < Words; i++) {
+    if (mask.w[i]) {
+      return i * 64 + maskLowestBit(mask.w[i]);
+    }
+  }
+  return -1;
+}
+
+// 清除最低位 1
+inline uint64_t maskClearLowest(uint64_t mask) { return mask & (mask - 1); }
+
+inline uint32_t maskClearLowest(uint32_t mask) { return mask & (mask - 1); }
+
+template <int Words>
+inline WideMask<Words> maskClearLowest(const WideMask<Words> &mask) {
+  WideMask<Words> r = mask;
+  for (int i = 0; i < Words; i++) {
+    if (r.w[i]) {
+      r.w[i] &= r.w[i] - 1;
+      break;
+    }
+  }
+  return r;
+}
+
+#endif // BITMASK_H
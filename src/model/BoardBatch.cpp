@@ -0,0 +1,289 @@
+#include "BoardBatch.h"
+#include "MovePatterns.h"
+#include <cstring>
+
+// 向量路径使用 GCC/Clang 的向量扩展：同一份内核按 64/128/256 位实例化，
+// AVX2 实例放在带 target 属性的函数中，内核强制内联后按 AVX2 生成代码
+#if defined(__GNUC__) || defined(__clang__)
+#define BATCH_INLINE inline __attribute__((always_inline))
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+#define BATCH_X86_VECTORS 1
+#endif
+#elif defined(_MSC_VER)
+#define BATCH_INLINE __forceinline
+#else
+#define BATCH_INLINE inline
+#endif
+
+namespace {
+
+const uint64_t kAllCells =
+    (ROW * COL == 64) ? ~uint64_t(0) : (uint64_t(1) << (ROW * COL)) - 1;
+
+// 列号 c 满足 0 <= c + dc < COL 的格子，下标为 dc + 2（dc 取 -2 ~ 2）
+constexpr uint64_t columnMask(int dc) {
+  uint64_t mask = 0;
+  for (int i = 0; i < ROW * COL; i++) {
+    const int c = i % COL + dc;
+    if (c >= 0 && c < COL) {
+      mask |= uint64_t(1) << i;
+    }
+  }
+  return mask;
+}
+
+constexpr uint64_t kColumnOk[5] = {columnMask(-2), columnMask(-1),
+                                   columnMask(0), columnMask(1),
+                                   columnMask(2)};
+
+// 横向三连起点：列号不超过 COL-3
+constexpr uint64_t kHorizontalStart = columnMask(2);
+
+BATCH_INLINE int popCount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  return maskPopCount(x);
+#endif
+}
+
+// 内核模板中的向量一律经引用传递：256 位向量按值传递或返回时，
+// 未启用 AVX 的函数与 AVX2 函数的调用约定不同（GCC 的 -Wpsabi）
+
+/**
+ * @brief 取相对偏移处的格子
+ * 结果第 B 位为 m 在 B + (dr, dc) 处的位，越界为 0
+ * @param out 输出
+ */
+template <class V>
+BATCH_INLINE void shiftTo(V &out, const V &m, int dr, int dc) {
+  const int offset = dr * COL + dc;
+  const V moved = offset >= 0 ? (m >> offset) : (m << -offset);
+  out = moved & (kColumnOk[dc + 2] & kAllCells);
+}
+
+/**
+ * @brief 某颜色沿方向 dir 移入后能组成三连的目标格
+ * 目标格 B 的来源格 B - dir 为该颜色，且 B 的某个支撑格对都为该颜色
+ * @param out 输出
+ */
+template <class V> BATCH_INLINE void arrivals(V &out, const V &m, int dir) {
+  const PatternPair *pairs = kMovePatterns.pairs[dir];
+  V a;
+  V b;
+  shiftTo(a, m, pairs[0].a.dr, pairs[0].a.dc);
+  shiftTo(b, m, pairs[0].b.dr, pairs[0].b.dc);
+  V lines = a & b;
+  for (int p = 1; p < PATTERNS_PER_DIR; p++) {
+    shiftTo(a, m, pairs[p].a.dr, pairs[p].a.dc);
+    shiftTo(b, m, pairs[p].b.dr, pairs[p].b.dc);
+    lines |= a & b;
+  }
+  const Offset &d = kMovePatterns.dirs[dir];
+  shiftTo(a, m, -d.dr, -d.dc);
+  out = lines & a;
+}
+
+/**
+ * @brief 评估一组棋盘
+ * V 的每个 64 位通道对应一个棋盘。合法交换的判定与
+ * GameMap::isLegalSwap() 相同：两格都非空、颜色不同，且任一方移入后组成三连
+ * @tparam V 向量类型（uint64_t 即单个棋盘）
+ */
+template <class V>
+BATCH_INLINE void evaluateGroup(const PackedBoard *boards,
+                                BoardEval *results) {
+  const int lanes = sizeof(V) / sizeof(uint64_t);
+  V colors[GEM_KIND];
+  for (int k = 0; k < GEM_KIND; k++) {
+    uint64_t words[lanes];
+    for (int l = 0; l < lanes; l++) {
+      words[l] = boards[l].colors[k];
+    }
+    std::memcpy(&colors[k], words, sizeof(V));
+  }
+
+  const V zero = {};
+  V occupied = zero;
+  V matches = zero;
+  V right = zero;
+  V down = zero;
+  V sameRight = zero;
+  V sameDown = zero;
+  for (int k = 0; k < GEM_KIND; k++) {
+    const V m = colors[k];
+    occupied |= m;
+
+    V h = m & (m >> 1) & (m >> 2) & kHorizontalStart;
+    h |= (h << 1) | (h << 2);
+    V v = m & (m >> COL) & (m >> (2 * COL));
+    v |= (v << COL) | (v << (2 * COL));
+    matches |= (h | v) & kAllCells;
+
+    // 向右交换记在左格，向下交换记在上格
+    V t;
+    V u;
+    shiftTo(t, m, 0, 1);
+    sameRight |= m & t;
+    shiftTo(t, m, 1, 0);
+    sameDown |= m & t;
+    arrivals(t, m, DIR_RIGHT);
+    shiftTo(u, t, 0, 1);
+    arrivals(t, m, DIR_LEFT);
+    right |= u | t;
+    arrivals(t, m, DIR_DOWN);
+    shiftTo(u, t, 1, 0);
+    arrivals(t, m, DIR_UP);
+    down |= u | t;
+  }
+  V t;
+  shiftTo(t, occupied, 0, 1);
+  right &= occupied & t & ~sameRight;
+  shiftTo(t, occupied, 1, 0);
+  down &= occupied & t & ~sameDown;
+
+  uint64_t matchWords[lanes];
+  uint64_t rightWords[lanes];
+  uint64_t downWords[lanes];
+  std::memcpy(matchWords, &matches, sizeof(V));
+  std::memcpy(rightWords, &right, sizeof(V));
+  std::memcpy(downWords, &down, sizeof(V));
+  for (int l = 0; l < lanes; l++) {
+    int score = 0;
+    for (int k = 0; k < GEM_KIND; k++) {
+      score += popCount(boards[l].colors[k] & matchWords[l]) *
+               GEM_SCORES[k + 1];
+    }
+    results[l].matches = matchWords[l];
+    results[l].moves = popCount(rightWords[l]) + popCount(downWords[l]);
+    results[l].score = score;
+  }
+}
+
+/**
+ * @brief 按组评估全部棋盘，不足一组的尾部逐个计算
+ */
+template <class V>
+BATCH_INLINE void evaluateAll(const PackedBoard *boards, int count,
+                              BoardEval *results) {
+  const int lanes = sizeof(V) / sizeof(uint64_t);
+  int i = 0;
+  for (; i + lanes <= count; i += lanes) {
+    evaluateGroup<V>(boards + i, results + i);
+  }
+  for (; i < count; i++) {
+    evaluateGroup<uint64_t>(boards + i, results + i);
+  }
+}
+
+void evaluateScalar(const PackedBoard *boards, int count,
+                    BoardEval *results) {
+  evaluateAll<uint64_t>(boards, count, results);
+}
+
+#ifdef BATCH_X86_VECTORS
+typedef uint64_t U64x2 __attribute__((vector_size(16)));
+typedef uint64_t U64x4 __attribute__((vector_size(32)));
+
+void evaluateSse2(const PackedBoard *boards, int count, BoardEval *results) {
+  evaluateAll<U64x2>(boards, count, results);
+}
+
+__attribute__((target("avx2,popcnt"))) void
+evaluateAvx2(const PackedBoard *boards, int count, BoardEval *results) {
+  evaluateAll<U64x4>(boards, count, results);
+}
+#endif
+
+// 检测当前 CPU 支持的最宽指令集
+BatchIsa detectIsa() {
+#ifdef BATCH_X86_VECTORS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+    return BATCH_AVX2;
+  }
+  return BATCH_SSE2;
+#else
+  return BATCH_SCALAR;
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief 打包地图实现
+ * @param map 标准尺寸地图
+ * @return 打包的棋盘
+ */
+PackedBoard BoardBatch::pack(const GameMap &map) {
+  PackedBoard board;
+  for (int k = 1; k <= GEM_KIND; k++) {
+    board.colors[k - 1] = map.bitBoard().occupancy(static_cast<GemType>(k));
+  }
+  return board;
+}
+
+/**
+ * @brief 批量评估实现
+ * @param boards 棋盘数组
+ * @param count 棋盘数
+ * @param results 输出数组
+ */
+void BoardBatch::evaluate(const PackedBoard *boards, int count,
+                          BoardEval *results) {
+  evaluate(boards, count, results, bestIsa());
+}
+
+/**
+ * @brief 以指定指令集批量评估实现
+ * @param boards 棋盘数组
+ * @param count 棋盘数
+ * @param results 输出数组
+ * @param isa 指令集
+ */
+void BoardBatch::evaluate(const PackedBoard *boards, int count,
+                          BoardEval *results, BatchIsa isa) {
+  const BatchIsa best = bestIsa(); // 已缓存，不重复检测 CPU
+  if (isa > best) {
+    isa = best;
+  }
+  switch (isa) {
+#ifdef BATCH_X86_VECTORS
+  case BATCH_AVX2:
+    evaluateAvx2(boards, count, results);
+    return;
+  case BATCH_SSE2:
+    evaluateSse2(boards, count, results);
+    return;
+#endif
+  default:
+    evaluateScalar(boards, count, results);
+    return;
+  }
+}
+
+/**
+ * @brief 检测指令集实现
+ * 只在第一次调用时检测 CPU，之后返回缓存的结果
+ * @return 当前 CPU 支持的最宽指令集
+ */
+BatchIsa BoardBatch::bestIsa() {
+  static const BatchIsa isa = detectIsa();
+  return isa;
+}
+
+/**
+ * @brief 获取指令集名称实现
+ * @param isa 指令集
+ * @return 名称
+ */
+const char *BoardBatch::isaName(BatchIsa isa) {
+  switch (isa) {
+  case BATCH_AVX2:
+    return "avx2";
+  case BATCH_SSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
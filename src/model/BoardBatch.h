@@ -0,0 +1,86 @@
+#ifndef BOARDBATCH_H
+#define BOARDBATCH_H
+
+#include "GameMap.h"
+#include <cstdint>
+
+static_assert(ROW * COL <= 64, "批量评估要求每种颜色的占用掩码放进一个 64 位字");
+
+/**
+ * @brief 打包的标准尺寸棋盘
+ * 每种颜色一个 64 位占用掩码，第 r*COL+c 位对应第 r 行第 c 列
+ */
+struct PackedBoard {
+  uint64_t colors[GEM_KIND]; ///< colors[k-1] 为颜色 k 的占用掩码
+};
+
+/**
+ * @brief 单个棋盘的评估结果
+ */
+struct BoardEval {
+  uint64_t matches; ///< 现成匹配的格子掩码（与 GameMap::matchMask() 相同）
+  int moves;        ///< 合法交换数（与 GameMap::findMoves() 数量相同）
+  int score;        ///< 现成匹配的得分（与 GameMap::maskScore() 相同）
+};
+
+/**
+ * @brief 批量评估使用的指令集
+ */
+enum BatchIsa {
+  BATCH_SCALAR, ///< 逐个棋盘的 64 位整数运算
+  BATCH_SSE2,   ///< 128 位向量，每次 2 个棋盘
+  BATCH_AVX2    ///< 256 位向量，每次 4 个棋盘
+};
+
+/**
+ * @brief 批量棋盘评估
+ * 把位棋盘的匹配内核与交换模板改写为对整张掩码的移位与按位运算，
+ * 多个棋盘的同一颜色掩码放进一个向量的不同通道，一条指令同时处理多个棋盘。
+ * 运行时按 CPU 支持选择 AVX2 / SSE2，其他平台与编译器退回逐个棋盘计算，
+ * 各路径结果完全一致
+ */
+class BoardBatch {
+public:
+  /**
+   * @brief 打包地图
+   * @param map 标准尺寸地图
+   * @return 打包的棋盘
+   */
+  static PackedBoard pack(const GameMap &map);
+
+  /**
+   * @brief 批量评估
+   * 使用当前 CPU 支持的最宽指令集
+   * @param boards 棋盘数组
+   * @param count 棋盘数
+   * @param results 输出数组（至少 count 个元素）
+   */
+  static void evaluate(const PackedBoard *boards, int count,
+                       BoardEval *results);
+
+  /**
+   * @brief 以指定指令集批量评估
+   * 供对比测试使用；CPU 不支持时退回可用的最宽指令集
+   * @param boards 棋盘数组
+   * @param count 棋盘数
+   * @param results 输出数组
+   * @param isa 指令集
+   */
+  static void evaluate(const PackedBoard *boards, int count,
+                       BoardEval *results, BatchIsa isa);
+
+  /**
+   * @brief 获取当前 CPU 支持的最宽指令集
+   * @return 指令集
+   */
+  static BatchIsa bestIsa();
+
+  /**
+   * @brief 获取指令集名称
+   * @param isa 指令集
+   * @return 名称（"scalar" / "sse2" / "avx2"）
+   */
+  static const char *isaName(BatchIsa isa);
+};
+
+#endif // BOARDBATCH_H
@@ -0,0 +1,20 @@
+#ifndef CELLPOS_H
+#define CELLPOS_H
+
+/**
+ * @brief 格子坐标
+ * 游戏核心使用的行列坐标，不依赖 Qt
+ */
+struct CellPos {
+  int row; ///< 行坐标
+  int col; ///< 列坐标
+
+  // 重载 == 操作符，方便比较两个坐标是否相同
+  bool operator==(const CellPos &other) const {
+    return row == other.row && col == other.col;
+  }
+
+  bool operator!=(const CellPos &other) const { return !(*this == other); }
+};
+
+#endif // CELLPOS_H
@@ -0,0 +1,33 @@
+#ifndef CHALLENGE_H
+#define CHALLENGE_H
+
+#include <algorithm>
+
+// 闯关模式配置
+const int CHALLENGE_BASE_TIME = 90;    // 第一关时间 (秒)
+const int CHALLENGE_TIME_STEP = 10;    // 每关减少的时间 (秒)
+const int CHALLENGE_MIN_TIME = 30;     // 关卡时间下限 (秒)
+const int CHALLENGE_BASE_SCORE = 1000; // 第一关目标分数
+const int CHALLENGE_SCORE_STEP = 500;  // 每关增加的目标分数
+
+/**
+ * @brief 获取闯关模式的关卡时间
+ * 界面与批量模拟共用，保证模拟出的过关率与实际规则一致
+ * @param level 关卡数（从 1 开始）
+ * @return 关卡时间（秒），每关减少 10 秒，最低 30 秒
+ */
+inline int challengeTime(int level) {
+  return std::max(CHALLENGE_BASE_TIME - (level - 1) * CHALLENGE_TIME_STEP,
+                  CHALLENGE_MIN_TIME);
+}
+
+/**
+ * @brief 获取闯关模式的关卡目标分数
+ * @param level 关卡数（从 1 开始）
+ * @return 目标分数，每关线性递增 500
+ */
+inline int challengeTargetScore(int level) {
+  return CHALLENGE_BASE_SCORE + (level - 1) * CHALLENGE_SCORE_STEP;
+}
+
+#endif // CHALLENGE_H
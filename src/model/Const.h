@@ -7,11 +7,16 @@ const int COL = 8;      // 地图列数
 const int GEM_KIND = 7; // 宝石种类数 (7种颜色)
 
 // 界面渲染配置
-const int GEM_SIZE = 60; // 宝石尺寸 (像素)
-const int SPACING = 0;   // 宝石间距
+const int GEM_SIZE = 60;          // 宝石尺寸 (像素)
+const int SPACING = 0;            // 宝石间距
+const int STEP_INTERVAL_MS = 500; // 结算动画每个阶段的间隔 (毫秒)
 
-// 宝石类型
-enum GemType {
+// 提示与自动对局配置
+const int HINT_TIME_BUDGET_MS = 300;     // 提示搜索时间预算 (毫秒)
+const int AUTOPLAY_TIME_BUDGET_MS = 200; // 自动对局每步思考时间 (毫秒)
+
+// 宝石类型（底层为单字节，使每个格子保持最窄存储）
+enum GemType : unsigned char {
   EMPTY = 0, // 空 (消除后)
   RED,
   ORANGE,
@@ -47,4 +52,16 @@ enum GameMode {
   CHALLENGE ///< 挑战模式，有时间限制和关卡目标
 };
 
+// 下落补充策略
+enum RefillPolicy {
+  REFILL_RANDOM,  ///< 补充宝石完全随机，可能出现死局
+  REFILL_PLAYABLE ///< 补充宝石保证稳定后仍有合法交换
+};
+
+// 自动对局的模拟走子策略
+enum RolloutPolicy {
+  ROLLOUT_RANDOM, ///< 随机选择合法交换（最快）
+  ROLLOUT_GREEDY  ///< 选择直接消除得分最高的交换
+};
+
 #endif // CONST_H
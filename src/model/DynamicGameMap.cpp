@@ -0,0 +1,281 @@
+#include "DynamicGameMap.h"
+#include "MovePatterns.h"
+#include <algorithm>
+
+// std::min/std::max 按引用取边长上下限，需要类外定义
+const int DynamicGameMap::MIN_DIMENSION;
+const int DynamicGameMap::MAX_DIMENSION;
+
+/**
+ * @brief DynamicGameMap构造函数实现
+ * @param rows 行数
+ * @param cols 列数
+ * @param kinds 宝石种类数
+ * @param seed 随机种子
+ */
+DynamicGameMap::DynamicGameMap(int rows, int cols, int kinds, uint64_t seed)
+    : m_rows(std::min(std::max(rows, MIN_DIMENSION), MAX_DIMENSION)),
+      m_cols(std::min(std::max(cols, MIN_DIMENSION), MAX_DIMENSION)),
+      m_kinds(std::min(std::max(kinds, 3), GEM_KIND)), m_rng(seed),
+      m_cells(size_t(m_rows) * m_cols, EMPTY),
+      m_matched(size_t(m_rows) * m_cols, 0), m_writeRow(m_cols, 0),
+      m_lowestEmptyRow(m_rows - 1) {}
+
+/**
+ * @brief 初始化地图实现
+ * 左侧两格同色则排除该色，上方两格同色也排除该色，最多排除 2 种，
+ * 种类数不少于 3 时总有可选颜色
+ */
+void DynamicGameMap::init() {
+  for (int r = 0; r < m_rows; r++) {
+    uint8_t *row = &m_cells[index(r, 0)];
+    const uint8_t *up1 = r >= 1 ? &m_cells[index(r - 1, 0)] : nullptr;
+    const uint8_t *up2 = r >= 2 ? &m_cells[index(r - 2, 0)] : nullptr;
+    for (int c = 0; c < m_cols; c++) {
+      int banA =
+          (c >= 2 && row[c - 1] == row[c - 2]) ? row[c - 1] : int(EMPTY);
+      int banB = (up2 && up1[c] == up2[c]) ? up1[c] : int(EMPTY);
+      if (banB == banA) {
+        banB = EMPTY;
+      }
+      int allowed = m_kinds - (banA != EMPTY) - (banB != EMPTY);
+      // 在允许的颜色中均匀选取：先取序号，再跳过被排除的颜色
+      int type = static_cast<int>(m_rng.bounded(allowed)) + 1;
+      int lo = std::min(banA, banB);
+      int hi = std::max(banA, banB);
+      if (lo != EMPTY && type >= lo) {
+        type++;
+      }
+      if (hi != EMPTY && type >= hi) {
+        type++;
+      }
+      row[c] = static_cast<uint8_t>(type);
+    }
+  }
+  std::fill(m_matched.begin(), m_matched.end(), 0);
+  m_lowestEmptyRow = -1;
+}
+
+/**
+ * @brief 交换两个宝石实现
+ */
+void DynamicGameMap::swap(int r1, int c1, int r2, int c2) {
+  if (!isValid(r1, c1) || !isValid(r2, c2)) {
+    return;
+  }
+  std::swap(m_cells[index(r1, c1)], m_cells[index(r2, c2)]);
+}
+
+/**
+ * @brief 标记所有匹配实现
+ * 每个三连起点标记三格；连续 4、5 个由相邻起点重叠覆盖。
+ * 内层循环只做同一行（或相邻三行同列）的顺序比较
+ * @return 被标记的格子数
+ */
+size_t DynamicGameMap::findMatches() {
+  std::fill(m_matched.begin(), m_matched.end(), 0);
+
+  for (int r = 0; r < m_rows; r++) {
+    const uint8_t *row = &m_cells[index(r, 0)];
+    uint8_t *mark = &m_matched[index(r, 0)];
+
+    // 横向三连
+    for (int c = 0; c + 2 < m_cols; c++) {
+      uint8_t t = row[c];
+      if (t != EMPTY && row[c + 1] == t && row[c + 2] == t) {
+        mark[c] = mark[c + 1] = mark[c + 2] = 1;
+      }
+    }
+
+    // 纵向三连：当前行与下面两行逐列比较
+    if (r + 2 < m_rows) {
+      const uint8_t *down1 = row + m_cols;
+      const uint8_t *down2 = down1 + m_cols;
+      uint8_t *mark1 = mark + m_cols;
+      uint8_t *mark2 = mark1 + m_cols;
+      for (int c = 0; c < m_cols; c++) {
+        uint8_t t = row[c];
+        if (t != EMPTY && down1[c] == t && down2[c] == t) {
+          mark[c] = mark1[c] = mark2[c] = 1;
+        }
+      }
+    }
+  }
+
+  size_t count = 0;
+  for (uint8_t m : m_matched) {
+    count += m;
+  }
+  return count;
+}
+
+/**
+ * @brief 检查全图匹配实现
+ * @return 匹配坐标集合
+ */
+std::vector<CellPos> DynamicGameMap::checkMatches() {
+  std::vector<CellPos> matches;
+  if (findMatches() == 0) {
+    return matches;
+  }
+  for (int r = 0; r < m_rows; r++) {
+    const uint8_t *mark = &m_matched[index(r, 0)];
+    for (int c = 0; c < m_cols; c++) {
+      if (mark[c]) {
+        matches.push_back(CellPos{r, c});
+      }
+    }
+  }
+  return matches;
+}
+
+/**
+ * @brief 消除标记格子实现
+ * @return 消除宝石的总分
+ */
+long long DynamicGameMap::eliminateMatched() {
+  long long points = 0;
+  for (int r = 0; r < m_rows; r++) {
+    uint8_t *row = &m_cells[index(r, 0)];
+    const uint8_t *mark = &m_matched[index(r, 0)];
+    bool rowHit = false;
+    for (int c = 0; c < m_cols; c++) {
+      if (mark[c]) {
+        points += GEM_SCORES[row[c]];
+        row[c] = EMPTY;
+        rowHit = true;
+      }
+    }
+    if (rowHit) {
+      m_lowestEmptyRow = std::max(m_lowestEmptyRow, r);
+    }
+  }
+  std::fill(m_matched.begin(), m_matched.end(), 0);
+  return points;
+}
+
+/**
+ * @brief 执行消除实现
+ * @param points 需要消除的宝石坐标集合
+ */
+void DynamicGameMap::eliminate(const std::vector<CellPos> &points) {
+  for (const auto &point : points) {
+    if (isValid(point.row, point.col)) {
+      m_cells[index(point.row, point.col)] = EMPTY;
+      m_lowestEmptyRow = std::max(m_lowestEmptyRow, point.row);
+    }
+  }
+}
+
+/**
+ * @brief 下落填充实现
+ * 最低空格以下的行不受影响；从该行向上逐行处理，
+ * 每列的写入行号初始为该行，遇到宝石就搬到写入行并上移写入行号
+ */
+void DynamicGameMap::applyGravity() {
+  if (m_lowestEmptyRow < 0) {
+    return;
+  }
+  std::fill(m_writeRow.begin(), m_writeRow.end(), m_lowestEmptyRow);
+
+  for (int r = m_lowestEmptyRow; r >= 0; r--) {
+    uint8_t *row = &m_cells[index(r, 0)];
+    for (int c = 0; c < m_cols; c++) {
+      uint8_t t = row[c];
+      if (t == EMPTY) {
+        continue;
+      }
+      int w = m_writeRow[c];
+      if (w != r) {
+        m_cells[index(w, c)] = t;
+        row[c] = EMPTY;
+      }
+      m_writeRow[c] = w - 1;
+    }
+  }
+
+  // 各列写入行号及以上全部为空，按行顺序补充随机宝石
+  for (int r = 0; r <= m_lowestEmptyRow; r++) {
+    uint8_t *row = &m_cells[index(r, 0)];
+    for (int c = 0; c < m_cols; c++) {
+      if (r <= m_writeRow[c]) {
+        row[c] = static_cast<uint8_t>(m_rng.bounded(m_kinds) + 1);
+      }
+    }
+  }
+  m_lowestEmptyRow = -1;
+}
+
+/**
+ * @brief 连续结算实现
+ * @param points 可选的得分累加
+ * @return 消除轮数
+ */
+int DynamicGameMap::settle(long long *points) {
+  int rounds = 0;
+  while (findMatches() > 0) {
+    long long gained = eliminateMatched();
+    if (points) {
+      *points += gained;
+    }
+    applyGravity();
+    rounds++;
+  }
+  return rounds;
+}
+
+/**
+ * @brief 模板匹配实现
+ * @param type 移入的宝石类型
+ * @param r 目标行坐标
+ * @param c 目标列坐标
+ * @param dir 移动方向
+ * @return true 表示能组成三连
+ */
+bool DynamicGameMap::formsLineAt(GemType type, int r, int c, int dir) const {
+  for (const PatternPair &p : kMovePatterns.pairs[dir]) {
+    if (getGemType(r + p.a.dr, c + p.a.dc) == type &&
+        getGemType(r + p.b.dr, c + p.b.dc) == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 交换合法性判断实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @param dir DIR_RIGHT 或 DIR_DOWN
+ * @return true 表示合法
+ */
+bool DynamicGameMap::isLegalSwap(int r, int c, int dir) const {
+  const Offset &d = kMovePatterns.dirs[dir];
+  const int nr = r + d.dr;
+  const int nc = c + d.dc;
+  if (!isValid(nr, nc)) {
+    return false;
+  }
+  const GemType a = static_cast<GemType>(m_cells[index(r, c)]);
+  const GemType b = static_cast<GemType>(m_cells[index(nr, nc)]);
+  if (a == b || a == EMPTY || b == EMPTY) {
+    return false;
+  }
+  const int back = (dir == DIR_RIGHT) ? DIR_LEFT : DIR_UP;
+  return formsLineAt(a, nr, nc, dir) || formsLineAt(b, r, c, back);
+}
+
+/**
+ * @brief 死局检测实现
+ * @return true 表示存在合法交换
+ */
+bool DynamicGameMap::hasPossibleMove() const {
+  for (int r = 0; r < m_rows; r++) {
+    for (int c = 0; c < m_cols; c++) {
+      if (isLegalSwap(r, c, DIR_RIGHT) || isLegalSwap(r, c, DIR_DOWN)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
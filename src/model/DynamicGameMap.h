@@ -0,0 +1,162 @@
+#ifndef DYNAMICGAMEMAP_H
+#define DYNAMICGAMEMAP_H
+
+#include "CellPos.h"
+#include "Const.h"
+#include "Random.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 运行时尺寸的大棋盘
+ * 行列数在构造时指定（最大 MAX_DIMENSION x MAX_DIMENSION），宝石按行优先存放在一块连续内存中。
+ * 初始化、匹配检测、下落填充和死局检测都是按行顺序推进的线性遍历，
+ * 供规则引擎压测和规模化基准使用；普通对局请使用 GameMap
+ */
+class DynamicGameMap {
+public:
+  static const int MIN_DIMENSION = 3;    ///< 最小边长
+  static const int MAX_DIMENSION = 4096; ///< 最大边长
+
+  /**
+   * @brief 构造函数
+   * 行列数与种类数超出范围时截断到有效范围，地图初始为空，需调用 init()
+   * @param rows 行数
+   * @param cols 列数
+   * @param kinds 宝石种类数（3 ~ GEM_KIND）
+   * @param seed 随机种子
+   */
+  DynamicGameMap(int rows, int cols, int kinds = GEM_KIND,
+                 uint64_t seed = Random::entropySeed());
+
+  int rows() const { return m_rows; }   ///< 行数
+  int cols() const { return m_cols; }   ///< 列数
+  int kinds() const { return m_kinds; } ///< 宝石种类数
+
+  /**
+   * @brief 检查坐标是否有效
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return true表示坐标在有效范围内
+   */
+  bool isValid(int r, int c) const {
+    return r >= 0 && r < m_rows && c >= 0 && c < m_cols;
+  }
+
+  /**
+   * @brief 获取指定位置的宝石类型
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 宝石类型，如果坐标无效返回EMPTY
+   */
+  GemType getGemType(int r, int c) const {
+    return isValid(r, c) ? static_cast<GemType>(m_cells[index(r, c)]) : EMPTY;
+  }
+
+  /**
+   * @brief 获取指定位置宝石的分值
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 宝石的分值，如果坐标无效返回0
+   */
+  int getGemScore(int r, int c) const { return GEM_SCORES[getGemType(r, c)]; }
+
+  /**
+   * @brief 初始化地图
+   * 单遍构造：每格只从不会与左侧两格或上方两格组成三连的颜色中选取，
+   * 一遍即保证没有现成匹配，不做整板重抽
+   */
+  void init();
+
+  /**
+   * @brief 交换两个宝石
+   */
+  void swap(int r1, int c1, int r2, int c2);
+
+  /**
+   * @brief 标记所有匹配
+   * 逐行比较相邻三格（横向）与上下三行同列（纵向），结果写入内部标记缓冲
+   * @return 被标记的格子数
+   */
+  size_t findMatches();
+
+  /**
+   * @brief 检查全图是否有可消除项
+   * @return 返回所有需要消除的坐标点集合
+   */
+  std::vector<CellPos> checkMatches();
+
+  /**
+   * @brief 消除最近一次 findMatches() 标记的格子
+   * @return 消除宝石的总分
+   */
+  long long eliminateMatched();
+
+  /**
+   * @brief 执行消除
+   * @param points 要消除的坐标集合,将这些位置设为 EMPTY
+   */
+  void eliminate(const std::vector<CellPos> &points);
+
+  /**
+   * @brief 下落填充算法
+   * 自底向上逐行处理，每列维护一个写入行号，宝石直接落到写入位置；
+   * 只处理最低空格所在行以上的部分
+   */
+  void applyGravity();
+
+  /**
+   * @brief 连续结算直到稳定
+   * 重复“标记 -> 消除 -> 下落”，用作压测负载
+   * @param points 可选，累加消除得分
+   * @return 消除轮数
+   */
+  int settle(long long *points = nullptr);
+
+  /**
+   * @brief 死局检测
+   * 用邻域模板按行扫描，找到第一个合法交换即返回
+   * @return true 表示玩家还有步子可以走
+   */
+  bool hasPossibleMove() const;
+
+  /**
+   * @brief 获取原始格子数据
+   * @return 行优先排列的宝石类型数组，长度为 rows()*cols()
+   */
+  const uint8_t *data() const { return m_cells.data(); }
+
+private:
+  int m_rows;                     ///< 行数
+  int m_cols;                     ///< 列数
+  int m_kinds;                    ///< 宝石种类数
+  Random m_rng;                   ///< 随机数生成器
+  std::vector<uint8_t> m_cells;   ///< 行优先的宝石类型
+  std::vector<uint8_t> m_matched; ///< 行优先的匹配标记
+  std::vector<int> m_writeRow;    ///< 下落时各列的写入行号
+  int m_lowestEmptyRow;           ///< 当前最低空格所在行，-1 表示没有空格
+
+  // 行列坐标转一维下标
+  size_t index(int r, int c) const { return size_t(r) * m_cols + c; }
+
+  /**
+   * @brief 判断交换是否合法
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param dir DIR_RIGHT 或 DIR_DOWN
+   * @return true 表示合法
+   */
+  bool isLegalSwap(int r, int c, int dir) const;
+
+  /**
+   * @brief 模板匹配
+   * @param type 移入的宝石类型
+   * @param r 目标行坐标
+   * @param c 目标列坐标
+   * @param dir 移动方向
+   * @return true 表示能组成三连
+   */
+  bool formsLineAt(GemType type, int r, int c, int dir) const;
+};
+
+#endif // DYNAMICGAMEMAP_H
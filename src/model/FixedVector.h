@@ -0,0 +1,48 @@
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+/**
+ * @brief 定长容量的顺序容器
+ * 元素存放在对象内部的数组中，不经过堆分配；容量在编译期确定，
+ * 供高频查询写入调用方持有、可反复复用的缓冲
+ * @tparam T 元素类型（需可默认构造）
+ * @tparam Capacity 最大元素个数
+ */
+template <class T, int Capacity> class FixedVector {
+public:
+  typedef T value_type;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+
+  FixedVector() : m_size(0) {}
+
+  /**
+   * @brief 追加元素
+   * 容量已满时忽略（调用方按最大可能数量选择容量）
+   * @param value 元素
+   */
+  void push_back(const T &value) {
+    if (m_size < Capacity) {
+      m_items[m_size++] = value;
+    }
+  }
+
+  void clear() { m_size = 0; }               ///< 清空（不释放任何内存）
+  int size() const { return m_size; }        ///< 元素个数
+  bool empty() const { return m_size == 0; } ///< 是否为空
+  static int capacity() { return Capacity; } ///< 容量
+
+  T &operator[](int i) { return m_items[i]; }
+  const T &operator[](int i) const { return m_items[i]; }
+
+  iterator begin() { return m_items; }
+  iterator end() { return m_items + m_size; }
+  const_iterator begin() const { return m_items; }
+  const_iterator end() const { return m_items + m_size; }
+
+private:
+  T m_items[Capacity]; ///< 元素存储
+  int m_size;          ///< 元素个数
+};
+
+#endif // FIXEDVECTOR_H
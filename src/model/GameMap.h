@@ -1,22 +1,131 @@
 #ifndef GAMEMAP_H
 #define GAMEMAP_H
 
+#include "BitBoard.h"
+#include "FixedVector.h"
 #include "Gem.h"
-#include <QPoint>
-#include <stack>
+#include "Move.h"
+#include "Random.h"
+#include "UndoJournal.h"
+#include "Zobrist.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 /**
  * @brief 游戏地图类
- * 负责管理游戏的核心数据和逻辑：地图初始化、宝石交换、匹配检测、消除、下落填充等
+ * 负责管理游戏的核心数据和逻辑：地图初始化、宝石交换、匹配检测、消除、下落填充等。
+ * 尺寸和宝石种类数为模板参数，循环边界与掩码宽度在编译期确定；
+ * 标准尺寸见 GameMap 类型别名，常用尺寸在 GameMap.cpp 中显式实例化
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
  */
-class GameMap {
+template <int Rows, int Cols, int Kinds> class BasicGameMap {
+  static_assert(Rows >= 3 && Cols >= 3, "棋盘至少 3x3");
+  static_assert(Rows <= 32 && Cols <= 32, "脏行/脏列位集为 32 位");
+  static_assert(Kinds >= 3 && Kinds <= GEM_KIND, "宝石种类超出范围");
+
 public:
+  static const int ROWS = Rows;   ///< 行数
+  static const int COLS = Cols;   ///< 列数
+  static const int KINDS = Kinds; ///< 宝石种类数
+
+  typedef BasicBitBoard<Rows, Cols, Kinds> Board; ///< 对应尺寸的位棋盘
+  typedef typename Board::Mask Mask;              ///< 对应尺寸的格子掩码
+
+  typedef FixedVector<CellPos, Rows * Cols> CellList; ///< 免分配的坐标缓冲
+  typedef FixedVector<Move, 2 * Rows * Cols> MoveList; ///< 免分配的交换缓冲
+
+  /**
+   * @brief 棋盘快照
+   * 颜色字节数组、待消除位平面、位棋盘与哈希的原样拷贝，保存与恢复都是整块复制，
+   * 供搜索程序在同一局面上反复试探
+   */
+  struct Snapshot {
+    GemType types[Rows][Cols]; ///< 各格颜色
+    Mask matched;              ///< 待消除位平面
+    Board bits;                ///< 位棋盘
+    uint64_t hash;             ///< 局面哈希
+    uint64_t mirrorHash;       ///< 左右镜像局面的哈希
+  };
+
+  /**
+   * @brief 随机流状态
+   * 主随机流与各列补充流的完整状态，与棋盘一起即可从任意时刻继续确定性模拟
+   */
+  struct RandomState {
+    uint64_t main[4];          ///< 主随机流
+    uint64_t columns[Cols][4]; ///< 各列补充流
+  };
+
   /**
    * @brief 构造函数
-   * 初始化随机数种子和游戏分数
+   * 初始化随机数生成器和游戏分数
+   * @param seed 随机种子，相同种子生成相同的地图与补充序列
+   */
+  explicit BasicGameMap(uint64_t seed = Random::entropySeed());
+
+  /**
+   * @brief 重新设定随机种子
+   * 同时重建主随机流和各列补充流
+   * @param seed 随机种子
+   */
+  void setSeed(uint64_t seed);
+
+  /**
+   * @brief 获取当前随机种子
+   * @return 最近一次设定的种子
+   */
+  uint64_t seed() const;
+
+  /**
+   * @brief 设置是否使用分列补充流
+   * 开启后每列下落补充的新宝石取自该列独立的随机流，
+   * 某一列的补充序列不受其他列消除次数的影响，便于对比模拟
+   * @param enabled true 表示开启
    */
-  GameMap();
+  void setColumnStreams(bool enabled);
+
+  /**
+   * @brief 是否使用分列补充流
+   * @return true 表示开启
+   */
+  bool columnStreams() const;
+
+  /**
+   * @brief 设置下落补充策略
+   * REFILL_PLAYABLE 下 applyGravity 保证稳定后的地图仍有合法交换，
+   * 不再需要整板重置
+   * @param policy 补充策略
+   */
+  void setRefillPolicy(RefillPolicy policy);
+
+  /**
+   * @brief 获取下落补充策略
+   * @return 补充策略
+   */
+  RefillPolicy refillPolicy() const;
+
+  /**
+   * @brief 获取主随机流
+   * 供模拟程序派生更多独立流（例如 rng().split()）
+   * @return 随机数生成器引用
+   */
+  Random &rng();
+
+  /**
+   * @brief 保存随机流状态
+   * @param state 输出状态
+   */
+  void saveRandomState(RandomState &state) const;
+
+  /**
+   * @brief 恢复随机流状态
+   * 不改变 seed() 的返回值
+   * @param state 状态
+   */
+  void loadRandomState(const RandomState &state);
 
   /**
    * @brief 获取指定位置宝石的分值
@@ -34,11 +143,23 @@ public:
    */
   GemType getGemType(int r, int c) const;
 
+  /**
+   * @brief 放置宝石
+   * 直接改写指定格子（清除其待消除标记），供回放关键帧、关卡布局等恢复棋盘使用；
+   * 与其他修改一样登记撤销日志并维护位棋盘与哈希。坐标无效时不做任何事
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param type 宝石类型
+   */
+  void setGemType(int r, int c, GemType type);
+
   /**
    * @brief 初始化地图
-   * 随机填充宝石，并保证初始状态下没有可直接消除的组合
+   * 逐格构造：每格只从不会与已放置的邻居组成三连的颜色中随机选取，
+   * 单遍即保证初始状态下没有可直接消除的组合
+   * @param ensureMove 为 true 时保证至少存在一个合法交换
    */
-  void init();
+  void init(bool ensureMove = true);
 
   /**
    * @brief 交换两个宝石 (数据层面的交换)
@@ -47,22 +168,127 @@ public:
 
   /**
    * @brief 检查全图是否有可消除项
+   * 只重新扫描经过脏格子的行和列，结果与全图扫描一致
    * @return 返回所有需要消除的坐标点集合
    */
-  std::vector<QPoint> checkMatches();
+  std::vector<CellPos> checkMatches();
+
+  /**
+   * @brief 检查全图是否有可消除项（写入调用方缓冲）
+   * 与 checkMatches() 相同，但不分配内存
+   * @param cells 输出坐标集合（先清空再写入）
+   * @return 匹配格子数
+   */
+  int checkMatches(CellList &cells);
+
+  /**
+   * @brief 增量匹配检测
+   * 与 checkMatches() 相同，直接返回掩码
+   * @return 匹配格子的位掩码
+   */
+  Mask checkMatchMask();
+
+  /**
+   * @brief 是否存在可消除项
+   * 没有脏行列时直接返回；否则用位棋盘内核，找到第一处三连即返回
+   * @return true 表示存在匹配
+   */
+  bool hasAnyMatch();
+
+  /**
+   * @brief 计算掩码内宝石的总分
+   * @param mask 格子掩码
+   * @return 总分
+   */
+  int maskScore(Mask mask) const;
+
+  /**
+   * @brief 位棋盘匹配检测
+   * 不生成坐标集合，直接返回匹配掩码，供高频调用方使用
+   * @return 匹配格子的位掩码（第 r*Cols+c 位对应第 r 行第 c 列）
+   */
+  Mask matchMask() const;
+
+  /**
+   * @brief 获取位棋盘（只读）
+   * 供批量评估等需要按颜色掩码读取整张地图的调用方使用
+   * @return 位棋盘引用
+   */
+  const Board &bitBoard() const;
 
   /**
    * @brief 执行消除
    * @param points 要消除的坐标集合,将这些位置设为 EMPTY
    */
-  void eliminate(const std::vector<QPoint> &points);
+  void eliminate(const std::vector<CellPos> &points);
+
+  /**
+   * @brief 按掩码执行消除
+   * 位棋盘与待消除位平面按整字更新，颜色数组只改写被消除的格子
+   * @param mask 要消除的格子掩码（通常来自 matchMask()）
+   */
+  void eliminate(Mask mask);
+
+  /**
+   * @brief 获取待消除标记
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return true 表示该格在最近一次消除中被清空
+   */
+  bool isMatched(int r, int c) const;
+
+  /**
+   * @brief 获取局面哈希
+   * Zobrist 哈希，随每次格子改写增量维护，只由各格颜色决定
+   * @return 哈希值
+   */
+  uint64_t hash() const;
+
+  /**
+   * @brief 获取左右镜像局面的哈希
+   * 与把各列左右翻转后的地图的 hash() 相等
+   * @return 哈希值
+   */
+  uint64_t mirrorHash() const;
+
+  /**
+   * @brief 获取规范哈希
+   * 匹配与下落规则左右对称，互为镜像的两个局面价值相同，
+   * 取 hash() 与 mirrorHash() 中较小者，使二者落到同一个置换表条目
+   * @param mirrored 可选，输出规范形式是否为镜像局面
+   * @return 哈希值
+   */
+  uint64_t canonicalHash(bool *mirrored = nullptr) const;
+
+  /**
+   * @brief 保存棋盘快照
+   * 只复制棋盘数据，不含随机流与撤销历史
+   * @param snapshot 输出快照
+   */
+  void saveSnapshot(Snapshot &snapshot) const;
+
+  /**
+   * @brief 恢复棋盘快照
+   * 有打开的撤销步骤时，被改变的格子会登记到撤销日志
+   * @param snapshot 快照
+   */
+  void loadSnapshot(const Snapshot &snapshot);
 
   /**
    * @brief 下落填充算法
-   * 让上方宝石下落填补空缺，顶部生成随机新宝石
+   * 让上方宝石下落填补空缺，顶部生成随机新宝石。
+   * REFILL_PLAYABLE 策略下，若补充后地图稳定却无合法交换，
+   * 则重抽补充的宝石；仍不行时原地洗牌，最后才重新构造
    */
   void applyGravity();
 
+  /**
+   * @brief 原地洗牌
+   * 保留现有宝石（每种颜色数量不变），重新排列为无匹配且有合法交换的布局
+   * @return true 表示洗牌成功，false 表示有限次尝试内未找到可用排列（地图未改变）
+   */
+  bool shuffle();
+
   /**
    * @brief 重置
    * @return true 表示重置成功
@@ -75,6 +301,34 @@ public:
    */
   bool hasPossibleMove();
 
+  /**
+   * @brief 生成所有合法交换
+   * 直接用邻域模板匹配局部图案，不做实际交换与重扫。
+   * 针对稳定（无现成匹配）的地图：交换后至少一颗被移动的宝石组成三连即为合法
+   * @param moves 输出交换列表（先清空再写入）
+   */
+  void findMoves(std::vector<Move> &moves) const;
+
+  /**
+   * @brief 生成所有合法交换
+   * @return 交换列表
+   */
+  std::vector<Move> findMoves() const;
+
+  /**
+   * @brief 生成所有合法交换（写入调用方缓冲）
+   * @param moves 输出交换列表（先清空再写入）
+   * @return 合法交换数
+   */
+  int findMoves(MoveList &moves) const;
+
+  /**
+   * @brief 快速死局检测
+   * 与 findMoves 使用同一套模板，找到第一个合法交换即返回
+   * @return true 表示存在合法交换
+   */
+  bool hasAnyMove() const;
+
   /**
    * @brief 撤销
    * @return true 表示撤销成功
@@ -91,14 +345,14 @@ public:
 
   /**
    * @brief 保存当前状态
-   * 将当前地图和分数保存到历史记录栈中，用于撤销操作
+   * 开始记录新的一步：之后被改写的格子在首次改写时登记原值，用于撤销操作
    * @param currentScore 当前游戏分数
    */
   void saveCurState(int currentScore);
 
   /**
    * @brief 移除最后一个状态
-   * 从历史记录栈中移除无效的状态
+   * 从历史记录中移除无效的状态，其间的改动并入上一步
    */
   void popLastState();
 
@@ -116,26 +370,169 @@ public:
 
   /**
    * @brief 清除历史记录
-   * 清空撤销历史栈并重置撤销分数
+   * 清空撤销历史并重置撤销分数
    */
   void clearHistory();
 
+  /**
+   * @brief 设置撤销历史的内存预算
+   * 超出预算时丢弃最旧的步骤
+   * @param bytes 字节数，默认 UndoJournal::DEFAULT_BUDGET
+   */
+  void setHistoryBudget(size_t bytes);
+
+  /**
+   * @brief 获取当前可撤销的步数
+   * @return 步数
+   */
+  size_t historyDepth() const;
+
 private:
-  Gem m_map[ROW][COL]; ///< 游戏地图的二维数组
+  GemType m_types[Rows][Cols]; ///< 各格颜色，行优先的连续字节
+  Mask m_matched;              ///< 待消除位平面
+  Board m_bits;                ///< 与 m_types 同步的位棋盘，用于匹配检测
+  uint64_t m_hash;             ///< 局面哈希
+  uint64_t m_mirrorHash;       ///< 左右镜像局面的哈希
 
   /**
-   * @brief 游戏步骤结构体
-   * 用于保存游戏的历史状态，包括地图快照和分数快照
+   * @brief 读取格子
+   * 由颜色字节与待消除位平面组装出打包的宝石
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 宝石
    */
-  struct Step {
-    Gem mapSnapshot[ROW][COL]; ///< 地图快照
-    int scoreSnapshot;         ///< 分数快照
-  };
+  Gem gemAt(int r, int c) const;
+
+  /**
+   * @brief 写入格子
+   * 所有对地图的修改都经由此函数，保证颜色数组、待消除位平面、m_bits 与哈希同步
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param gem 新的宝石
+   */
+  void setCell(int r, int c, const Gem &gem);
+
+  /**
+   * @brief 异或进（或异或掉）一个格子的哈希键
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param type 宝石类型，EMPTY 的键为 0
+   */
+  void toggleHash(int r, int c, GemType type);
+
+  uint64_t m_seed;             ///< 最近一次设定的随机种子
+  Random m_rng;                ///< 主随机流（初始化、默认补充）
+  Random m_columnRngs[Cols];   ///< 各列独立的补充流
+  bool m_useColumnStreams;     ///< 是否使用分列补充流
+  RefillPolicy m_refillPolicy; ///< 下落补充策略
+
+  /**
+   * @brief 从主随机流生成随机宝石
+   * @return 随机宝石类型（1 ~ Kinds）
+   */
+  GemType randomGem();
+
+  /**
+   * @brief 计算 (r,c) 不能放置的颜色
+   * 检查经过该格的 6 组相邻格对（左二、右二、上二、下二、左右、上下），
+   * 已放置且同色的格对排除该颜色
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 位集，第 k 位表示排除颜色 k
+   */
+  unsigned bannedColors(int r, int c) const;
+
+  /**
+   * @brief 为 (r,c) 选取不会组成三连的随机颜色
+   * 在 bannedColors 之外的颜色中均匀选取
+   * @param r 行坐标
+   * @param c 列坐标
+   * @return 宝石类型
+   */
+  GemType safeGem(int r, int c);
+
+  /**
+   * @brief 构造式填充整张地图
+   * @param plantMove 为 true 时先在首行（或首列）埋入一个“A _ A A”形的合法交换
+   */
+  void fillBoard(bool plantMove);
+
+  /**
+   * @brief 生成第 c 列补充的新宝石
+   * @param c 列坐标
+   * @return 随机宝石类型
+   */
+  GemType refillGem(int c);
+
+  // 全部行/列置位的脏标记；用右移构造，Rows、Cols 为 32 时不会移出 32 位
+  static const uint32_t ALL_DIRTY_ROWS = ~uint32_t(0) >> (32 - Rows);
+  static const uint32_t ALL_DIRTY_COLS = ~uint32_t(0) >> (32 - Cols);
+
+  uint32_t m_dirtyRows; ///< 脏行位集，第 r 位表示第 r 行自上次稳定以来有宝石写入
+  uint32_t m_dirtyCols; ///< 脏列位集，第 c 位表示第 c 列自上次稳定以来有宝石写入
+
+  /**
+   * @brief 增量匹配检测
+   * 仅扫描脏行、脏列；脏线过多时退回位棋盘全图内核。
+   * 未脏的行/列在上次稳定时没有匹配且之后未被写入，因此结果与全图扫描相同。
+   * 结果为空时说明全图稳定，清空脏标记
+   * @return 匹配掩码
+   */
+  Mask incrementalMatchMask();
+
+  /**
+   * @brief 模板匹配
+   * 判断 type 颜色的宝石沿方向 dir 移入 (r,c) 后能否组成三连
+   * @param type 移入的宝石类型
+   * @param r 目标行坐标
+   * @param c 目标列坐标
+   * @param dir 移动方向（MoveDir）
+   * @return true 表示能组成三连
+   */
+  bool formsLineAt(GemType type, int r, int c, int dir) const;
+
+  /**
+   * @brief 判断 (r,c) 与右侧或下方相邻格交换是否合法
+   * @param r 行坐标
+   * @param c 列坐标
+   * @param dir DIR_RIGHT 或 DIR_DOWN
+   * @return true 表示合法
+   */
+  bool isLegalSwap(int r, int c, int dir) const;
+
+  /**
+   * @brief 按行列顺序追加所有合法交换
+   * 各 findMoves 重载共用的扫描
+   * @tparam Out 提供 clear() 与 push_back(Move) 的容器
+   * @param moves 输出交换列表（先清空）
+   */
+  template <class Out> void collectMoves(Out &moves) const;
+
+  /**
+   * @brief 扫描单行的横向连续匹配
+   * @param r 行坐标
+   * @return 该行匹配格子的位掩码
+   */
+  Mask scanRow(int r) const;
+
+  /**
+   * @brief 扫描单列的纵向连续匹配
+   * @param c 列坐标
+   * @return 该列匹配格子的位掩码
+   */
+  Mask scanCol(int c) const;
 
   int m_currentScore;  ///< 当前游戏分数
   int m_lastUndoScore; ///< 最近一次撤销的分数
 
-  std::stack<Step> m_historyStack; ///< 历史记录栈，保存游戏的历史状态
+  UndoJournal<Rows * Cols> m_history; ///< 增量撤销日志，只记录每步改写的格子
 };
 
+// 常用尺寸在 GameMap.cpp 中显式实例化，其他翻译单元不再隐式实例化
+extern template class BasicGameMap<8, 8, GEM_KIND>;
+extern template class BasicGameMap<9, 9, GEM_KIND>;
+extern template class BasicGameMap<10, 10, GEM_KIND>;
+
+typedef BasicGameMap<ROW, COL, GEM_KIND> GameMap; ///< 标准尺寸游戏地图
+
 #endif // GAMEMAP_H
@@ -0,0 +1,960 @@
+#ifndef GAMEMAPIMPL_H
+#define GAMEMAPIMPL_H
+
+// BasicGameMap 模板的成员实现。
+// 常用尺寸已在 GameMap.cpp 中显式实例化；其他尺寸的使用方需包含本文件
+
+#include "GameMap.h"
+#include "MovePatterns.h"
+#include <cstring>
+
+/**
+ * @brief GameMap构造函数实现
+ * 初始化随机数生成器和撤销分数
+ * @param seed 随机种子
+ */
+template <int Rows, int Cols, int Kinds>
+BasicGameMap<Rows, Cols, Kinds>::BasicGameMap(uint64_t seed)
+    : m_types(), m_matched(), m_hash(ZOBRIST_EMPTY_BOARD),
+      m_mirrorHash(ZOBRIST_EMPTY_BOARD), m_useColumnStreams(false),
+      m_refillPolicy(REFILL_RANDOM),
+      m_dirtyRows(ALL_DIRTY_ROWS), m_dirtyCols(ALL_DIRTY_COLS),
+      m_currentScore(0), m_lastUndoScore(0) {
+  setSeed(seed);
+}
+
+/**
+ * @brief 设定随机种子实现
+ * 各列补充流从主流的 longJump 位置依次 split，保证与主流及彼此不重叠
+ * @param seed 随机种子
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setSeed(uint64_t seed) {
+  m_seed = seed;
+  m_rng.setSeed(seed);
+  Random columnBase(seed);
+  columnBase.longJump();
+  for (int c = 0; c < Cols; c++) {
+    m_columnRngs[c] = columnBase.split();
+  }
+}
+
+// 获取当前随机种子
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicGameMap<Rows, Cols, Kinds>::seed() const { return m_seed; }
+
+// 设置是否使用分列补充流
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setColumnStreams(bool enabled) {
+  m_useColumnStreams = enabled;
+}
+
+// 是否使用分列补充流
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::columnStreams() const {
+  return m_useColumnStreams;
+}
+
+// 设置下落补充策略
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setRefillPolicy(RefillPolicy policy) {
+  m_refillPolicy = policy;
+}
+
+// 获取下落补充策略
+template <int Rows, int Cols, int Kinds>
+RefillPolicy BasicGameMap<Rows, Cols, Kinds>::refillPolicy() const {
+  return m_refillPolicy;
+}
+
+// 获取主随机流
+template <int Rows, int Cols, int Kinds>
+Random &BasicGameMap<Rows, Cols, Kinds>::rng() { return m_rng; }
+
+/**
+ * @brief 保存随机流状态实现
+ * @param state 输出状态
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::saveRandomState(
+    RandomState &state) const {
+  m_rng.getState(state.main);
+  for (int c = 0; c < Cols; c++) {
+    m_columnRngs[c].getState(state.columns[c]);
+  }
+}
+
+/**
+ * @brief 恢复随机流状态实现
+ * @param state 状态
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::loadRandomState(
+    const RandomState &state) {
+  m_rng.setState(state.main);
+  for (int c = 0; c < Cols; c++) {
+    m_columnRngs[c].setState(state.columns[c]);
+  }
+}
+
+/**
+ * @brief 生成随机宝石实现
+ * @return 随机宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+GemType BasicGameMap<Rows, Cols, Kinds>::randomGem() {
+  return static_cast<GemType>(m_rng.bounded(Kinds) + 1);
+}
+
+/**
+ * @brief 生成补充宝石实现
+ * @param c 列坐标
+ * @return 随机宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+GemType BasicGameMap<Rows, Cols, Kinds>::refillGem(int c) {
+  if (m_useColumnStreams) {
+    return static_cast<GemType>(m_columnRngs[c].bounded(Kinds) + 1);
+  }
+  return randomGem();
+}
+
+/**
+ * @brief 获取指定位置宝石的分值
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 宝石的分值，如果坐标无效返回0
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::getGemScore(int r, int c) const {
+  if (!isValid(r, c))
+    return 0;
+  return GEM_SCORES[static_cast<int>(m_types[r][c])];
+}
+
+/**
+ * @brief 获取宝石类型实现
+ * 返回指定位置的宝石类型，如果坐标无效则返回EMPTY
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+GemType BasicGameMap<Rows, Cols, Kinds>::getGemType(int r, int c) const {
+  if (!isValid(r, c)) {
+    // 如果越界，返回空值
+    return EMPTY;
+  }
+  // 返回实际类型
+  return m_types[r][c];
+}
+
+/**
+ * @brief 放置宝石实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @param type 宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setGemType(int r, int c, GemType type) {
+  if (!isValid(r, c)) {
+    return;
+  }
+  setCell(r, c, Gem(type));
+}
+
+/**
+ * @brief 初始化地图实现
+ * 先做一遍构造式填充；极少数情况下没有合法交换，
+ * 则再填充一遍并埋入一个合法交换，最多两遍
+ * @param ensureMove 是否保证存在合法交换
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::init(bool ensureMove) {
+  fillBoard(false);
+  if (ensureMove && !hasAnyMove()) {
+    fillBoard(true);
+  }
+}
+
+/**
+ * @brief 构造式填充实现
+ * 先清空地图，空格视为未放置；按行优先顺序逐格选色。
+ * 埋入的图案只放在首行或首列，其上方、左侧没有已放置的格子，
+ * 因此每格最多被排除 2 种颜色，Kinds >= 3 时总有可选颜色
+ * @param plantMove 是否埋入合法交换
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::fillBoard(bool plantMove) {
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      setCell(r, c, Gem(EMPTY));
+    }
+  }
+
+  // 图案 A _ A A：空位与左侧的 A 交换后组成三连，空位由 safeGem 保证不是 A
+  if (plantMove && (Rows >= 4 || Cols >= 4)) {
+    const Gem a(randomGem());
+    const bool horizontal = Cols >= 4 && (Rows < 4 || m_rng.bounded(2) == 0);
+    if (horizontal) {
+      const int c = static_cast<int>(m_rng.bounded(Cols - 3));
+      setCell(0, c, a);
+      setCell(0, c + 2, a);
+      setCell(0, c + 3, a);
+    } else {
+      const int r = static_cast<int>(m_rng.bounded(Rows - 3));
+      setCell(r, 0, a);
+      setCell(r + 2, 0, a);
+      setCell(r + 3, 0, a);
+    }
+  }
+
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      if (m_types[r][c] == EMPTY) {
+        setCell(r, c, Gem(safeGem(r, c)));
+      }
+    }
+  }
+}
+
+/**
+ * @brief 计算排除颜色实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 排除颜色位集
+ */
+template <int Rows, int Cols, int Kinds>
+unsigned BasicGameMap<Rows, Cols, Kinds>::bannedColors(int r, int c) const {
+  static constexpr Offset kLinePairs[6][2] = {
+      {{0, -2}, {0, -1}}, {{0, 1}, {0, 2}}, {{0, -1}, {0, 1}},
+      {{-2, 0}, {-1, 0}}, {{1, 0}, {2, 0}}, {{-1, 0}, {1, 0}}};
+
+  unsigned banned = 0;
+  for (const auto &pair : kLinePairs) {
+    // 越界或未放置时 getGemType 返回 EMPTY，不参与排除
+    const GemType a = getGemType(r + pair[0].dr, c + pair[0].dc);
+    if (a != EMPTY && a == getGemType(r + pair[1].dr, c + pair[1].dc)) {
+      banned |= 1u << a;
+    }
+  }
+  return banned;
+}
+
+/**
+ * @brief 选取安全颜色实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+GemType BasicGameMap<Rows, Cols, Kinds>::safeGem(int r, int c) {
+  const unsigned banned = bannedColors(r, c);
+  const int allowed = Kinds - maskPopCount(static_cast<uint32_t>(banned));
+  if (allowed <= 0) {
+    return randomGem(); // 按填充顺序不会发生，仅作保护
+  }
+  int pick = static_cast<int>(m_rng.bounded(allowed));
+  for (int k = 1; k <= Kinds; k++) {
+    if (!(banned & (1u << k)) && pick-- == 0) {
+      return static_cast<GemType>(k);
+    }
+  }
+  return randomGem();
+}
+
+/**
+ * @brief 交换两个宝石实现
+ * 在数据层面交换两个指定位置的宝石
+ * @param r1 第一个宝石的行坐标
+ * @param c1 第一个宝石的列坐标
+ * @param r2 第二个宝石的行坐标
+ * @param c2 第二个宝石的列坐标
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::swap(int r1, int c1, int r2, int c2) {
+  // 检查坐标是否有效
+  if (!isValid(r1, c1) || !isValid(r2, c2)) {
+    return;
+  }
+
+  // 交换两个宝石的位置
+  Gem temp = gemAt(r1, c1);
+  setCell(r1, c1, gemAt(r2, c2));
+  setCell(r2, c2, temp);
+}
+
+/**
+ * @brief 检查全图匹配实现
+ * 由增量检测得到匹配掩码，再转换为坐标集合
+ * 检测游戏地图中所有可以消除的宝石组合（横向或纵向连续3个及以上相同宝石）
+ * @return 返回所有需要消除的宝石坐标集合
+ */
+template <int Rows, int Cols, int Kinds>
+std::vector<CellPos> BasicGameMap<Rows, Cols, Kinds>::checkMatches() {
+  std::vector<CellPos> matches;
+  Board::maskToPoints(incrementalMatchMask(), matches);
+  return matches;
+}
+
+/**
+ * @brief 检查全图匹配实现（调用方缓冲）
+ * @param cells 输出坐标集合
+ * @return 匹配格子数
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::checkMatches(CellList &cells) {
+  cells.clear();
+  Board::maskToPoints(incrementalMatchMask(), cells);
+  return cells.size();
+}
+
+// 增量匹配检测，返回掩码
+template <int Rows, int Cols, int Kinds>
+typename BasicGameMap<Rows, Cols, Kinds>::Mask
+BasicGameMap<Rows, Cols, Kinds>::checkMatchMask() {
+  return incrementalMatchMask();
+}
+
+/**
+ * @brief 是否存在可消除项实现
+ * 无匹配时与增量检测一样清空脏标记
+ * @return true 表示存在匹配
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::hasAnyMatch() {
+  if (m_dirtyRows == 0 && m_dirtyCols == 0) {
+    return false;
+  }
+  if (m_bits.hasMatch()) {
+    return true;
+  }
+  m_dirtyRows = 0;
+  m_dirtyCols = 0;
+  return false;
+}
+
+// 计算掩码内宝石的总分
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::maskScore(Mask mask) const {
+  return m_bits.score(mask);
+}
+
+/**
+ * @brief 增量匹配检测实现
+ * 脏行数 + 脏列数较多时，整板位运算比逐线扫描更快，直接退回全图内核
+ * @return 匹配掩码
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicGameMap<Rows, Cols, Kinds>::Mask
+BasicGameMap<Rows, Cols, Kinds>::incrementalMatchMask() {
+  if (m_dirtyRows == 0 && m_dirtyCols == 0) {
+    return Mask(); // 自上次稳定以来没有写入
+  }
+
+  Mask mask = Mask();
+  if (maskPopCount(m_dirtyRows) + maskPopCount(m_dirtyCols) >
+      (Rows + Cols) / 2) {
+    mask = m_bits.matchMask();
+  } else {
+    for (uint32_t rows = m_dirtyRows; rows; rows &= rows - 1) {
+      mask |= scanRow(maskLowestBit(rows));
+    }
+    for (uint32_t cols = m_dirtyCols; cols; cols &= cols - 1) {
+      mask |= scanCol(maskLowestBit(cols));
+    }
+  }
+
+  if (!mask) {
+    // 全图稳定，之后只需关注新的写入
+    m_dirtyRows = 0;
+    m_dirtyCols = 0;
+  }
+  return mask;
+}
+
+/**
+ * @brief 单行扫描实现，滑动窗口算法
+ * @param r 行坐标
+ * @return 该行匹配掩码
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicGameMap<Rows, Cols, Kinds>::Mask
+BasicGameMap<Rows, Cols, Kinds>::scanRow(int r) const {
+  Mask mask = Mask();
+  int start = 0;
+  while (start < Cols) {
+    int end = start + 1;
+    // 找到连续相同的宝石
+    while (end < Cols && m_types[r][end] != EMPTY &&
+           m_types[r][end] == m_types[r][start]) {
+      end++;
+    }
+    // 如果连续数量>=3，则加入掩码
+    if (end - start >= 3) {
+      for (int c = start; c < end; c++) {
+        mask |= Board::cellBit(Board::bitIndex(r, c));
+      }
+    }
+    start = end;
+  }
+  return mask;
+}
+
+/**
+ * @brief 单列扫描实现，滑动窗口算法
+ * @param c 列坐标
+ * @return 该列匹配掩码
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicGameMap<Rows, Cols, Kinds>::Mask
+BasicGameMap<Rows, Cols, Kinds>::scanCol(int c) const {
+  Mask mask = Mask();
+  int start = 0;
+  while (start < Rows) {
+    int end = start + 1;
+    while (end < Rows && m_types[end][c] != EMPTY &&
+           m_types[end][c] == m_types[start][c]) {
+      end++;
+    }
+    if (end - start >= 3) {
+      for (int r = start; r < end; r++) {
+        mask |= Board::cellBit(Board::bitIndex(r, c));
+      }
+    }
+    start = end;
+  }
+  return mask;
+}
+
+/**
+ * @brief 位棋盘匹配检测实现
+ * @return 匹配掩码
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicGameMap<Rows, Cols, Kinds>::Mask
+BasicGameMap<Rows, Cols, Kinds>::matchMask() const {
+  return m_bits.matchMask();
+}
+
+// 获取位棋盘
+template <int Rows, int Cols, int Kinds>
+const typename BasicGameMap<Rows, Cols, Kinds>::Board &
+BasicGameMap<Rows, Cols, Kinds>::bitBoard() const {
+  return m_bits;
+}
+
+/**
+ * @brief 执行消除实现
+ * 将指定坐标的宝石消除（设为EMPTY），并标记为已匹配
+ * @param points 需要消除的宝石坐标集合
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::eliminate(
+    const std::vector<CellPos> &points) {
+  // 遍历所有匹配的宝石位置
+  for (const auto &point : points) {
+    int r = point.row;
+    int c = point.col;
+
+    // 检查位置是否有效
+    if (isValid(r, c)) {
+      // 将宝石类型设置为空，并标记为已匹配
+      Gem gem(EMPTY);
+      gem.isMatched = true;
+      setCell(r, c, gem);
+    }
+  }
+}
+
+/**
+ * @brief 按掩码消除实现
+ * 撤销日志打开时逐格登记原值；随后整字清除各颜色掩码并置位待消除平面
+ * @param mask 要消除的格子掩码
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::eliminate(Mask mask) {
+  for (Mask rest = mask; rest; rest = maskClearLowest(rest)) {
+    const int i = maskLowestBit(rest);
+    if (m_history.isOpen()) {
+      m_history.record(i, gemAt(i / Cols, i % Cols));
+    }
+    toggleHash(i / Cols, i % Cols, m_types[i / Cols][i % Cols]);
+    m_types[i / Cols][i % Cols] = EMPTY;
+  }
+  m_bits.clearMask(mask);
+  m_matched |= mask;
+}
+
+/**
+ * @brief 获取待消除标记实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 待消除标记，坐标无效返回 false
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::isMatched(int r, int c) const {
+  return isValid(r, c) &&
+         bool(m_matched & Board::cellBit(Board::bitIndex(r, c)));
+}
+
+// 获取局面哈希
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicGameMap<Rows, Cols, Kinds>::hash() const {
+  return m_hash;
+}
+
+// 获取镜像局面哈希
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicGameMap<Rows, Cols, Kinds>::mirrorHash() const {
+  return m_mirrorHash;
+}
+
+/**
+ * @brief 获取规范哈希实现
+ * @param mirrored 可选，输出规范形式是否为镜像局面
+ * @return 哈希值
+ */
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicGameMap<Rows, Cols, Kinds>::canonicalHash(bool *mirrored) const {
+  const bool useMirror = m_mirrorHash < m_hash;
+  if (mirrored) {
+    *mirrored = useMirror;
+  }
+  return useMirror ? m_mirrorHash : m_hash;
+}
+
+/**
+ * @brief 保存快照实现
+ * @param snapshot 输出快照
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::saveSnapshot(Snapshot &snapshot) const {
+  std::memcpy(snapshot.types, m_types, sizeof(m_types));
+  snapshot.matched = m_matched;
+  snapshot.bits = m_bits;
+  snapshot.hash = m_hash;
+  snapshot.mirrorHash = m_mirrorHash;
+}
+
+/**
+ * @brief 恢复快照实现
+ * 快照与当前局面无从比较，恢复后全部行列视为脏
+ * @param snapshot 快照
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::loadSnapshot(const Snapshot &snapshot) {
+  if (m_history.isOpen()) {
+    for (int i = 0; i < Rows * Cols; i++) {
+      m_history.record(i, gemAt(i / Cols, i % Cols));
+    }
+  }
+  std::memcpy(m_types, snapshot.types, sizeof(m_types));
+  m_matched = snapshot.matched;
+  m_bits = snapshot.bits;
+  m_hash = snapshot.hash;
+  m_mirrorHash = snapshot.mirrorHash;
+  m_dirtyRows = ALL_DIRTY_ROWS;
+  m_dirtyCols = ALL_DIRTY_COLS;
+}
+
+/**
+ * @brief 下落填充算法实现
+ * 处理消除宝石后的下落填充逻辑：让上方的宝石下落填补空缺，顶部生成随机新宝石
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::applyGravity() {
+  int spawned[Cols]; // 各列顶部新生成的宝石数
+
+  // 从下往上、从左往右遍历，拆分八个列
+  for (int c = 0; c < Cols; c++) {
+    int emptyCount = 0;
+
+    // 从底部开始往上遍历
+    for (int r = Rows - 1; r >= 0; r--) {
+      if (m_types[r][c] == EMPTY) {
+        // 遇到空位，计数加1
+        emptyCount++;
+      } else if (emptyCount > 0) {
+        // 遇到非空位且下方有空位，将宝石移动到下方
+        setCell(r + emptyCount, c, gemAt(r, c));
+        setCell(r, c, Gem(EMPTY));
+      }
+    }
+
+    // 顶部的空位随机生成新宝石
+    for (int r = 0; r < emptyCount; r++) {
+      setCell(r, c, Gem(refillGem(c)));
+    }
+    spawned[c] = emptyCount;
+  }
+
+  if (m_refillPolicy != REFILL_PLAYABLE) {
+    return;
+  }
+
+  // 有新匹配时会继续连锁，由下一次下落再检查；只处理稳定且无步可走的情况。
+  // 先重抽新生成的宝石，不动原有宝石
+  const int kRerollAttempts = 8;
+  for (int attempt = 0; attempt < kRerollAttempts; attempt++) {
+    if (matchMask() || hasAnyMove()) {
+      return;
+    }
+    for (int c = 0; c < Cols; c++) {
+      for (int r = 0; r < spawned[c]; r++) {
+        setCell(r, c, Gem(refillGem(c)));
+      }
+    }
+  }
+  if (matchMask() || hasAnyMove() || shuffle()) {
+    return;
+  }
+  fillBoard(true); // 现有宝石无法排出可用布局，重新构造
+}
+
+/**
+ * @brief 原地洗牌实现
+ * 统计各颜色数量后清空地图，按行优先逐格从剩余宝石中抽取，
+ * 优先抽不会组成三连的颜色；结果无匹配且有合法交换才接受，
+ * 有限次尝试失败则恢复原布局
+ * @return true 表示洗牌成功
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::shuffle() {
+  Gem original[Rows][Cols];
+  int counts[Kinds + 1] = {0}; // 下标 0 统计空格，不参与抽取
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      original[r][c] = gemAt(r, c);
+      counts[m_types[r][c]]++;
+    }
+  }
+
+  const int kShuffleAttempts = 8;
+  for (int attempt = 0; attempt < kShuffleAttempts; attempt++) {
+    int pool[Kinds + 1];
+    for (int k = 0; k <= Kinds; k++) {
+      pool[k] = counts[k];
+    }
+    for (int r = 0; r < Rows; r++) {
+      for (int c = 0; c < Cols; c++) {
+        setCell(r, c, Gem(EMPTY));
+      }
+    }
+
+    for (int r = 0; r < Rows; r++) {
+      for (int c = 0; c < Cols; c++) {
+        if (original[r][c].type == EMPTY) {
+          continue; // 空格保持为空
+        }
+        const unsigned banned = bannedColors(r, c);
+        int safe = 0;
+        int total = 0;
+        for (int k = 1; k <= Kinds; k++) {
+          total += pool[k];
+          safe += (banned & (1u << k)) ? 0 : pool[k];
+        }
+        // 按剩余数量加权抽取；没有安全颜色时退而从全部剩余中抽
+        const bool useSafe = safe > 0;
+        int pick = static_cast<int>(m_rng.bounded(useSafe ? safe : total));
+        for (int k = 1; k <= Kinds; k++) {
+          if (useSafe && (banned & (1u << k))) {
+            continue;
+          }
+          if (pick < pool[k]) {
+            pool[k]--;
+            setCell(r, c, Gem(static_cast<GemType>(k)));
+            break;
+          }
+          pick -= pool[k];
+        }
+      }
+    }
+
+    if (!matchMask() && hasAnyMove()) {
+      return true;
+    }
+  }
+
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      setCell(r, c, original[r][c]);
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 重置游戏实现
+ * 重新初始化地图，生成新的、保证有合法交换的宝石布局
+ * @return true表示重置成功
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::reset() {
+  init();
+  return true;
+}
+
+/**
+ * @brief 死局检测实现
+ * 检查游戏中是否还有可能的有效移动（交换相邻宝石后能产生匹配）
+ * @return true表示还有可移动的宝石，false表示死局
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::hasPossibleMove() { return hasAnyMove(); }
+
+/**
+ * @brief 模板匹配实现
+ * @param type 移入的宝石类型
+ * @param r 目标行坐标
+ * @param c 目标列坐标
+ * @param dir 移动方向
+ * @return true 表示能组成三连
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::formsLineAt(GemType type, int r, int c,
+                                                  int dir) const {
+  for (const PatternPair &p : kMovePatterns.pairs[dir]) {
+    // 越界时 getGemType 返回 EMPTY，与任何颜色都不相等
+    if (getGemType(r + p.a.dr, c + p.a.dc) == type &&
+        getGemType(r + p.b.dr, c + p.b.dc) == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 交换合法性判断实现
+ * (r,c) 的宝石沿 dir 移入相邻格，或相邻格的宝石反向移入 (r,c)，任一组成三连即合法
+ * @param r 行坐标
+ * @param c 列坐标
+ * @param dir DIR_RIGHT 或 DIR_DOWN
+ * @return true 表示合法
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::isLegalSwap(int r, int c, int dir) const {
+  const Offset &d = kMovePatterns.dirs[dir];
+  const int nr = r + d.dr;
+  const int nc = c + d.dc;
+  if (!isValid(nr, nc)) {
+    return false;
+  }
+  const GemType a = m_types[r][c];
+  const GemType b = m_types[nr][nc];
+  if (a == b || a == EMPTY || b == EMPTY) {
+    return false; // 同色交换无变化，空格不可交换
+  }
+  const int back = (dir == DIR_RIGHT) ? DIR_LEFT : DIR_UP;
+  return formsLineAt(a, nr, nc, dir) || formsLineAt(b, r, c, back);
+}
+
+/**
+ * @brief 追加所有合法交换实现
+ * 每对相邻格只检查一次（向右、向下）
+ * @param moves 输出交换列表
+ */
+template <int Rows, int Cols, int Kinds>
+template <class Out>
+void BasicGameMap<Rows, Cols, Kinds>::collectMoves(Out &moves) const {
+  moves.clear();
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      if (isLegalSwap(r, c, DIR_RIGHT)) {
+        moves.push_back(Move{r, c, r, c + 1});
+      }
+      if (isLegalSwap(r, c, DIR_DOWN)) {
+        moves.push_back(Move{r, c, r + 1, c});
+      }
+    }
+  }
+}
+
+/**
+ * @brief 生成所有合法交换实现
+ * @param moves 输出交换列表
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::findMoves(
+    std::vector<Move> &moves) const {
+  collectMoves(moves);
+}
+
+/**
+ * @brief 生成所有合法交换实现
+ * @return 交换列表
+ */
+template <int Rows, int Cols, int Kinds>
+std::vector<Move> BasicGameMap<Rows, Cols, Kinds>::findMoves() const {
+  std::vector<Move> moves;
+  findMoves(moves);
+  return moves;
+}
+
+/**
+ * @brief 生成所有合法交换实现（调用方缓冲）
+ * @param moves 输出交换列表
+ * @return 合法交换数
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::findMoves(MoveList &moves) const {
+  collectMoves(moves);
+  return moves.size();
+}
+
+/**
+ * @brief 快速死局检测实现
+ * @return true 表示存在合法交换
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::hasAnyMove() const {
+  for (int r = 0; r < Rows; r++) {
+    for (int c = 0; c < Cols; c++) {
+      if (isLegalSwap(r, c, DIR_RIGHT) || isLegalSwap(r, c, DIR_DOWN)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 撤销
+ * 只把最新一步改写过的格子写回原值
+ * @return true 表示撤销成功
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::undo() {
+  int score = 0;
+  if (!m_history.rollback(
+          [this](int i, const Gem &gem) { setCell(i / Cols, i % Cols, gem); },
+          score)) {
+    return false;
+  }
+
+  // 记录恢复的分数（供外部获取）
+  m_lastUndoScore = score;
+  return true;
+}
+
+/**
+ * @brief 读取格子实现
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return 宝石
+ */
+template <int Rows, int Cols, int Kinds>
+Gem BasicGameMap<Rows, Cols, Kinds>::gemAt(int r, int c) const {
+  return Gem(m_types[r][c],
+             bool(m_matched & Board::cellBit(Board::bitIndex(r, c))));
+}
+
+/**
+ * @brief 写入格子实现
+ * 同时更新二维数组和位棋盘，并登记到撤销日志；写入新的非空颜色时标记所在行列为脏
+ * （置空不会产生新的匹配，无需标记）
+ * @param r 行坐标
+ * @param c 列坐标
+ * @param gem 新的宝石
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setCell(int r, int c, const Gem &gem) {
+  if (m_history.isOpen()) {
+    m_history.record(r * Cols + c, gemAt(r, c));
+  }
+  if (gem.type != EMPTY && gem.type != m_types[r][c]) {
+    m_dirtyRows |= 1u << r;
+    m_dirtyCols |= 1u << c;
+  }
+  const Mask bit = Board::cellBit(Board::bitIndex(r, c));
+  toggleHash(r, c, m_types[r][c]);
+  toggleHash(r, c, gem.type);
+  m_types[r][c] = gem.type;
+  m_matched = (m_matched & ~bit) | (gem.isMatched ? bit : Mask());
+  m_bits.set(r, c, gem.type);
+}
+
+/**
+ * @brief 异或哈希键实现
+ * 镜像哈希使用第 Cols-1-c 列的键
+ * @param r 行坐标
+ * @param c 列坐标
+ * @param type 宝石类型
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::toggleHash(int r, int c, GemType type) {
+  const ZobristTable<Rows * Cols> &table = kZobrist<Rows * Cols>;
+  m_hash ^= table.keys[r * Cols + c][type];
+  m_mirrorHash ^= table.keys[r * Cols + (Cols - 1 - c)][type];
+}
+
+/**
+ * @brief 检查坐标有效性实现
+ * 判断指定的坐标是否在游戏地图的有效范围内
+ * @param r 行坐标
+ * @param c 列坐标
+ * @return true表示坐标有效，false表示坐标无效
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameMap<Rows, Cols, Kinds>::isValid(int r, int c) const {
+  return (r >= 0 && r < Rows && c >= 0 && c < Cols);
+}
+
+/**
+ * @brief 保存当前状态
+ * 封存上一步，开始登记新一步的改写
+ * @param currentScore 当前游戏分数（交换前的分数）
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::saveCurState(int currentScore) {
+  m_history.begin(currentScore,
+                  [this](int i) { return gemAt(i / Cols, i % Cols); });
+}
+
+/**
+ * @brief 移除最后一个状态
+ * 从历史记录中移除无效的状态
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::popLastState() {
+  m_history.discardTop();
+}
+
+// 获取最近撤销的分数
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::getLastUndoScore() const {
+  return m_lastUndoScore;
+}
+
+/**
+ * @brief 获取上一步的分数
+ * @return 上一步的分数，如果没有历史记录返回-1
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicGameMap<Rows, Cols, Kinds>::getLastStepScore() const {
+  return m_history.topScore();
+}
+
+/**
+ * @brief 清除历史记录
+ * 清空撤销历史并重置撤销分数
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::clearHistory() {
+  m_history.clear();
+  m_lastUndoScore = 0;
+}
+
+// 设置撤销历史的内存预算
+template <int Rows, int Cols, int Kinds>
+void BasicGameMap<Rows, Cols, Kinds>::setHistoryBudget(size_t bytes) {
+  m_history.setBudget(bytes);
+}
+
+// 获取当前可撤销的步数
+template <int Rows, int Cols, int Kinds>
+size_t BasicGameMap<Rows, Cols, Kinds>::historyDepth() const {
+  return m_history.depth();
+}
+
+#endif // GAMEMAPIMPL_H
@@ -0,0 +1,6 @@
+#include "GameSessionImpl.h"
+
+// 显式实例化：与 GameMap.cpp 中的地图尺寸一致
+template class BasicGameSession<8, 8, GEM_KIND>;
+template class BasicGameSession<9, 9, GEM_KIND>;
+template class BasicGameSession<10, 10, GEM_KIND>;
@@ -0,0 +1,143 @@
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include "GameMap.h"
+
+/**
+ * @brief 单步结算结果
+ * 对应界面定时器每次触发时推进的一个阶段
+ */
+enum StepResult {
+  STEP_ELIMINATED, ///< 消除了一批匹配，需要继续结算
+  STEP_REFILLED,   ///< 下落填充后出现新的匹配，需要继续结算
+  STEP_SETTLED,    ///< 地图稳定且仍有可走的步子，本回合结束
+  STEP_RESHUFFLED  ///< 地图稳定但已死局，已重置地图，本回合结束
+};
+
+/**
+ * @brief 一个完整回合的结算统计
+ */
+struct TurnResult {
+  bool accepted;   ///< 交换是否被接受（相邻且能产生匹配）
+  int points;      ///< 本回合获得的分数
+  int cascades;    ///< 消除轮数（连锁次数，首轮计 1）
+  int gemsCleared; ///< 本回合消除的宝石总数
+  bool reshuffled; ///< 回合结束时是否因死局重置了地图
+};
+
+/**
+ * @brief 游戏会话类
+ * 封装一局游戏的完整回合规则：交换 -> 匹配 -> 消除 -> 下落 -> 重复 -> 死局重置，
+ * 以及分数和撤销。不依赖 Qt，可在无界面的模拟程序中直接使用，
+ * 界面层通过 step() 逐阶段推进以播放动画
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
+ */
+template <int Rows, int Cols, int Kinds> class BasicGameSession {
+public:
+  typedef BasicGameMap<Rows, Cols, Kinds> MapType; ///< 对应尺寸的地图
+
+  /**
+   * @brief 构造函数
+   * 创建地图但不初始化，需调用 newGame()
+   * @param seed 随机种子，相同种子与相同操作序列得到相同的对局
+   */
+  explicit BasicGameSession(uint64_t seed = Random::entropySeed());
+
+  /**
+   * @brief 开始新的一局
+   * 清空历史、重新生成地图并将分数归零
+   */
+  void newGame();
+
+  /**
+   * @brief 尝试交换两个宝石
+   * 两格必须相邻；交换后没有匹配则换回并丢弃快照。
+   * 成功后会话进入结算状态，需调用 step() 或 resolve() 完成回合
+   * @return true 表示交换被接受
+   */
+  bool trySwap(int r1, int c1, int r2, int c2);
+
+  /**
+   * @brief 推进一个结算阶段
+   * 有匹配则消除并计分；否则下落填充，填充后无匹配时检测死局
+   * @return 本阶段结果
+   */
+  StepResult step();
+
+  /**
+   * @brief 连续推进直到回合结束
+   * @param result 可选，累加本回合的统计信息
+   * @return 最后一个阶段的结果（STEP_SETTLED 或 STEP_RESHUFFLED）
+   */
+  StepResult resolve(TurnResult *result = nullptr);
+
+  /**
+   * @brief 执行一个完整回合
+   * 等价于 trySwap() 后 resolve()
+   * @param move 交换操作
+   * @return 回合统计，交换无效时 accepted 为 false
+   */
+  TurnResult playMove(const Move &move);
+
+  /**
+   * @brief 是否处于结算中
+   * @return true 表示交换已被接受但回合尚未结束
+   */
+  bool isResolving() const;
+
+  /**
+   * @brief 撤销上一回合
+   * 恢复地图和分数
+   * @return true 表示撤销成功
+   */
+  bool undo();
+
+  /**
+   * @brief 获取当前分数
+   * @return 当前分数
+   */
+  int score() const;
+
+  /**
+   * @brief 设置当前分数（例如闯关模式进入下一关时归零）
+   * @param score 新的分数
+   */
+  void setScore(int score);
+
+  /**
+   * @brief 获取最近一个消除阶段的得分
+   * @return 得分
+   */
+  int lastStepPoints() const;
+
+  /**
+   * @brief 获取当前地图（只读）
+   * @return 地图引用
+   */
+  const MapType &map() const;
+
+  /**
+   * @brief 获取当前地图
+   * 供提示搜索等需要试探交换的调用方使用
+   * @return 地图引用
+   */
+  MapType &map();
+
+private:
+  MapType m_map;         ///< 游戏地图
+  int m_score;           ///< 当前分数
+  int m_lastStepPoints;  ///< 最近一个消除阶段的得分
+  int m_lastStepCleared; ///< 最近一个消除阶段消除的宝石数
+  bool m_resolving;      ///< 是否处于结算中
+};
+
+// 常用尺寸在 GameSession.cpp 中显式实例化
+extern template class BasicGameSession<8, 8, GEM_KIND>;
+extern template class BasicGameSession<9, 9, GEM_KIND>;
+extern template class BasicGameSession<10, 10, GEM_KIND>;
+
+typedef BasicGameSession<ROW, COL, GEM_KIND> GameSession; ///< 标准尺寸游戏会话
+
+#endif // GAMESESSION_H
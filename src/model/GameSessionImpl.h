@@ -0,0 +1,192 @@
+#ifndef GAMESESSIONIMPL_H
+#define GAMESESSIONIMPL_H
+
+// BasicGameSession 模板的成员实现。
+// 常用尺寸已在 GameSession.cpp 中显式实例化；其他尺寸的使用方需包含本文件
+
+#include "GameMapImpl.h"
+#include "GameSession.h"
+#include <cstdlib> // 用于 std::abs()
+
+/**
+ * @brief GameSession构造函数实现
+ * @param seed 随机种子
+ */
+template <int Rows, int Cols, int Kinds>
+BasicGameSession<Rows, Cols, Kinds>::BasicGameSession(uint64_t seed)
+    : m_map(seed), m_score(0), m_lastStepPoints(0), m_lastStepCleared(0),
+      m_resolving(false) {}
+
+/**
+ * @brief 开始新的一局实现
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicGameSession<Rows, Cols, Kinds>::newGame() {
+  m_map.clearHistory();
+  m_map.init();
+  m_score = 0;
+  m_lastStepPoints = 0;
+  m_lastStepCleared = 0;
+  m_resolving = false;
+}
+
+/**
+ * @brief 尝试交换实现
+ * 交换前保存当前状态和分数，交换无效时删除该快照
+ * @return true 表示交换被接受
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameSession<Rows, Cols, Kinds>::trySwap(int r1, int c1, int r2,
+                                                  int c2) {
+  if (m_resolving || !m_map.isValid(r1, c1) || !m_map.isValid(r2, c2)) {
+    return false;
+  }
+  // 检查是否相邻
+  bool isAdjacent = (std::abs(r1 - r2) == 1 && c1 == c2) ||
+                    (std::abs(c1 - c2) == 1 && r1 == r2);
+  if (!isAdjacent) {
+    return false;
+  }
+
+  m_map.saveCurState(m_score);
+  m_map.swap(r1, c1, r2, c2);
+
+  if (!m_map.hasAnyMatch()) {
+    // 无匹配时交换回来，并删除无效快照
+    m_map.swap(r2, c2, r1, c1);
+    m_map.popLastState();
+    return false;
+  }
+
+  m_resolving = true;
+  return true;
+}
+
+/**
+ * @brief 推进一个结算阶段实现
+ * @return 本阶段结果
+ */
+template <int Rows, int Cols, int Kinds>
+StepResult BasicGameSession<Rows, Cols, Kinds>::step() {
+  const typename MapType::Mask matches = m_map.checkMatchMask();
+
+  if (matches) {
+    // 按宝石颜色累加本次消除的分值，再执行消除
+    const int roundScore = m_map.maskScore(matches);
+    m_map.eliminate(matches);
+    m_score += roundScore;
+    m_lastStepPoints = roundScore;
+    m_lastStepCleared = maskPopCount(matches);
+    m_resolving = true;
+    return STEP_ELIMINATED;
+  }
+
+  // 无匹配时应用重力，检查新的匹配
+  m_map.applyGravity();
+  if (m_map.hasAnyMatch()) {
+    m_resolving = true;
+    return STEP_REFILLED;
+  }
+
+  // 下落完成后仍无匹配，检查是否为死局
+  m_resolving = false;
+  if (!m_map.hasPossibleMove()) {
+    m_map.reset(); // 仅重置地图宝石布局，分数保留
+    return STEP_RESHUFFLED;
+  }
+  return STEP_SETTLED;
+}
+
+/**
+ * @brief 连续推进实现
+ * @param result 可选的统计输出
+ * @return 最后一个阶段的结果
+ */
+template <int Rows, int Cols, int Kinds>
+StepResult
+BasicGameSession<Rows, Cols, Kinds>::resolve(TurnResult *result) {
+  for (;;) {
+    StepResult stepResult = step();
+    if (result) {
+      if (stepResult == STEP_ELIMINATED) {
+        result->cascades++;
+        result->points += m_lastStepPoints;
+        result->gemsCleared += m_lastStepCleared;
+      } else if (stepResult == STEP_RESHUFFLED) {
+        result->reshuffled = true;
+      }
+    }
+    if (stepResult == STEP_SETTLED || stepResult == STEP_RESHUFFLED) {
+      return stepResult;
+    }
+  }
+}
+
+/**
+ * @brief 执行完整回合实现
+ * @param move 交换操作
+ * @return 回合统计
+ */
+template <int Rows, int Cols, int Kinds>
+TurnResult BasicGameSession<Rows, Cols, Kinds>::playMove(const Move &move) {
+  TurnResult result = {false, 0, 0, 0, false};
+  if (trySwap(move.r1, move.c1, move.r2, move.c2)) {
+    result.accepted = true;
+    resolve(&result);
+  }
+  return result;
+}
+
+/**
+ * @brief 是否处于结算中实现
+ * @return true 表示回合尚未结束
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameSession<Rows, Cols, Kinds>::isResolving() const {
+  return m_resolving;
+}
+
+/**
+ * @brief 撤销实现
+ * @return true 表示撤销成功
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicGameSession<Rows, Cols, Kinds>::undo() {
+  if (m_resolving || !m_map.undo()) {
+    return false;
+  }
+  m_score = m_map.getLastUndoScore();
+  return true;
+}
+
+// 获取当前分数
+template <int Rows, int Cols, int Kinds>
+int BasicGameSession<Rows, Cols, Kinds>::score() const { return m_score; }
+
+// 设置当前分数
+template <int Rows, int Cols, int Kinds>
+void BasicGameSession<Rows, Cols, Kinds>::setScore(int score) {
+  m_score = score;
+}
+
+// 获取最近一个消除阶段的得分
+template <int Rows, int Cols, int Kinds>
+int BasicGameSession<Rows, Cols, Kinds>::lastStepPoints() const {
+  return m_lastStepPoints;
+}
+
+// 获取只读地图
+template <int Rows, int Cols, int Kinds>
+const typename BasicGameSession<Rows, Cols, Kinds>::MapType &
+BasicGameSession<Rows, Cols, Kinds>::map() const {
+  return m_map;
+}
+
+// 获取地图
+template <int Rows, int Cols, int Kinds>
+typename BasicGameSession<Rows, Cols, Kinds>::MapType &
+BasicGameSession<Rows, Cols, Kinds>::map() {
+  return m_map;
+}
+
+#endif // GAMESESSIONIMPL_H
@@ -3,17 +3,24 @@
 
 #include "Const.h" // 引用常量定义
 
+// 单个格子的打包表示（1 字节）：低半字节为颜色，其后一位为待消除标记。
+// 地图内部按结构数组存放（颜色字节数组 + 待消除位平面），Gem 只用于读写接口
 struct Gem {
-  GemType type;   // 宝石颜色
-  bool isMatched; // 标记是否处于待消除状态
+  GemType type : 4;   // 宝石颜色
+  bool isMatched : 1; // 标记是否处于待消除状态
 
   // 构造函数
   Gem(GemType t = EMPTY) : type(t), isMatched(false) {}
 
+  // 构造函数，同时指定待消除标记
+  Gem(GemType t, bool matched) : type(t), isMatched(matched) {}
+
   // 重载 == 操作符，方便比较两个宝石是否颜色相同
   bool operator==(const Gem &other) const { return this->type == other.type; }
 
   bool operator!=(const Gem &other) const { return this->type != other.type; }
 };
 
+static_assert(GEM_KIND < 16, "宝石颜色需能放入半字节");
+
 #endif // GEM_H
@@ -0,0 +1,53 @@
+#ifndef GREEDYPOLICY_H
+#define GREEDYPOLICY_H
+
+#include "GameMap.h"
+
+/**
+ * @brief 贪心选择交换
+ * 取直接消除得分最高的合法交换，只看交换后立即形成的匹配，不结算连锁；
+ * 得分相同时取 moves 中靠前的（即 findMoves 顺序），结果只由局面决定。
+ * 每个候选在 sim 上交换、计分后换回，返回时 sim 的局面不变
+ * @param sim 当前局面的地图
+ * @param moves 当前合法交换（非空）
+ * @return 选中的下标
+ */
+template <class MapType>
+int greedyMoveIndex(MapType &sim, const typename MapType::MoveList &moves) {
+  int best = 0;
+  int bestScore = -1;
+  for (int m = 0; m < moves.size(); m++) {
+    const Move &move = moves[m];
+    sim.swap(move.r1, move.c1, move.r2, move.c2);
+    const int score = sim.maskScore(sim.matchMask());
+    sim.swap(move.r1, move.c1, move.r2, move.c2);
+    if (score > bestScore) {
+      best = m;
+      bestScore = score;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief 在只读地图上贪心选择交换
+ * 局面复制到 scratch 上试探，供对局程序与模拟程序的机器人使用
+ * @param map 当前地图
+ * @param scratch 试探用的地图（内容被覆盖）
+ * @param move 输出交换
+ * @return false 表示没有合法交换
+ */
+template <class MapType>
+bool greedyMove(const MapType &map, MapType &scratch, Move &move) {
+  typename MapType::MoveList moves;
+  if (map.findMoves(moves) == 0) {
+    return false;
+  }
+  typename MapType::Snapshot root;
+  map.saveSnapshot(root);
+  scratch.loadSnapshot(root);
+  move = moves[greedyMoveIndex(scratch, moves)];
+  return true;
+}
+
+#endif // GREEDYPOLICY_H
@@ -0,0 +1,6 @@
+#include "HintEngineImpl.h"
+
+// 显式实例化：与 GameMap.cpp 中的地图尺寸一致
+template class BasicHintEngine<8, 8, GEM_KIND>;
+template class BasicHintEngine<9, 9, GEM_KIND>;
+template class BasicHintEngine<10, 10, GEM_KIND>;
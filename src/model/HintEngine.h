@@ -0,0 +1,141 @@
+#ifndef HINTENGINE_H
+#define HINTENGINE_H
+
+#include "GameMap.h"
+#include "SearchJob.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief 提示搜索结果
+ */
+struct HintResult {
+  bool found;           ///< 是否找到合法交换
+  Move move;            ///< 推荐的交换
+  double expectedScore; ///< 推荐交换的平均得分（含连锁与后续步）
+  int samples;          ///< 完成的模拟次数（所有候选合计）
+  bool timedOut;        ///< 是否因时间预算耗尽而提前结束
+};
+
+/**
+ * @brief 前瞻提示引擎
+ * 对每个合法交换模拟完整的“消除 -> 下落 -> 连锁”过程，
+ * 再向后搜索 depth-1 步取最优后续，得分在若干次随机补充上取平均。
+ * 候选交换与采样拆分到线程池并行计算，在时间预算内返回当前最优结果。
+ * 不依赖 Qt，界面通过 findBestMoveAsync() 在后台线程搜索
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
+ */
+template <int Rows, int Cols, int Kinds> class BasicHintEngine {
+public:
+  typedef BasicGameMap<Rows, Cols, Kinds> MapType;          ///< 对应尺寸的地图
+  typedef std::function<void(const HintResult &)> Callback; ///< 异步回调
+
+  static const int DEFAULT_DEPTH = 2;   ///< 默认搜索深度（含第一步）
+  static const int DEFAULT_SAMPLES = 8; ///< 默认每个候选的采样次数
+
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数，0 表示硬件并发数减一（给界面线程留一个核）
+   */
+  explicit BasicHintEngine(int threads = 0);
+
+  BasicHintEngine(const BasicHintEngine &) = delete;
+  BasicHintEngine &operator=(const BasicHintEngine &) = delete;
+
+  /**
+   * @brief 设置搜索深度
+   * @param depth 深度（至少为 1，1 表示只看第一步及其连锁）
+   */
+  void setDepth(int depth);
+
+  /**
+   * @brief 设置采样次数
+   * @param samples 每个候选交换的随机补充采样次数（至少为 1）
+   */
+  void setSamples(int samples);
+
+  /**
+   * @brief 设置随机种子
+   * 相同种子、相同局面且未超时时，结果与线程调度无关
+   * @param seed 随机种子
+   */
+  void setSeed(uint64_t seed);
+
+  /**
+   * @brief 同步搜索最佳交换
+   * @param map 当前地图（只在调用期间读取）
+   * @param timeBudgetMs 时间预算（毫秒）
+   * @return 搜索结果
+   */
+  HintResult findBestMove(const MapType &map, int timeBudgetMs);
+
+  /**
+   * @brief 异步搜索最佳交换
+   * 在调用线程中复制局面后立即返回，搜索完成时在后台线程调用 done；
+   * 上一次异步搜索尚未结束时将其作废（尽快停止，不再回调），调用方不等待
+   * @param map 当前地图
+   * @param timeBudgetMs 时间预算（毫秒）
+   * @param done 完成回调（在后台线程执行）
+   */
+  void findBestMoveAsync(const MapType &map, int timeBudgetMs, Callback done);
+
+private:
+  typedef typename MapType::Snapshot Snapshot;
+  typedef typename MapType::MoveList MoveList;
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief 一次搜索的输入
+   * 全部按值保存，可安全地交给其他线程
+   */
+  struct Job : BasicSearchJob<MapType> {
+    int depth;   ///< 搜索深度
+    int samples; ///< 每个候选的采样次数
+  };
+
+  /**
+   * @brief 根据地图构造搜索输入
+   */
+  Job makeJob(const MapType &map, int timeBudgetMs) const;
+
+  /**
+   * @brief 执行搜索
+   * 任务按“采样轮次优先”编号，超时时各候选的采样数大致相同；
+   * 截止时间与作废标记在两次采样之间及后续枚举的每一步前检查，
+   * 被打断的采样不计入平均
+   */
+  HintResult search(const Job &job);
+
+  /**
+   * @brief 后续最优得分
+   * 在当前局面上枚举合法交换，取“本步得分 + 更深的后续得分”的最大值
+   * @param sim 模拟地图
+   * @param depth 剩余深度
+   * @param job 搜索输入，到达截止时间或作废后提前返回
+   * @param best 输出最优得分，无合法交换时为 0
+   * @return false 表示被打断，best 不完整
+   */
+  static bool bestFollowUp(MapType &sim, int depth, const Job &job,
+                           int &best);
+
+  ThreadPool m_pool;          ///< 搜索线程池
+  mutable std::mutex m_mutex; ///< 保护参数
+  int m_depth;                ///< 搜索深度
+  int m_samples;              ///< 采样次数
+  uint64_t m_seed;            ///< 随机种子
+  /// 异步搜索的协调线程；最后声明，析构时先于线程池停止
+  LatestSearchWorker<Job, HintResult> m_async;
+};
+
+// 常用尺寸在 HintEngine.cpp 中显式实例化
+extern template class BasicHintEngine<8, 8, GEM_KIND>;
+extern template class BasicHintEngine<9, 9, GEM_KIND>;
+extern template class BasicHintEngine<10, 10, GEM_KIND>;
+
+typedef BasicHintEngine<ROW, COL, GEM_KIND> HintEngine; ///< 标准尺寸提示引擎
+
+#endif // HINTENGINE_H
@@ -0,0 +1,232 @@
+#ifndef HINTENGINEIMPL_H
+#define HINTENGINEIMPL_H
+
+// BasicHintEngine 模板的成员实现。
+// 常用尺寸已在 HintEngine.cpp 中显式实例化；其他尺寸的使用方需包含本文件
+
+#include "GameMapImpl.h"
+#include "HintEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace hint_detail {
+
+// 工作线程数：硬件并发数减一，至少一个
+inline int defaultThreads() {
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, hardware - 1);
+}
+
+} // namespace hint_detail
+
+/**
+ * @brief HintEngine构造函数实现
+ * @param threads 工作线程数
+ */
+template <int Rows, int Cols, int Kinds>
+BasicHintEngine<Rows, Cols, Kinds>::BasicHintEngine(int threads)
+    : m_pool(threads > 0 ? threads : hint_detail::defaultThreads()),
+      m_depth(DEFAULT_DEPTH), m_samples(DEFAULT_SAMPLES),
+      m_seed(Random::entropySeed()),
+      m_async([this](const Job &job) { return search(job); }) {}
+
+// 设置搜索深度
+template <int Rows, int Cols, int Kinds>
+void BasicHintEngine<Rows, Cols, Kinds>::setDepth(int depth) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_depth = std::max(1, depth);
+}
+
+// 设置采样次数
+template <int Rows, int Cols, int Kinds>
+void BasicHintEngine<Rows, Cols, Kinds>::setSamples(int samples) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_samples = std::max(1, samples);
+}
+
+// 设置随机种子
+template <int Rows, int Cols, int Kinds>
+void BasicHintEngine<Rows, Cols, Kinds>::setSeed(uint64_t seed) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_seed = seed;
+}
+
+/**
+ * @brief 同步搜索实现
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @return 搜索结果
+ */
+template <int Rows, int Cols, int Kinds>
+HintResult
+BasicHintEngine<Rows, Cols, Kinds>::findBestMove(const MapType &map,
+                                                 int timeBudgetMs) {
+  return search(makeJob(map, timeBudgetMs));
+}
+
+/**
+ * @brief 异步搜索实现
+ * 只复制局面并登记任务，搜索在协调线程中进行
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @param done 完成回调
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicHintEngine<Rows, Cols, Kinds>::findBestMoveAsync(const MapType &map,
+                                                           int timeBudgetMs,
+                                                           Callback done) {
+  m_async.post(makeJob(map, timeBudgetMs), std::move(done));
+}
+
+/**
+ * @brief 构造搜索输入实现
+ * @param map 当前地图
+ * @param timeBudgetMs 时间预算（毫秒）
+ * @return 搜索输入
+ */
+template <int Rows, int Cols, int Kinds>
+typename BasicHintEngine<Rows, Cols, Kinds>::Job
+BasicHintEngine<Rows, Cols, Kinds>::makeJob(const MapType &map,
+                                            int timeBudgetMs) const {
+  Job job;
+  uint64_t seed;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    job.depth = m_depth;
+    job.samples = m_samples;
+    seed = m_seed;
+  }
+  job.capture(map, seed, timeBudgetMs);
+  return job;
+}
+
+/**
+ * @brief 搜索实现
+ * 第 i 个任务评估候选 i % n 的第 i / n 次采样，随机种子只由 i 决定。
+ * 每个工作线程持有一张没有撤销历史的模拟地图，用快照整块恢复根局面
+ * @param job 搜索输入
+ * @return 搜索结果
+ */
+template <int Rows, int Cols, int Kinds>
+HintResult BasicHintEngine<Rows, Cols, Kinds>::search(const Job &job) {
+  HintResult result = {false, Move{-1, -1, -1, -1}, 0.0, 0, false};
+  const int n = job.moves.size();
+  if (n == 0) {
+    return result;
+  }
+
+  const int total = n * job.samples;
+  std::atomic<int> next(0);
+  std::vector<double> sums(n, 0.0);
+  std::vector<int> counts(n, 0);
+  std::mutex merge;
+
+  auto worker = [&]() {
+    MapType sim(0);
+    sim.setRefillPolicy(job.refill);
+    std::vector<double> localSums(n, 0.0);
+    std::vector<int> localCounts(n, 0);
+    for (;;) {
+      const int i = next.fetch_add(1);
+      if (i >= total || Clock::now() >= job.deadline ||
+          job.cancel.cancelled()) {
+        break;
+      }
+      const int m = i % n;
+      uint64_t mix = job.seed ^ (uint64_t(i) * 0x9e3779b97f4a7c15ULL);
+      sim.rng().setSeed(Random::splitMix64(mix));
+      sim.loadSnapshot(job.root);
+      int value = search_detail::playMove(sim, job.moves[m]);
+      int followUp = 0;
+      if (job.depth > 1 &&
+          !bestFollowUp(sim, job.depth - 1, job, followUp)) {
+        break;
+      }
+      localSums[m] += value + followUp;
+      localCounts[m]++;
+    }
+    std::lock_guard<std::mutex> lock(merge);
+    for (int m = 0; m < n; m++) {
+      sums[m] += localSums[m];
+      counts[m] += localCounts[m];
+    }
+  };
+
+  const int tasks = std::min(m_pool.size(), total);
+  std::vector<std::future<void>> pending;
+  for (int t = 0; t < tasks; t++) {
+    pending.push_back(m_pool.submit(worker));
+  }
+  for (std::future<void> &f : pending) {
+    f.get();
+  }
+
+  for (int m = 0; m < n; m++) {
+    result.samples += counts[m];
+    if (counts[m] == 0) {
+      continue;
+    }
+    const double mean = sums[m] / counts[m];
+    if (!result.found || mean > result.expectedScore) {
+      result.found = true;
+      result.move = job.moves[m];
+      result.expectedScore = mean;
+    }
+  }
+  result.timedOut = result.samples < total;
+
+  if (!result.found && !job.cancel.cancelled()) {
+    // 预算内一次模拟也没完成，退回只看第一步直接消除的得分
+    MapType sim(0);
+    for (int m = 0; m < n; m++) {
+      sim.loadSnapshot(job.root);
+      const Move &move = job.moves[m];
+      sim.swap(move.r1, move.c1, move.r2, move.c2);
+      const int score = sim.maskScore(sim.matchMask());
+      if (!result.found || score > result.expectedScore) {
+        result.found = true;
+        result.move = move;
+        result.expectedScore = score;
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief 后续最优得分实现
+ * 深层搜索的单次采样可能远超预算，因此每枚举一步都检查截止时间
+ * @param sim 模拟地图
+ * @param depth 剩余深度
+ * @param job 搜索输入
+ * @param best 输出最优得分
+ * @return false 表示被打断
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicHintEngine<Rows, Cols, Kinds>::bestFollowUp(MapType &sim, int depth,
+                                                      const Job &job,
+                                                      int &best) {
+  best = 0;
+  MoveList moves;
+  if (sim.findMoves(moves) == 0) {
+    return true;
+  }
+  Snapshot base;
+  sim.saveSnapshot(base);
+  for (const Move &move : moves) {
+    if (Clock::now() >= job.deadline || job.cancel.cancelled()) {
+      return false;
+    }
+    sim.loadSnapshot(base);
+    int value = search_detail::playMove(sim, move);
+    int followUp = 0;
+    if (depth > 1 && !bestFollowUp(sim, depth - 1, job, followUp)) {
+      return false;
+    }
+    best = std::max(best, value + followUp);
+  }
+  return true;
+}
+
+#endif // HINTENGINEIMPL_H
@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief MappedFile构造函数实现
+ */
+MappedFile::MappedFile() : m_data(nullptr), m_size(0) {}
+
+/**
+ * @brief MappedFile析构函数实现
+ */
+MappedFile::~MappedFile() { close(); }
+
+/**
+ * @brief 映射文件实现
+ * 映射建立后即关闭文件句柄，映射本身保持文件内容可读
+ * @param path 文件路径
+ * @return false 表示文件不存在、为空或映射失败
+ */
+bool MappedFile::open(const std::string &path) {
+  close();
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) {
+    return false;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!view) {
+    return false;
+  }
+  m_data = static_cast<const uint8_t *>(view);
+  m_size = static_cast<size_t>(size.QuadPart);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(info.st_size);
+  void *view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+  // 分析时按顺序扫描各列
+  madvise(view, size, MADV_SEQUENTIAL);
+  m_data = static_cast<const uint8_t *>(view);
+  m_size = size;
+#endif
+  return true;
+}
+
+/**
+ * @brief 解除映射实现
+ */
+void MappedFile::close() {
+  if (!m_data) {
+    return;
+  }
+#if defined(_WIN32)
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
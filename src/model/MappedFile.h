@@ -0,0 +1,54 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 只读内存映射文件
+ * 整个文件映射进地址空间，由操作系统按页调入，读取方直接使用映射中的字节而不复制；
+ * Windows 使用文件映射对象，其他平台使用 mmap
+ */
+class MappedFile {
+public:
+  /**
+   * @brief 构造函数
+   * 创建未映射的对象，需调用 open()
+   */
+  MappedFile();
+
+  /**
+   * @brief 析构函数
+   * 解除映射
+   */
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief 映射文件
+   * 已映射时先解除原映射
+   * @param path 文件路径
+   * @return false 表示文件不存在、为空或映射失败
+   */
+  bool open(const std::string &path);
+
+  /**
+   * @brief 解除映射
+   */
+  void close();
+
+  // 获取映射首地址（按页对齐），未映射时为 nullptr
+  const uint8_t *data() const { return m_data; }
+
+  // 获取映射字节数
+  size_t size() const { return m_size; }
+
+private:
+  const uint8_t *m_data; ///< 映射首地址
+  size_t m_size;         ///< 映射字节数
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,23 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+/**
+ * @brief 一次交换操作
+ * 记录两个相邻格子的行列坐标，(r1,c1) 总在 (r2,c2) 的左侧或上方
+ */
+struct Move {
+  int r1; ///< 第一个格子的行坐标
+  int c1; ///< 第一个格子的列坐标
+  int r2; ///< 第二个格子的行坐标
+  int c2; ///< 第二个格子的列坐标
+
+  // 重载 == 操作符，方便比较两次交换是否相同
+  bool operator==(const Move &other) const {
+    return r1 == other.r1 && c1 == other.c1 && r2 == other.r2 &&
+           c2 == other.c2;
+  }
+
+  bool operator!=(const Move &other) const { return !(*this == other); }
+};
+
+#endif // MOVE_H
@@ -0,0 +1,77 @@
+#ifndef MOVEPATTERNS_H
+#define MOVEPATTERNS_H
+
+/**
+ * @brief 相对偏移
+ */
+struct Offset {
+  int dr; ///< 行偏移
+  int dc; ///< 列偏移
+};
+
+/**
+ * @brief 邻域模板：与目标格同色即可组成三连的两个格子
+ */
+struct PatternPair {
+  Offset a; ///< 第一个支撑格
+  Offset b; ///< 第二个支撑格
+};
+
+// 移动方向：宝石从 A 移到 B = A + 方向偏移
+enum MoveDir {
+  DIR_UP = 0,
+  DIR_DOWN,
+  DIR_LEFT,
+  DIR_RIGHT,
+  DIR_COUNT
+};
+
+const int PATTERNS_PER_DIR = 4; ///< 每个方向的模板数
+
+/**
+ * @brief 移动模板表
+ * pairs[d] 是宝石沿方向 d 移入目标格后，可以与之组成三连的支撑格对（相对目标格）
+ */
+struct MovePatternTable {
+  Offset dirs[DIR_COUNT];                           ///< 各方向偏移
+  PatternPair pairs[DIR_COUNT][PATTERNS_PER_DIR]; ///< 各方向模板
+};
+
+/**
+ * @brief 编译期生成移动模板
+ * 经过目标格 B 的三连共 6 种：横向“两连在左/夹在中间/两连在右”和纵向同理。
+ * 宝石从 A 移入 B 时，A 处已换成另一颗宝石，因此剔除包含 A 的模板，每个方向剩 4 种
+ * @return 模板表
+ */
+constexpr MovePatternTable makeMovePatterns() {
+  MovePatternTable table{};
+  const Offset dirs[DIR_COUNT] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  const PatternPair lines[6] = {
+      {{0, -2}, {0, -1}}, {{0, -1}, {0, 1}}, {{0, 1}, {0, 2}},
+      {{-2, 0}, {-1, 0}}, {{-1, 0}, {1, 0}}, {{1, 0}, {2, 0}},
+  };
+  for (int d = 0; d < DIR_COUNT; d++) {
+    table.dirs[d] = dirs[d];
+    // 来源格 A 相对 B 的偏移
+    const int fromR = -dirs[d].dr;
+    const int fromC = -dirs[d].dc;
+    int n = 0;
+    for (int l = 0; l < 6; l++) {
+      const PatternPair &p = lines[l];
+      bool hitsSource = (p.a.dr == fromR && p.a.dc == fromC) ||
+                        (p.b.dr == fromR && p.b.dc == fromC);
+      if (!hitsSource) {
+        table.pairs[d][n++] = p;
+      }
+    }
+  }
+  return table;
+}
+
+inline constexpr MovePatternTable kMovePatterns = makeMovePatterns();
+
+static_assert(kMovePatterns.pairs[DIR_RIGHT][0].a.dc == 1 &&
+                  kMovePatterns.pairs[DIR_RIGHT][0].b.dc == 2,
+              "向右移动时首个模板应为目标格右侧两连");
+
+#endif // MOVEPATTERNS_H
@@ -0,0 +1,25 @@
+#ifndef PERCENTILE_H
+#define PERCENTILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 取已排序样本的最近秩分位数
+ * 秩取 q * n 四舍五入，限制在 1 ~ n 之间；基准、压测与模拟程序共用，
+ * 各报告中的同名分位数可以直接比较
+ * @param sorted 升序样本
+ * @param q 分位（0 ~ 1）
+ * @return 分位数，无样本时为 T()
+ */
+template <class T> T nearestRank(const std::vector<T> &sorted, double q) {
+  if (sorted.empty()) {
+    return T();
+  }
+  size_t rank = static_cast<size_t>(q * sorted.size() + 0.5);
+  rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+  return sorted[rank - 1];
+}
+
+#endif // PERCENTILE_H
@@ -0,0 +1,6 @@
+#include "PositionCacheImpl.h"
+
+// 显式实例化：与 GameMap.cpp 中的地图尺寸一致
+template class BasicPositionCache<8, 8, GEM_KIND>;
+template class BasicPositionCache<9, 9, GEM_KIND>;
+template class BasicPositionCache<10, 10, GEM_KIND>;
@@ -0,0 +1,137 @@
+#ifndef POSITIONCACHE_H
+#define POSITIONCACHE_H
+
+#include "GameMap.h"
+#include "TranspositionTable.h"
+#include <atomic>
+
+/**
+ * @brief 局面缓存
+ * 以地图的 Zobrist 哈希为键，在无锁置换表中缓存合法交换、死局判定与搜索值，
+ * 重复出现的局面 O(1) 查询。可选按左右镜像规范化：互为镜像的局面共用一个条目，
+ * 交换在读写时按需翻转。多个搜索线程可共享同一个缓存
+ * @tparam Rows 行数
+ * @tparam Cols 列数
+ * @tparam Kinds 宝石种类数
+ */
+template <int Rows, int Cols, int Kinds> class BasicPositionCache {
+public:
+  typedef BasicGameMap<Rows, Cols, Kinds> MapType; ///< 对应尺寸的地图
+  typedef typename MapType::Mask Mask;             ///< 格子掩码
+  typedef typename MapType::MoveList MoveList;     ///< 交换缓冲
+
+  static const size_t DEFAULT_BYTES = 4 << 20; ///< 默认内存预算（字节）
+
+  /**
+   * @brief 构造函数
+   * @param bytes 内存预算
+   * @param useMirror 是否按左右镜像规范化
+   */
+  explicit BasicPositionCache(size_t bytes = DEFAULT_BYTES,
+                              bool useMirror = true);
+
+  /**
+   * @brief 生成所有合法交换（带缓存）
+   * 结果及顺序与 MapType::findMoves() 相同
+   * @param map 地图
+   * @param moves 输出交换列表（先清空再写入）
+   * @return 合法交换数
+   */
+  int findMoves(const MapType &map, MoveList &moves);
+
+  /**
+   * @brief 死局检测（带缓存）
+   * 未命中时生成完整的交换列表并写入缓存，供之后的 findMoves 复用
+   * @param map 地图
+   * @return true 表示存在合法交换
+   */
+  bool hasAnyMove(const MapType &map);
+
+  /**
+   * @brief 查询搜索值
+   * @param map 地图
+   * @param depth 需要的搜索深度，缓存值的深度不小于它才算命中
+   * @param value 命中时输出搜索值
+   * @return true 表示命中
+   */
+  bool probeValue(const MapType &map, int depth, int &value);
+
+  /**
+   * @brief 写入搜索值
+   * 保留条目中已缓存的合法交换；已有更深的搜索值时不覆盖
+   * @param map 地图
+   * @param depth 搜索深度
+   * @param value 搜索值
+   */
+  void storeValue(const MapType &map, int depth, int value);
+
+  /**
+   * @brief 清空缓存与统计
+   */
+  void clear();
+
+  /**
+   * @brief 获取命中次数
+   * @return 命中次数
+   */
+  uint64_t hits() const;
+
+  /**
+   * @brief 获取未命中次数
+   * @return 未命中次数
+   */
+  uint64_t misses() const;
+
+private:
+  /**
+   * @brief 缓存条目
+   * 合法交换以两张掩码表示：right 的第 i 位表示格子 i 与右侧交换合法，
+   * down 表示与下方交换合法。内容总是规范形式下的局面
+   */
+  struct Entry {
+    Mask right;    ///< 向右交换掩码
+    Mask down;     ///< 向下交换掩码
+    int32_t value; ///< 搜索值
+    int16_t depth; ///< 搜索值的深度
+    uint8_t flags; ///< HAS_MOVES | HAS_VALUE
+  };
+
+  enum EntryFlag {
+    HAS_MOVES = 1, ///< right/down 有效
+    HAS_VALUE = 2  ///< value/depth 有效
+  };
+
+  /**
+   * @brief 计算缓存键
+   * @param map 地图
+   * @param mirrored 输出规范形式是否为镜像
+   * @return 键
+   */
+  uint64_t keyOf(const MapType &map, bool &mirrored) const;
+
+  /**
+   * @brief 查询条目并统计命中
+   */
+  bool probe(uint64_t key, Entry &entry);
+
+  /**
+   * @brief 左右翻转交换掩码
+   * 向右交换 (r,c)-(r,c+1) 翻转为 (r,Cols-2-c)-(r,Cols-1-c)；
+   * 向下交换 (r,c) 翻转为 (r,Cols-1-c)
+   */
+  static void mirrorMasks(Mask &right, Mask &down);
+
+  TranspositionTable<Entry> m_table; ///< 置换表
+  bool m_useMirror;                  ///< 是否按左右镜像规范化
+  std::atomic<uint64_t> m_hits;      ///< 命中次数
+  std::atomic<uint64_t> m_misses;    ///< 未命中次数
+};
+
+// 常用尺寸在 PositionCache.cpp 中显式实例化
+extern template class BasicPositionCache<8, 8, GEM_KIND>;
+extern template class BasicPositionCache<9, 9, GEM_KIND>;
+extern template class BasicPositionCache<10, 10, GEM_KIND>;
+
+typedef BasicPositionCache<ROW, COL, GEM_KIND> PositionCache; ///< 标准尺寸局面缓存
+
+#endif // POSITIONCACHE_H
@@ -0,0 +1,211 @@
+#ifndef POSITIONCACHEIMPL_H
+#define POSITIONCACHEIMPL_H
+
+// BasicPositionCache 模板的成员实现。
+// 常用尺寸已在 PositionCache.cpp 中显式实例化；其他尺寸的使用方需包含本文件
+
+#include "GameMapImpl.h"
+#include "PositionCache.h"
+
+/**
+ * @brief PositionCache构造函数实现
+ * @param bytes 内存预算
+ * @param useMirror 是否按左右镜像规范化
+ */
+template <int Rows, int Cols, int Kinds>
+BasicPositionCache<Rows, Cols, Kinds>::BasicPositionCache(size_t bytes,
+                                                          bool useMirror)
+    : m_table(bytes), m_useMirror(useMirror), m_hits(0), m_misses(0) {}
+
+/**
+ * @brief 带缓存的交换生成实现
+ * @param map 地图
+ * @param moves 输出交换列表
+ * @return 合法交换数
+ */
+template <int Rows, int Cols, int Kinds>
+int BasicPositionCache<Rows, Cols, Kinds>::findMoves(const MapType &map,
+                                                     MoveList &moves) {
+  bool mirrored = false;
+  const uint64_t key = keyOf(map, mirrored);
+  Entry entry;
+  const bool found = probe(key, entry);
+  if (found && (entry.flags & HAS_MOVES)) {
+    Mask right = entry.right;
+    Mask down = entry.down;
+    if (mirrored) {
+      mirrorMasks(right, down);
+    }
+    // 按格子号升序、先右后下输出，与 MapType::findMoves() 顺序一致
+    moves.clear();
+    for (Mask rest = right | down; rest; rest = maskClearLowest(rest)) {
+      const int i = maskLowestBit(rest);
+      const Mask bit = maskBit<Mask>(i);
+      const int r = i / Cols;
+      const int c = i % Cols;
+      if (right & bit) {
+        moves.push_back(Move{r, c, r, c + 1});
+      }
+      if (down & bit) {
+        moves.push_back(Move{r, c, r + 1, c});
+      }
+    }
+    return moves.size();
+  }
+
+  map.findMoves(moves);
+  if (!found) {
+    entry.value = 0;
+    entry.depth = 0;
+    entry.flags = 0;
+  }
+  entry.right = Mask();
+  entry.down = Mask();
+  for (const Move &move : moves) {
+    const Mask bit = maskBit<Mask>(move.r1 * Cols + move.c1);
+    if (move.r1 == move.r2) {
+      entry.right |= bit;
+    } else {
+      entry.down |= bit;
+    }
+  }
+  if (mirrored) {
+    mirrorMasks(entry.right, entry.down);
+  }
+  entry.flags |= HAS_MOVES;
+  m_table.store(key, entry);
+  return moves.size();
+}
+
+/**
+ * @brief 带缓存的死局检测实现
+ * @param map 地图
+ * @return true 表示存在合法交换
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicPositionCache<Rows, Cols, Kinds>::hasAnyMove(const MapType &map) {
+  MoveList moves;
+  return findMoves(map, moves) > 0;
+}
+
+/**
+ * @brief 查询搜索值实现
+ * @param map 地图
+ * @param depth 需要的搜索深度
+ * @param value 输出搜索值
+ * @return true 表示命中
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicPositionCache<Rows, Cols, Kinds>::probeValue(const MapType &map,
+                                                       int depth, int &value) {
+  bool mirrored = false;
+  Entry entry;
+  if (!probe(keyOf(map, mirrored), entry) || !(entry.flags & HAS_VALUE) ||
+      entry.depth < depth) {
+    return false;
+  }
+  value = entry.value;
+  return true;
+}
+
+/**
+ * @brief 写入搜索值实现
+ * @param map 地图
+ * @param depth 搜索深度
+ * @param value 搜索值
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicPositionCache<Rows, Cols, Kinds>::storeValue(const MapType &map,
+                                                       int depth, int value) {
+  bool mirrored = false;
+  const uint64_t key = keyOf(map, mirrored);
+  Entry entry;
+  if (!m_table.probe(key, entry)) {
+    entry.right = Mask();
+    entry.down = Mask();
+    entry.flags = 0;
+  } else if ((entry.flags & HAS_VALUE) && entry.depth > depth) {
+    return;
+  }
+  entry.value = value;
+  entry.depth = static_cast<int16_t>(depth);
+  entry.flags |= HAS_VALUE;
+  m_table.store(key, entry);
+}
+
+// 清空缓存与统计
+template <int Rows, int Cols, int Kinds>
+void BasicPositionCache<Rows, Cols, Kinds>::clear() {
+  m_table.clear();
+  m_hits.store(0, std::memory_order_relaxed);
+  m_misses.store(0, std::memory_order_relaxed);
+}
+
+// 获取命中次数
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicPositionCache<Rows, Cols, Kinds>::hits() const {
+  return m_hits.load(std::memory_order_relaxed);
+}
+
+// 获取未命中次数
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicPositionCache<Rows, Cols, Kinds>::misses() const {
+  return m_misses.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 计算缓存键实现
+ * @param map 地图
+ * @param mirrored 输出规范形式是否为镜像
+ * @return 键
+ */
+template <int Rows, int Cols, int Kinds>
+uint64_t BasicPositionCache<Rows, Cols, Kinds>::keyOf(const MapType &map,
+                                                      bool &mirrored) const {
+  if (!m_useMirror) {
+    mirrored = false;
+    return map.hash();
+  }
+  return map.canonicalHash(&mirrored);
+}
+
+/**
+ * @brief 查询条目实现
+ * @param key 键
+ * @param entry 输出条目
+ * @return true 表示命中
+ */
+template <int Rows, int Cols, int Kinds>
+bool BasicPositionCache<Rows, Cols, Kinds>::probe(uint64_t key,
+                                                  Entry &entry) {
+  if (m_table.probe(key, entry)) {
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+/**
+ * @brief 翻转交换掩码实现
+ * @param right 向右交换掩码（输入输出）
+ * @param down 向下交换掩码（输入输出）
+ */
+template <int Rows, int Cols, int Kinds>
+void BasicPositionCache<Rows, Cols, Kinds>::mirrorMasks(Mask &right,
+                                                        Mask &down) {
+  Mask newRight = Mask();
+  Mask newDown = Mask();
+  for (Mask rest = right; rest; rest = maskClearLowest(rest)) {
+    const int i = maskLowestBit(rest);
+    newRight |= maskBit<Mask>(i / Cols * Cols + (Cols - 2 - i % Cols));
+  }
+  for (Mask rest = down; rest; rest = maskClearLowest(rest)) {
+    const int i = maskLowestBit(rest);
+    newDown |= maskBit<Mask>(i / Cols * Cols + (Cols - 1 - i % Cols));
+  }
+  right = newRight;
+  down = newDown;
+}
+
+#endif // POSITIONCACHEIMPL_H
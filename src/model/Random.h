@@ -0,0 +1,173 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <chrono> // 用于 entropySeed()
+#include <cstdint>
+#include <random> // 用于 random_device
+
+/**
+ * @brief xoshiro256** 伪随机数生成器
+ * 每个实例独立持有 256 位状态，可显式设定种子以复现结果；
+ * jump()/longJump() 可在 O(1) 内跳过 2^128 / 2^192 个输出，
+ * 用于为并行模拟划分互不重叠的随机流
+ */
+class Random {
+public:
+  /**
+   * @brief 构造函数
+   * @param seed 种子，经 splitmix64 扩展为 256 位状态
+   */
+  explicit Random(uint64_t seed = 0) { setSeed(seed); }
+
+  /**
+   * @brief 重新设定种子
+   * @param seed 种子
+   */
+  void setSeed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+      m_state[i] = splitMix64(seed);
+    }
+  }
+
+  /**
+   * @brief 生成下一个 64 位随机数
+   * @return 随机数
+   */
+  uint64_t next() {
+    const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+    const uint64_t t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotl(m_state[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief 生成 [0, bound) 内的均匀随机整数
+   * 使用 Lemire 乘法映射并拒绝少量偏差样本，避免取模偏差
+   * @param bound 上界（不含），必须大于 0
+   * @return 随机整数
+   */
+  uint32_t bounded(uint32_t bound) {
+    uint64_t m = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound) {
+      const uint32_t threshold = (0u - bound) % bound;
+      while (low < threshold) {
+        m = (next() >> 32) * bound;
+        low = static_cast<uint32_t>(m);
+      }
+    }
+    return static_cast<uint32_t>(m >> 32);
+  }
+
+  /**
+   * @brief 跳过 2^128 个输出
+   * 相当于切换到下一条独立随机流，可划分 2^128 条流
+   */
+  void jump() {
+    static const uint64_t kJump[] = {0x180ec6d33cfd0abaULL,
+                                     0xd5a61266f0c9392cULL,
+                                     0xa9582618e03fc9aaULL,
+                                     0x39abdc4529b1661cULL};
+    applyJump(kJump);
+  }
+
+  /**
+   * @brief 跳过 2^192 个输出
+   * 用于在 jump() 划分的流之上再做一级划分（例如每台机器一段、每个线程一条）
+   */
+  void longJump() {
+    static const uint64_t kLongJump[] = {0x76e15d3efefdcbbfULL,
+                                         0xc5004e441c522fb3ULL,
+                                         0x77710069854ee241ULL,
+                                         0x39109bb02acbe635ULL};
+    applyJump(kLongJump);
+  }
+
+  /**
+   * @brief 分裂出一条独立随机流
+   * 返回当前状态的副本，并将自身推进到下一条流，
+   * 反复调用可得到任意多条互不重叠的流
+   * @return 新的生成器
+   */
+  Random split() {
+    Random child = *this;
+    jump();
+    return child;
+  }
+
+  /**
+   * @brief 获取内部状态（用于保存/恢复）
+   * @param state 输出 4 个 64 位状态字
+   */
+  void getState(uint64_t state[4]) const {
+    for (int i = 0; i < 4; i++) {
+      state[i] = m_state[i];
+    }
+  }
+
+  /**
+   * @brief 设置内部状态（用于保存/恢复）
+   * @param state 4 个 64 位状态字，不能全为 0
+   */
+  void setState(const uint64_t state[4]) {
+    for (int i = 0; i < 4; i++) {
+      m_state[i] = state[i];
+    }
+  }
+
+  /**
+   * @brief 生成一个不可预测的种子
+   * 结合 random_device 与当前时间，供界面等不需要复现的场景使用
+   * @return 种子
+   */
+  static uint64_t entropySeed() {
+    std::random_device device;
+    uint64_t seed = (uint64_t(device()) << 32) ^ device();
+    seed ^= static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    return seed;
+  }
+
+  /**
+   * @brief splitmix64 混合函数
+   * 用于把任意种子扩展为高质量的初始状态，也可独立用作哈希；
+   * 可在编译期求值（例如生成 Zobrist 键表）
+   * @param x 输入输出状态
+   * @return 混合结果
+   */
+  static constexpr uint64_t splitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+private:
+  uint64_t m_state[4]; ///< 256 位内部状态
+
+  // 64 位循环左移
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  // 按多项式系数执行跳跃
+  void applyJump(const uint64_t table[4]) {
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+      for (int b = 0; b < 64; b++) {
+        if (table[i] & (uint64_t(1) << b)) {
+          for (int j = 0; j < 4; j++) {
+            s[j] ^= m_state[j];
+          }
+        }
+        next();
+      }
+    }
+    setState(s);
+  }
+};
+
+#endif // RANDOM_H
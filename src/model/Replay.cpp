@@ -0,0 +1,595 @@
+#include "Replay.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char HEAD_MAGIC[4] = {'B', 'J', 'R', 'P'}; ///< 文件头标识
+const char TAIL_MAGIC[4] = {'B', 'J', 'R', 'E'}; ///< 文件尾标识
+const size_t HEADER_SIZE = 28; ///< 文件头字节数
+const size_t TAIL_SIZE = 32;   ///< 尾部索引（不含关键帧偏移表）字节数
+
+using replay_detail::FLAG_COLUMN_STREAMS;
+using replay_detail::FLAG_PLAYABLE;
+using replay_detail::fail;
+
+/**
+ * @brief 小端序写入
+ */
+class ByteWriter {
+public:
+  explicit ByteWriter(std::vector<uint8_t> &out) : m_out(out) {}
+
+  void u8(uint8_t v) { m_out.push_back(v); }
+
+  void u16(uint16_t v) {
+    u8(static_cast<uint8_t>(v));
+    u8(static_cast<uint8_t>(v >> 8));
+  }
+
+  void u32(uint32_t v) {
+    u16(static_cast<uint16_t>(v));
+    u16(static_cast<uint16_t>(v >> 16));
+  }
+
+  void u64(uint64_t v) {
+    u32(static_cast<uint32_t>(v));
+    u32(static_cast<uint32_t>(v >> 32));
+  }
+
+  // LEB128：每字节 7 位，最高位表示后面还有字节
+  void varint(uint32_t v) {
+    while (v >= 0x80) {
+      u8(static_cast<uint8_t>(v | 0x80));
+      v >>= 7;
+    }
+    u8(static_cast<uint8_t>(v));
+  }
+
+  void raw(const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    m_out.insert(m_out.end(), bytes, bytes + size);
+  }
+
+  // 当前偏移
+  uint32_t offset() const { return static_cast<uint32_t>(m_out.size()); }
+
+private:
+  std::vector<uint8_t> &m_out; ///< 输出缓冲
+};
+
+/**
+ * @brief 小端序读取
+ * 越界后 ok() 为 false，之后的读取都返回 0
+ */
+class ByteReader {
+public:
+  ByteReader(const std::vector<uint8_t> &bytes, size_t begin, size_t end)
+      : m_bytes(bytes), m_pos(begin), m_end(end), m_ok(end <= bytes.size()) {}
+
+  uint8_t u8() {
+    if (!m_ok || m_pos >= m_end) {
+      m_ok = false;
+      return 0;
+    }
+    return m_bytes[m_pos++];
+  }
+
+  uint16_t u16() {
+    const uint16_t low = u8();
+    return static_cast<uint16_t>(low | (u8() << 8));
+  }
+
+  uint32_t u32() {
+    const uint32_t low = u16();
+    return low | (uint32_t(u16()) << 16);
+  }
+
+  uint64_t u64() {
+    const uint64_t low = u32();
+    return low | (uint64_t(u32()) << 32);
+  }
+
+  uint32_t varint() {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      const uint8_t byte = u8();
+      v |= uint32_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return v;
+      }
+    }
+    m_ok = false; // 超过 5 字节
+    return 0;
+  }
+
+  bool ok() const { return m_ok; }
+
+  // 是否恰好读完
+  bool done() const { return m_ok && m_pos == m_end; }
+
+private:
+  const std::vector<uint8_t> &m_bytes; ///< 输入
+  size_t m_pos;                        ///< 当前偏移
+  size_t m_end;                        ///< 可读范围的结束偏移
+  bool m_ok;                           ///< 是否尚未越界
+};
+
+// 低 32 位校验值
+uint32_t checkOf(const GameSession &session) {
+  return static_cast<uint32_t>(Replay::stateHash(session));
+}
+
+} // namespace
+
+/**
+ * @brief Replay构造函数实现
+ */
+Replay::Replay()
+    : m_seed(0), m_refillPolicy(REFILL_RANDOM), m_columnStreams(false),
+      m_keyframeInterval(DEFAULT_KEYFRAME_INTERVAL), m_initialCheck(0),
+      m_finalHash(0) {}
+
+/**
+ * @brief 开始录制实现
+ * @param session 刚开局的会话
+ * @param keyframeInterval 关键帧间隔
+ */
+void Replay::begin(const GameSession &session, int keyframeInterval) {
+  const GameMap &map = session.map();
+  m_seed = map.seed();
+  m_refillPolicy = map.refillPolicy();
+  m_columnStreams = map.columnStreams();
+  m_keyframeInterval = keyframeInterval < 1 ? 1 : keyframeInterval;
+  m_initialCheck = checkOf(session);
+  m_finalHash = stateHash(session);
+  m_events.clear();
+  m_keyframes.clear();
+}
+
+/**
+ * @brief 记录交换实现
+ * 不相邻的交换无法编码，直接忽略
+ * @param move 交换
+ * @param deltaMs 时间间隔
+ * @param session 结算后的会话
+ */
+void Replay::recordMove(const Move &move, uint32_t deltaMs,
+                        const GameSession &session) {
+  uint8_t code;
+  if (encodeMove(move, code)) {
+    append(code, deltaMs, session);
+  }
+}
+
+/**
+ * @brief 记录撤销实现
+ * @param deltaMs 时间间隔
+ * @param session 撤销后的会话
+ */
+void Replay::recordUndo(uint32_t deltaMs, const GameSession &session) {
+  append(CODE_UNDO, deltaMs, session);
+}
+
+/**
+ * @brief 记录分数清零实现
+ * @param deltaMs 时间间隔
+ * @param session 清零后的会话
+ */
+void Replay::recordScoreReset(uint32_t deltaMs, const GameSession &session) {
+  append(CODE_SCORE_RESET, deltaMs, session);
+}
+
+/**
+ * @brief 追加事件实现
+ * @param code 事件编码
+ * @param deltaMs 时间间隔
+ * @param session 事件结算后的会话
+ */
+void Replay::append(uint8_t code, uint32_t deltaMs,
+                    const GameSession &session) {
+  m_events.push_back(ReplayEvent{code, deltaMs, checkOf(session)});
+  m_finalHash = stateHash(session);
+  if (m_events.size() % m_keyframeInterval != 0) {
+    return;
+  }
+  ReplayKeyframe keyframe;
+  keyframe.turn = static_cast<uint32_t>(m_events.size());
+  keyframe.score = session.score();
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      keyframe.types[r][c] = session.map().getGemType(r, c);
+    }
+  }
+  session.map().saveRandomState(keyframe.rng);
+  m_keyframes.push_back(keyframe);
+}
+
+/**
+ * @brief 序列化实现
+ * @return 字节序列
+ */
+std::vector<uint8_t> Replay::serialize() const {
+  std::vector<uint8_t> out;
+  ByteWriter w(out);
+  w.raw(HEAD_MAGIC, sizeof(HEAD_MAGIC));
+  w.u16(FORMAT_VERSION);
+  w.u8(ROW);
+  w.u8(COL);
+  w.u8(GEM_KIND);
+  w.u8((m_refillPolicy == REFILL_PLAYABLE ? FLAG_PLAYABLE : 0) |
+       (m_columnStreams ? FLAG_COLUMN_STREAMS : 0));
+  w.u16(static_cast<uint16_t>(m_keyframeInterval));
+  w.u64(m_seed);
+  w.u32(static_cast<uint32_t>(m_events.size()));
+  w.u32(m_initialCheck);
+
+  const uint32_t movesOffset = w.offset();
+  for (const ReplayEvent &e : m_events) {
+    w.u8(e.code);
+  }
+  const uint32_t deltasOffset = w.offset();
+  for (const ReplayEvent &e : m_events) {
+    w.varint(e.deltaMs);
+  }
+  const uint32_t checksOffset = w.offset();
+  for (const ReplayEvent &e : m_events) {
+    w.u32(e.check);
+  }
+
+  std::vector<uint32_t> keyframeOffsets;
+  for (const ReplayKeyframe &k : m_keyframes) {
+    keyframeOffsets.push_back(w.offset());
+    w.u32(k.turn);
+    w.u32(static_cast<uint32_t>(k.score));
+    w.raw(k.types, sizeof(k.types));
+    for (int i = 0; i < 4; i++) {
+      w.u64(k.rng.main[i]);
+    }
+    if (m_columnStreams) {
+      for (int c = 0; c < COL; c++) {
+        for (int i = 0; i < 4; i++) {
+          w.u64(k.rng.columns[c][i]);
+        }
+      }
+    }
+  }
+
+  const uint32_t indexOffset = w.offset();
+  for (uint32_t offset : keyframeOffsets) {
+    w.u32(offset);
+  }
+  w.u32(movesOffset);
+  w.u32(deltasOffset);
+  w.u32(checksOffset);
+  w.u32(static_cast<uint32_t>(m_keyframes.size()));
+  w.u32(indexOffset);
+  w.u64(m_finalHash);
+  w.raw(TAIL_MAGIC, sizeof(TAIL_MAGIC));
+  return out;
+}
+
+/**
+ * @brief 解析实现
+ * @param bytes 字节序列
+ * @param error 失败原因
+ * @return true 表示解析成功
+ */
+bool Replay::parse(const std::vector<uint8_t> &bytes, std::string *error) {
+  if (bytes.size() < HEADER_SIZE + TAIL_SIZE ||
+      std::memcmp(bytes.data(), HEAD_MAGIC, sizeof(HEAD_MAGIC)) != 0 ||
+      std::memcmp(bytes.data() + bytes.size() - sizeof(TAIL_MAGIC),
+                  TAIL_MAGIC, sizeof(TAIL_MAGIC)) != 0) {
+    return fail(error, "不是回放文件");
+  }
+
+  ByteReader head(bytes, sizeof(HEAD_MAGIC), HEADER_SIZE);
+  if (head.u16() != FORMAT_VERSION) {
+    return fail(error, "不支持的回放版本");
+  }
+  const int rows = head.u8();
+  const int cols = head.u8();
+  const int kinds = head.u8();
+  if (rows != ROW || cols != COL || kinds != GEM_KIND) {
+    return fail(error, "棋盘尺寸或宝石种类不符");
+  }
+  const uint8_t flags = head.u8();
+  const int interval = head.u16();
+  const uint64_t seed = head.u64();
+  const uint32_t turns = head.u32();
+  const uint32_t initialCheck = head.u32();
+
+  // 先读尾部索引，得到各段位置
+  const size_t tailBegin = bytes.size() - TAIL_SIZE;
+  ByteReader tail(bytes, tailBegin, bytes.size());
+  const uint32_t movesOffset = tail.u32();
+  const uint32_t deltasOffset = tail.u32();
+  const uint32_t checksOffset = tail.u32();
+  const uint32_t keyframeCount = tail.u32();
+  const uint32_t indexOffset = tail.u32();
+  const uint64_t finalHash = tail.u64();
+  if (interval < 1 || movesOffset != HEADER_SIZE ||
+      deltasOffset - movesOffset != turns || deltasOffset > checksOffset ||
+      uint64_t(checksOffset) + uint64_t(turns) * 4 > indexOffset ||
+      uint64_t(indexOffset) + uint64_t(keyframeCount) * 4 != tailBegin ||
+      keyframeCount != turns / interval) {
+    return fail(error, "回放索引损坏");
+  }
+
+  std::vector<ReplayEvent> events(turns);
+  ByteReader moves(bytes, movesOffset, deltasOffset);
+  ByteReader deltas(bytes, deltasOffset, checksOffset);
+  ByteReader checks(bytes, checksOffset, checksOffset + size_t(turns) * 4);
+  for (ReplayEvent &e : events) {
+    e.code = moves.u8();
+    e.deltaMs = deltas.varint();
+    e.check = checks.u32();
+    if (e.code >= ROW * COL * 2 && e.code != CODE_UNDO &&
+        e.code != CODE_SCORE_RESET) {
+      return fail(error, "回放事件编码无效");
+    }
+  }
+  if (!moves.done() || !deltas.done() || !checks.done()) {
+    return fail(error, "回放事件段损坏");
+  }
+
+  // 未开启分列流时关键帧不存各列补充流，用种子派生的状态填充（模拟中不会用到）
+  GameMap::RandomState seeded;
+  GameMap(seed).saveRandomState(seeded);
+  const bool columnStreams = (flags & FLAG_COLUMN_STREAMS) != 0;
+  std::vector<ReplayKeyframe> keyframes(keyframeCount);
+  ByteReader index(bytes, indexOffset, tailBegin);
+  for (uint32_t k = 0; k < keyframeCount; k++) {
+    const uint32_t offset = index.u32();
+    if (offset < checksOffset + size_t(turns) * 4 || offset >= indexOffset) {
+      return fail(error, "关键帧偏移无效");
+    }
+    ReplayKeyframe &keyframe = keyframes[k];
+    ByteReader r(bytes, offset, indexOffset);
+    keyframe.turn = r.u32();
+    keyframe.score = static_cast<int32_t>(r.u32());
+    for (int row = 0; row < ROW; row++) {
+      for (int col = 0; col < COL; col++) {
+        const uint8_t type = r.u8();
+        if (type == EMPTY || type > GEM_KIND) {
+          return fail(error, "关键帧棋盘无效");
+        }
+        keyframe.types[row][col] = static_cast<GemType>(type);
+      }
+    }
+    keyframe.rng = seeded;
+    for (int i = 0; i < 4; i++) {
+      keyframe.rng.main[i] = r.u64();
+    }
+    if (columnStreams) {
+      for (int c = 0; c < COL; c++) {
+        for (int i = 0; i < 4; i++) {
+          keyframe.rng.columns[c][i] = r.u64();
+        }
+      }
+    }
+    if (!r.ok() || keyframe.turn != (k + 1) * uint32_t(interval)) {
+      return fail(error, "关键帧损坏");
+    }
+  }
+
+  m_seed = seed;
+  m_refillPolicy = (flags & FLAG_PLAYABLE) ? REFILL_PLAYABLE : REFILL_RANDOM;
+  m_columnStreams = columnStreams;
+  m_keyframeInterval = interval;
+  m_initialCheck = initialCheck;
+  m_finalHash = finalHash;
+  m_events.swap(events);
+  m_keyframes.swap(keyframes);
+  return true;
+}
+
+/**
+ * @brief 保存实现
+ * @param path 文件路径
+ * @return true 表示写入成功
+ */
+bool Replay::save(const std::string &path) const {
+  const std::vector<uint8_t> bytes = serialize();
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  return static_cast<bool>(file);
+}
+
+/**
+ * @brief 读取实现
+ * @param path 文件路径
+ * @param error 失败原因
+ * @return true 表示读取并解析成功
+ */
+bool Replay::load(const std::string &path, std::string *error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return fail(error, "无法打开回放文件");
+  }
+  const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+                                   std::istreambuf_iterator<char>());
+  return parse(bytes, error);
+}
+
+/**
+ * @brief 交换编码实现
+ * @param move 交换
+ * @param code 输出编码
+ * @return false 表示无法编码
+ */
+bool Replay::encodeMove(const Move &move, uint8_t &code) {
+  const int r = move.r1 < move.r2 ? move.r1 : move.r2;
+  const int c = move.c1 < move.c2 ? move.c1 : move.c2;
+  const bool down = move.c1 == move.c2 && (move.r1 - move.r2 == 1 ||
+                                           move.r2 - move.r1 == 1);
+  const bool right = move.r1 == move.r2 && (move.c1 - move.c2 == 1 ||
+                                            move.c2 - move.c1 == 1);
+  if ((!down && !right) || r < 0 || c < 0 || r + down >= ROW ||
+      c + right >= COL) {
+    return false;
+  }
+  code = static_cast<uint8_t>((r * COL + c) * 2 + (down ? 1 : 0));
+  return true;
+}
+
+/**
+ * @brief 交换解码实现
+ * @param code 编码
+ * @return 交换
+ */
+Move Replay::decodeMove(uint8_t code) {
+  const int cell = code / 2;
+  const int r = cell / COL;
+  const int c = cell % COL;
+  if (code & 1) {
+    return Move{r, c, r + 1, c};
+  }
+  return Move{r, c, r, c + 1};
+}
+
+/**
+ * @brief 状态哈希实现
+ * @param session 会话
+ * @return 哈希值
+ */
+uint64_t Replay::stateHash(const GameSession &session) {
+  uint64_t score = static_cast<uint32_t>(session.score());
+  return session.map().hash() ^ Random::splitMix64(score);
+}
+
+/**
+ * @brief ReplayPlayer构造函数实现
+ * @param replay 回放
+ */
+ReplayPlayer::ReplayPlayer(const Replay &replay)
+    : m_replay(replay), m_session(replay.seed()), m_turn(0), m_origin(0) {
+  restart();
+}
+
+/**
+ * @brief 回到开局实现
+ * 与界面开局相同：设定种子与补充规则后 newGame()
+ * @return false 表示开局状态与录制不符
+ */
+bool ReplayPlayer::restart() {
+  GameMap &map = m_session.map();
+  map.setSeed(m_replay.seed());
+  map.setRefillPolicy(m_replay.refillPolicy());
+  map.setColumnStreams(m_replay.columnStreams());
+  m_session.newGame();
+  m_turn = 0;
+  m_origin = 0;
+  return checkOf(m_session) == m_replay.initialCheck();
+}
+
+/**
+ * @brief 执行下一个事件实现
+ * @return false 表示已到末尾、无法执行或校验不符
+ */
+bool ReplayPlayer::step() {
+  if (m_turn >= m_replay.turns()) {
+    return false;
+  }
+  const ReplayEvent &e = m_replay.event(m_turn);
+  if (e.code == Replay::CODE_UNDO) {
+    if (!m_session.undo()) {
+      return false;
+    }
+  } else if (e.code == Replay::CODE_SCORE_RESET) {
+    m_session.setScore(0);
+  } else if (!m_session.playMove(Replay::decodeMove(e.code)).accepted) {
+    return false;
+  }
+  m_turn++;
+  return checkOf(m_session) == e.check;
+}
+
+/**
+ * @brief 跳转实现
+ * 撤销会回到更早的回合，而关键帧不含撤销历史：
+ * 从目标往回数撤销所需的交换，直到某个关键帧之后的撤销都能在其后找到对应交换
+ * @param turn 目标事件数
+ * @return false 表示越界或校验不符
+ */
+bool ReplayPlayer::seek(int turn) {
+  if (turn < 0 || turn > m_replay.turns()) {
+    return false;
+  }
+  const int interval = m_replay.keyframeInterval();
+  int k = turn / interval; // 候选出发点为第 k*interval 个事件之后
+  int needed = 0;
+  for (int i = turn - 1; k > 0; i--) {
+    if (i < k * interval) {
+      if (needed == 0) {
+        break;
+      }
+      k--;
+    }
+    const uint8_t code = m_replay.event(i).code;
+    if (code == Replay::CODE_UNDO) {
+      needed++;
+    } else if (code != Replay::CODE_SCORE_RESET && needed > 0) {
+      needed--;
+    }
+  }
+  const int base = k * interval;
+
+  // 当前位置的撤销历史覆盖出发点时直接向前模拟
+  if (!(m_origin <= base && base <= m_turn && m_turn <= turn)) {
+    if (k == 0) {
+      if (!restart()) {
+        return false;
+      }
+    } else {
+      loadKeyframe(m_replay.keyframe(k - 1));
+    }
+  }
+  while (m_turn < turn) {
+    if (!step()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 核对整局实现
+ * @return -1 表示全部一致，否则为第一个不一致的事件号
+ */
+int ReplayPlayer::verify() {
+  if (!restart()) {
+    return 0;
+  }
+  while (m_turn < m_replay.turns()) {
+    const int next = m_turn + 1;
+    if (!step()) {
+      return next;
+    }
+  }
+  if (Replay::stateHash(m_session) != m_replay.finalHash()) {
+    return m_replay.turns();
+  }
+  return -1;
+}
+
+/**
+ * @brief 从关键帧恢复实现
+ * 撤销历史从关键帧处重新开始
+ * @param keyframe 关键帧
+ */
+void ReplayPlayer::loadKeyframe(const ReplayKeyframe &keyframe) {
+  GameMap &map = m_session.map();
+  map.clearHistory();
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      map.setGemType(r, c, keyframe.types[r][c]);
+    }
+  }
+  map.loadRandomState(keyframe.rng);
+  m_session.setScore(keyframe.score);
+  m_turn = static_cast<int>(keyframe.turn);
+  m_origin = m_turn;
+}
@@ -0,0 +1,275 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "GameSession.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static_assert(ROW * COL * 2 <= 0xF0,
+              "每个交换编码为一个字节，高位留给特殊事件");
+
+/**
+ * @brief 回放中的一个事件
+ * 每个被接受的交换、成功的撤销或分数清零各占一个事件
+ */
+struct ReplayEvent {
+  uint8_t code;     ///< 事件编码，见 Replay::encodeMove() 与 Replay::CODE_*
+  uint32_t deltaMs; ///< 距上一事件（或开局）的时间（毫秒）
+  uint32_t check;   ///< 事件结算后的状态校验值（Replay::stateHash() 的低 32 位）
+};
+
+/**
+ * @brief 关键帧
+ * 某个事件结算后的完整状态：棋盘、分数与全部随机流，从这里可以继续确定性模拟
+ */
+struct ReplayKeyframe {
+  uint32_t turn;            ///< 之前已执行的事件数
+  int32_t score;            ///< 分数
+  GemType types[ROW][COL];  ///< 各格颜色
+  GameMap::RandomState rng; ///< 随机流状态
+};
+
+/**
+ * @brief 对局回放
+ * 一局游戏记录为“种子 + 紧凑事件日志”：每个事件一个字节的编码、
+ * 一个变长的时间间隔和一个 32 位状态校验值；每隔若干事件存一个关键帧。
+ * 文件末尾是定长的索引：各段偏移与关键帧偏移表，读取方先读尾部即可定位任意关键帧。
+ *
+ * 文件格式（小端序）：
+ *   文件头   "BJRP"、版本、行列数与宝石种类、标志、关键帧间隔、种子、事件数、开局校验值
+ *   事件编码 每个事件 1 字节
+ *   时间间隔 每个事件一个 LEB128 变长整数
+ *   校验值   每个事件 4 字节
+ *   关键帧   事件数、分数、各格颜色，以及主随机流（开启分列流时再加各列补充流）
+ *   索引     关键帧偏移表，各段偏移、关键帧数、结束时的完整状态哈希与 "BJRE"
+ */
+class Replay {
+public:
+  static const int FORMAT_VERSION = 1;             ///< 文件格式版本
+  static const int DEFAULT_KEYFRAME_INTERVAL = 32; ///< 默认关键帧间隔（事件数）
+  static const uint8_t CODE_SCORE_RESET = 0xFE;    ///< 分数清零（挑战模式过关）
+  static const uint8_t CODE_UNDO = 0xFF;           ///< 撤销
+
+  /**
+   * @brief 构造函数
+   * 创建空回放，需调用 begin() 开始录制或 parse()/load() 读取
+   */
+  Replay();
+
+  /**
+   * @brief 开始录制
+   * 清空已有内容，记录会话地图的种子、补充策略与分列流设置。
+   * 应在以该种子调用 newGame() 之后、第一次交换之前调用
+   * @param session 刚开局的会话
+   * @param keyframeInterval 关键帧间隔（事件数，至少为 1）
+   */
+  void begin(const GameSession &session,
+             int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+  /**
+   * @brief 记录一次交换
+   * 在回合结算完成后调用
+   * @param move 被接受的交换（两格相邻）
+   * @param deltaMs 距上一事件的时间（毫秒）
+   * @param session 结算后的会话
+   */
+  void recordMove(const Move &move, uint32_t deltaMs,
+                  const GameSession &session);
+
+  /**
+   * @brief 记录一次成功的撤销
+   * @param deltaMs 距上一事件的时间（毫秒）
+   * @param session 撤销后的会话
+   */
+  void recordUndo(uint32_t deltaMs, const GameSession &session);
+
+  /**
+   * @brief 记录一次分数清零
+   * @param deltaMs 距上一事件的时间（毫秒）
+   * @param session 清零后的会话
+   */
+  void recordScoreReset(uint32_t deltaMs, const GameSession &session);
+
+  // 获取开局种子
+  uint64_t seed() const { return m_seed; }
+
+  // 获取补充策略
+  RefillPolicy refillPolicy() const { return m_refillPolicy; }
+
+  // 是否使用分列补充流
+  bool columnStreams() const { return m_columnStreams; }
+
+  // 获取关键帧间隔
+  int keyframeInterval() const { return m_keyframeInterval; }
+
+  // 获取开局时的状态校验值
+  uint32_t initialCheck() const { return m_initialCheck; }
+
+  // 获取结束时的完整状态哈希
+  uint64_t finalHash() const { return m_finalHash; }
+
+  // 获取事件数
+  int turns() const { return static_cast<int>(m_events.size()); }
+
+  // 获取第 i 个事件
+  const ReplayEvent &event(int i) const { return m_events[i]; }
+
+  // 获取关键帧数
+  int keyframeCount() const { return static_cast<int>(m_keyframes.size()); }
+
+  // 获取第 k 个关键帧（第 (k+1)*keyframeInterval() 个事件之后的状态）
+  const ReplayKeyframe &keyframe(int k) const { return m_keyframes[k]; }
+
+  /**
+   * @brief 序列化为文件格式
+   * @return 字节序列
+   */
+  std::vector<uint8_t> serialize() const;
+
+  /**
+   * @brief 从文件格式解析
+   * 先读尾部索引，再按偏移读取各段；失败时回放保持不变
+   * @param bytes 字节序列
+   * @param error 可选，失败时输出原因
+   * @return true 表示解析成功
+   */
+  bool parse(const std::vector<uint8_t> &bytes, std::string *error = nullptr);
+
+  /**
+   * @brief 保存到文件
+   * @param path 文件路径
+   * @return true 表示写入成功
+   */
+  bool save(const std::string &path) const;
+
+  /**
+   * @brief 从文件读取
+   * @param path 文件路径
+   * @param error 可选，失败时输出原因
+   * @return true 表示读取并解析成功
+   */
+  bool load(const std::string &path, std::string *error = nullptr);
+
+  /**
+   * @brief 交换编码
+   * 以左（上）格为基准：编码 = 格子号 * 2 + (向下 ? 1 : 0)
+   * @param move 交换
+   * @param code 输出编码
+   * @return false 表示两格不相邻或越界
+   */
+  static bool encodeMove(const Move &move, uint8_t &code);
+
+  /**
+   * @brief 交换解码
+   * @param code 编码（小于 ROW * COL * 2）
+   * @return 交换
+   */
+  static Move decodeMove(uint8_t code);
+
+  /**
+   * @brief 计算会话的状态哈希
+   * 地图 Zobrist 哈希与分数的组合
+   * @param session 会话
+   * @return 哈希值
+   */
+  static uint64_t stateHash(const GameSession &session);
+
+private:
+  /**
+   * @brief 追加事件，按间隔补关键帧
+   */
+  void append(uint8_t code, uint32_t deltaMs, const GameSession &session);
+
+  uint64_t m_seed;                         ///< 开局种子
+  RefillPolicy m_refillPolicy;             ///< 补充策略
+  bool m_columnStreams;                    ///< 是否使用分列补充流
+  int m_keyframeInterval;                  ///< 关键帧间隔
+  uint32_t m_initialCheck;                 ///< 开局校验值
+  uint64_t m_finalHash;                    ///< 结束时的完整状态哈希
+  std::vector<ReplayEvent> m_events;       ///< 事件
+  std::vector<ReplayKeyframe> m_keyframes; ///< 关键帧
+};
+
+/**
+ * @brief 回放引擎
+ * 用 GameSession 全速重新执行事件日志，逐个事件核对状态校验值；
+ * 借助关键帧跳转到任意事件，只需从最近的可用关键帧模拟不到一个间隔的事件
+ */
+class ReplayPlayer {
+public:
+  /**
+   * @brief 构造函数
+   * 定位到开局
+   * @param replay 回放（需在引擎使用期间保持有效）
+   */
+  explicit ReplayPlayer(const Replay &replay);
+
+  /**
+   * @brief 回到开局
+   * 按种子重新生成开局地图
+   * @return false 表示开局状态与录制不符
+   */
+  bool restart();
+
+  /**
+   * @brief 执行下一个事件
+   * @return false 表示已到末尾、事件无法执行或校验不符
+   */
+  bool step();
+
+  /**
+   * @brief 跳转到指定事件之后的状态
+   * 从不晚于目标、且之后的撤销不会越过它的最近关键帧出发
+   * @param turn 事件数（0 ~ turns()）
+   * @return false 表示越界或途中校验不符
+   */
+  bool seek(int turn);
+
+  /**
+   * @brief 从头核对整局
+   * @return -1 表示全部一致；否则为第一个不一致的事件号（0 表示开局）
+   */
+  int verify();
+
+  // 获取当前已执行的事件数
+  int turn() const { return m_turn; }
+
+  // 获取当前会话
+  const GameSession &session() const { return m_session; }
+
+private:
+  /**
+   * @brief 从关键帧恢复
+   */
+  void loadKeyframe(const ReplayKeyframe &keyframe);
+
+  const Replay &m_replay; ///< 回放
+  GameSession m_session;  ///< 模拟会话
+  int m_turn;             ///< 已执行的事件数
+  int m_origin;           ///< 撤销历史的起点（开局或关键帧的事件数）
+};
+
+namespace replay_detail {
+
+// 回放文件头与语料标志列共用的标志位
+const uint8_t FLAG_PLAYABLE = 1;       ///< 补充策略为 REFILL_PLAYABLE
+const uint8_t FLAG_COLUMN_STREAMS = 2; ///< 使用分列补充流
+
+/**
+ * @brief 输出失败原因
+ * 回放与语料读写共用
+ * @param error 可选，失败原因
+ * @param message 原因
+ * @return 总是 false
+ */
+inline bool fail(std::string *error, const char *message) {
+  if (error) {
+    *error = message;
+  }
+  return false;
+}
+
+} // namespace replay_detail
+
+#endif // REPLAY_H
@@ -0,0 +1,411 @@
+#include "ReplayCorpus.h"
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+const char FILE_MAGIC[4] = {'B', 'J', 'R', 'C'};  ///< 文件头标识
+const char BLOCK_MAGIC[4] = {'B', 'J', 'C', 'B'}; ///< 块头标识
+
+using replay_detail::FLAG_COLUMN_STREAMS;
+using replay_detail::FLAG_PLAYABLE;
+using replay_detail::fail;
+
+/**
+ * @brief 块内各列相对块首的偏移
+ */
+struct BlockLayout {
+  uint64_t seeds;       ///< 种子列
+  uint64_t eventStarts; ///< 事件起点列
+  uint64_t finalScores; ///< 最终分数列
+  uint64_t flags;       ///< 标志列
+  uint64_t deltas;      ///< 时间间隔列
+  uint64_t checks;      ///< 校验值列
+  uint64_t scores;      ///< 分数列
+  uint64_t codes;       ///< 事件编码列
+  uint64_t total;       ///< 块总字节数
+};
+
+// 补齐到 8 字节
+uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+/**
+ * @brief 计算块布局
+ * @param games 对局数
+ * @param events 事件数
+ * @return 各列偏移
+ */
+BlockLayout layoutOf(uint64_t games, uint64_t events) {
+  BlockLayout layout;
+  uint64_t pos = ReplayCorpus::BLOCK_HEADER_SIZE;
+  layout.seeds = pos;
+  pos = align8(pos + games * sizeof(uint64_t));
+  layout.eventStarts = pos;
+  pos = align8(pos + (games + 1) * sizeof(uint32_t));
+  layout.finalScores = pos;
+  pos = align8(pos + games * sizeof(int32_t));
+  layout.flags = pos;
+  pos = align8(pos + games);
+  layout.deltas = pos;
+  pos = align8(pos + events * sizeof(uint32_t));
+  layout.checks = pos;
+  pos = align8(pos + events * sizeof(uint32_t));
+  layout.scores = pos;
+  pos = align8(pos + events * sizeof(int32_t));
+  layout.codes = pos;
+  layout.total = align8(pos + events);
+  return layout;
+}
+
+/**
+ * @brief 块头
+ */
+struct BlockHeader {
+  char magic[4];       ///< "BJCB"
+  uint32_t games;      ///< 对局数
+  uint32_t events;     ///< 事件数
+  uint32_t reserved;   ///< 保留，写 0
+  uint64_t blockBytes; ///< 块总字节数（含块头）
+};
+
+static_assert(sizeof(BlockHeader) == ReplayCorpus::BLOCK_HEADER_SIZE,
+              "块头需与文件格式一致");
+
+/**
+ * @brief 文件头
+ */
+struct FileHeader {
+  char magic[4];       ///< "BJRC"
+  uint16_t version;    ///< 文件格式版本
+  uint8_t rows;        ///< 行数
+  uint8_t cols;        ///< 列数
+  uint8_t kinds;       ///< 宝石种类
+  uint8_t reserved[7]; ///< 保留，写 0
+};
+
+static_assert(sizeof(FileHeader) == ReplayCorpus::FILE_HEADER_SIZE,
+              "文件头需与文件格式一致");
+
+// 本程序写出的文件头
+FileHeader currentHeader() {
+  FileHeader header = {};
+  std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+  header.version = ReplayCorpus::FORMAT_VERSION;
+  header.rows = ROW;
+  header.cols = COL;
+  header.kinds = GEM_KIND;
+  return header;
+}
+
+/**
+ * @brief 校验文件头
+ * @return nullptr 表示有效，否则为失败原因
+ */
+const char *checkHeader(const FileHeader &header) {
+  if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+    return "不是回放语料文件";
+  }
+  if (header.version != ReplayCorpus::FORMAT_VERSION) {
+    return "不支持的语料版本";
+  }
+  if (header.rows != ROW || header.cols != COL || header.kinds != GEM_KIND) {
+    return "棋盘尺寸或宝石种类不符";
+  }
+  return nullptr;
+}
+
+/**
+ * @brief 块头是否完整
+ * @param header 块头
+ * @param available 从块首到文件末尾的字节数
+ * @return true 表示块头有效且整块都在文件内
+ */
+bool blockComplete(const BlockHeader &header, uint64_t available) {
+  return std::memcmp(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) == 0 &&
+         header.blockBytes == layoutOf(header.games, header.events).total &&
+         header.blockBytes <= available;
+}
+
+// 写一列并补齐到 8 字节
+template <class T>
+void writeColumn(std::ofstream &file, const std::vector<T> &column) {
+  static const char zeros[8] = {};
+  const uint64_t bytes = column.size() * sizeof(T);
+  file.write(reinterpret_cast<const char *>(column.data()),
+             static_cast<std::streamsize>(bytes));
+  file.write(zeros, static_cast<std::streamsize>(align8(bytes) - bytes));
+}
+
+} // namespace
+
+/**
+ * @brief ReplayCorpus构造函数实现
+ */
+ReplayCorpus::ReplayCorpus()
+    : m_gameCount(0), m_eventCount(0), m_tornBytes(0) {}
+
+/**
+ * @brief 映射并校验语料文件实现
+ * 每块只检查块头与事件起点列，各列指针直接指向映射
+ * @param path 文件路径
+ * @param error 失败原因
+ * @return true 表示打开成功
+ */
+bool ReplayCorpus::open(const std::string &path, std::string *error) {
+  close();
+  if (!m_file.open(path)) {
+    return fail(error, "无法映射语料文件");
+  }
+  const uint8_t *data = m_file.data();
+  const uint64_t size = m_file.size();
+  FileHeader header;
+  if (size < sizeof(header)) {
+    close();
+    return fail(error, "不是回放语料文件");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (const char *message = checkHeader(header)) {
+    close();
+    return fail(error, message);
+  }
+
+  uint64_t pos = FILE_HEADER_SIZE;
+  while (size - pos >= BLOCK_HEADER_SIZE) {
+    BlockHeader blockHeader;
+    std::memcpy(&blockHeader, data + pos, sizeof(blockHeader));
+    if (!blockComplete(blockHeader, size - pos)) {
+      break;
+    }
+    const uint8_t *base = data + pos;
+    const BlockLayout layout = layoutOf(blockHeader.games, blockHeader.events);
+    Block block;
+    block.firstGame = m_gameCount;
+    block.games = blockHeader.games;
+    block.seeds = reinterpret_cast<const uint64_t *>(base + layout.seeds);
+    block.eventStarts =
+        reinterpret_cast<const uint32_t *>(base + layout.eventStarts);
+    block.finalScores =
+        reinterpret_cast<const int32_t *>(base + layout.finalScores);
+    block.flags = base + layout.flags;
+    block.deltas = reinterpret_cast<const uint32_t *>(base + layout.deltas);
+    block.checks = reinterpret_cast<const uint32_t *>(base + layout.checks);
+    block.scores = reinterpret_cast<const int32_t *>(base + layout.scores);
+    block.codes = base + layout.codes;
+
+    // 事件起点必须单调且止于事件数，之后按它取列时才不会越界
+    bool valid = block.eventStarts[0] == 0 &&
+                 block.eventStarts[block.games] == blockHeader.events;
+    for (uint32_t g = 0; valid && g < block.games; g++) {
+      valid = block.eventStarts[g] <= block.eventStarts[g + 1];
+    }
+    if (!valid) {
+      close();
+      return fail(error, "语料块的事件起点列损坏");
+    }
+    m_blocks.push_back(block);
+    m_gameCount += blockHeader.games;
+    m_eventCount += blockHeader.events;
+    pos += blockHeader.blockBytes;
+  }
+  m_tornBytes = size - pos;
+  return true;
+}
+
+/**
+ * @brief 关闭语料实现
+ */
+void ReplayCorpus::close() {
+  m_file.close();
+  m_blocks.clear();
+  m_gameCount = 0;
+  m_eventCount = 0;
+  m_tornBytes = 0;
+}
+
+/**
+ * @brief 获取一局实现
+ * 按块首序号二分查找所在块
+ * @param index 对局序号
+ * @return 零拷贝视图
+ */
+CorpusGame ReplayCorpus::game(uint64_t index) const {
+  auto it = std::upper_bound(
+      m_blocks.begin(), m_blocks.end(), index,
+      [](uint64_t i, const Block &block) { return i < block.firstGame; });
+  const Block &block = *(it - 1);
+  const uint32_t g = static_cast<uint32_t>(index - block.firstGame);
+  const uint32_t start = block.eventStarts[g];
+  CorpusGame game;
+  game.index = index;
+  game.seed = block.seeds[g];
+  game.refillPolicy =
+      (block.flags[g] & FLAG_PLAYABLE) ? REFILL_PLAYABLE : REFILL_RANDOM;
+  game.columnStreams = (block.flags[g] & FLAG_COLUMN_STREAMS) != 0;
+  game.turns = static_cast<int>(block.eventStarts[g + 1] - start);
+  game.finalScore = block.finalScores[g];
+  game.codes = block.codes + start;
+  game.deltas = block.deltas + start;
+  game.checks = block.checks + start;
+  game.scores = block.scores + start;
+  return game;
+}
+
+/**
+ * @brief ReplayCorpusWriter构造函数实现
+ * @param blockGames 每块对局数
+ */
+ReplayCorpusWriter::ReplayCorpusWriter(int blockGames)
+    : m_blockGames(blockGames < 1 ? 1 : blockGames), m_gamesAdded(0),
+      m_truncatedBytes(0), m_eventStarts(1, 0) {}
+
+/**
+ * @brief ReplayCorpusWriter析构函数实现
+ */
+ReplayCorpusWriter::~ReplayCorpusWriter() { close(); }
+
+/**
+ * @brief 打开语料文件以追加实现
+ * @param path 文件路径
+ * @param error 失败原因
+ * @return true 表示打开成功
+ */
+bool ReplayCorpusWriter::open(const std::string &path, std::string *error) {
+  close();
+  m_gamesAdded = 0;
+  m_truncatedBytes = 0;
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec)) {
+    std::ofstream create(path, std::ios::binary);
+    const FileHeader header = currentHeader();
+    create.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!create) {
+      return fail(error, "无法创建语料文件");
+    }
+  } else {
+    // 依次跳过完整的块，找到有效数据的末尾
+    std::ifstream in(path, std::ios::binary);
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+      return fail(error, "不是回放语料文件");
+    }
+    if (const char *message = checkHeader(header)) {
+      return fail(error, message);
+    }
+    const uint64_t size = std::filesystem::file_size(path, ec);
+    uint64_t pos = sizeof(header);
+    BlockHeader blockHeader;
+    while (size - pos >= sizeof(blockHeader) &&
+           in.seekg(static_cast<std::streamoff>(pos)) &&
+           in.read(reinterpret_cast<char *>(&blockHeader),
+                   sizeof(blockHeader)) &&
+           blockComplete(blockHeader, size - pos)) {
+      pos += blockHeader.blockBytes;
+    }
+    in.close();
+    if (pos < size) {
+      std::filesystem::resize_file(path, pos, ec);
+      if (ec) {
+        return fail(error, "无法截掉语料末尾不完整的块");
+      }
+      m_truncatedBytes = size - pos;
+    }
+  }
+  m_file.open(path, std::ios::binary | std::ios::app);
+  if (!m_file) {
+    return fail(error, "无法打开语料文件");
+  }
+  return true;
+}
+
+/**
+ * @brief 追加一局实现
+ * @param replay 回放
+ * @param error 失败原因
+ * @return false 表示未打开或回放与规则不符
+ */
+bool ReplayCorpusWriter::add(const Replay &replay, std::string *error) {
+  if (!m_file.is_open()) {
+    return fail(error, "语料文件未打开");
+  }
+  ReplayPlayer player(replay);
+  if (!player.restart()) {
+    return fail(error, "回放开局校验不符");
+  }
+  const size_t first = m_scores.size();
+  for (int i = 0; i < replay.turns(); i++) {
+    if (!player.step()) {
+      m_scores.resize(first);
+      return fail(error, "回放事件校验不符");
+    }
+    m_scores.push_back(player.session().score());
+  }
+  for (int i = 0; i < replay.turns(); i++) {
+    const ReplayEvent &event = replay.event(i);
+    m_codes.push_back(event.code);
+    m_deltas.push_back(event.deltaMs);
+    m_checks.push_back(event.check);
+  }
+  m_seeds.push_back(replay.seed());
+  m_eventStarts.push_back(static_cast<uint32_t>(m_codes.size()));
+  m_finalScores.push_back(player.session().score());
+  m_flags.push_back(
+      (replay.refillPolicy() == REFILL_PLAYABLE ? FLAG_PLAYABLE : 0) |
+      (replay.columnStreams() ? FLAG_COLUMN_STREAMS : 0));
+  m_gamesAdded++;
+  if (static_cast<int>(m_seeds.size()) >= m_blockGames) {
+    return flush();
+  }
+  return true;
+}
+
+/**
+ * @brief 把暂存的对局写成一块实现
+ * 块头最先写出，块尾未写完时读取方按块总字节数识别出残块
+ * @return false 表示写入失败
+ */
+bool ReplayCorpusWriter::flush() {
+  if (!m_file.is_open()) {
+    return false;
+  }
+  if (m_seeds.empty()) {
+    return true;
+  }
+  BlockHeader header = {};
+  std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+  header.games = static_cast<uint32_t>(m_seeds.size());
+  header.events = static_cast<uint32_t>(m_codes.size());
+  header.blockBytes = layoutOf(header.games, header.events).total;
+  m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeColumn(m_file, m_seeds);
+  writeColumn(m_file, m_eventStarts);
+  writeColumn(m_file, m_finalScores);
+  writeColumn(m_file, m_flags);
+  writeColumn(m_file, m_deltas);
+  writeColumn(m_file, m_checks);
+  writeColumn(m_file, m_scores);
+  writeColumn(m_file, m_codes);
+  m_file.flush();
+
+  m_seeds.clear();
+  m_eventStarts.assign(1, 0);
+  m_finalScores.clear();
+  m_flags.clear();
+  m_deltas.clear();
+  m_checks.clear();
+  m_scores.clear();
+  m_codes.clear();
+  return static_cast<bool>(m_file);
+}
+
+/**
+ * @brief 写出暂存的对局并关闭文件实现
+ * @return false 表示写入失败
+ */
+bool ReplayCorpusWriter::close() {
+  if (!m_file.is_open()) {
+    return true;
+  }
+  const bool ok = flush();
+  m_file.close();
+  return ok;
+}
@@ -0,0 +1,294 @@
+#ifndef REPLAYCORPUS_H
+#define REPLAYCORPUS_H
+
+#include "MappedFile.h"
+#include "Replay.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 语料中的一局（零拷贝视图）
+ * 各指针直接指向内存映射中的列，语料关闭后失效
+ */
+struct CorpusGame {
+  uint64_t index;            ///< 在语料中的序号
+  uint64_t seed;             ///< 开局种子
+  RefillPolicy refillPolicy; ///< 补充策略
+  bool columnStreams;        ///< 是否使用分列补充流
+  int turns;                 ///< 事件数
+  int finalScore;            ///< 结束时的分数
+  const uint8_t *codes;      ///< 事件编码，见 Replay::encodeMove()
+  const uint32_t *deltas;    ///< 距上一事件的时间（毫秒）
+  const uint32_t *checks;    ///< 事件结算后的状态校验值
+  const int32_t *scores;     ///< 事件结算后的分数
+};
+
+/**
+ * @brief 回放语料
+ * 大量对局按列存放在一个文件中，内存映射后零拷贝读取，可分派到多个线程并行分析。
+ * 文件由若干块组成，每块是一批对局的各列；追加只在文件末尾写新块，
+ * 写到一半中断留下的残块在读取时忽略、在下次追加时截掉。
+ *
+ * 文件格式（本机字节序，即小端序）：
+ *   文件头 16 字节  "BJRC"、版本、行列数与宝石种类
+ *   每块   24 字节块头："BJCB"、对局数 g、事件数 e、保留、块总字节数；
+ *          随后各列依次存放，每列补齐到 8 字节：
+ *          种子 u64[g]、事件起点 u32[g+1]、最终分数 i32[g]、标志 u8[g]、
+ *          时间间隔 u32[e]、校验值 u32[e]、分数 i32[e]、事件编码 u8[e]
+ * 分数列在写入时由重新模拟得到，得分曲线一类查询无需再模拟；
+ * 需要棋盘状态的查询用 CorpusSimulator 按需重新模拟
+ */
+class ReplayCorpus {
+public:
+  static const int FORMAT_VERSION = 1;        ///< 文件格式版本
+  static const int FILE_HEADER_SIZE = 16;     ///< 文件头字节数
+  static const int BLOCK_HEADER_SIZE = 24;    ///< 块头字节数
+  static const int DEFAULT_CHUNK_GAMES = 256; ///< 并行分析时每次领取的对局数
+
+  /**
+   * @brief 构造函数
+   * 创建空语料，需调用 open()
+   */
+  ReplayCorpus();
+
+  /**
+   * @brief 映射并校验语料文件
+   * 校验文件头与每个块的结构；末尾不完整的块被忽略（见 tornBytes()）
+   * @param path 文件路径
+   * @param error 可选，失败时输出原因
+   * @return true 表示打开成功
+   */
+  bool open(const std::string &path, std::string *error = nullptr);
+
+  /**
+   * @brief 关闭语料
+   * 之前取得的 CorpusGame 全部失效
+   */
+  void close();
+
+  // 获取对局数
+  uint64_t gameCount() const { return m_gameCount; }
+
+  // 获取事件总数
+  uint64_t eventCount() const { return m_eventCount; }
+
+  // 获取块数
+  int blockCount() const { return static_cast<int>(m_blocks.size()); }
+
+  // 获取末尾被忽略的不完整字节数
+  uint64_t tornBytes() const { return m_tornBytes; }
+
+  /**
+   * @brief 获取一局
+   * @param index 对局序号（小于 gameCount()）
+   * @return 零拷贝视图
+   */
+  CorpusGame game(uint64_t index) const;
+
+  /**
+   * @brief 并行遍历全部对局
+   * 对局按块顺序切成若干段，各工作线程从共享计数器领取下一段，直到领完；
+   * fn(worker, game) 在线程池中调用，worker 为 0 ~ pool.size()-1，
+   * 同一 worker 的调用不会并发，可用它索引各线程独立的累加器
+   * @param pool 线程池
+   * @param fn 回调
+   * @param chunkGames 每段对局数
+   */
+  template <class Fn>
+  void forEachGame(ThreadPool &pool, Fn fn,
+                   int chunkGames = DEFAULT_CHUNK_GAMES) const {
+    const uint64_t chunk = chunkGames < 1 ? 1 : chunkGames;
+    std::atomic<uint64_t> next(0);
+    std::vector<std::future<void>> done;
+    for (int w = 0; w < pool.size(); w++) {
+      done.push_back(pool.submit([this, &fn, &next, chunk, w]() {
+        for (;;) {
+          const uint64_t begin = next.fetch_add(chunk);
+          if (begin >= m_gameCount) {
+            return;
+          }
+          const uint64_t end = std::min(begin + chunk, m_gameCount);
+          for (uint64_t i = begin; i < end; i++) {
+            fn(w, game(i));
+          }
+        }
+      }));
+    }
+    for (std::future<void> &f : done) {
+      f.get();
+    }
+  }
+
+private:
+  /**
+   * @brief 一个块中各列的位置
+   */
+  struct Block {
+    uint64_t firstGame;          ///< 块中第一局在语料中的序号
+    uint32_t games;              ///< 对局数
+    const uint64_t *seeds;       ///< 种子列
+    const uint32_t *eventStarts; ///< 事件起点列（games + 1 项）
+    const int32_t *finalScores;  ///< 最终分数列
+    const uint8_t *flags;        ///< 标志列
+    const uint32_t *deltas;      ///< 时间间隔列
+    const uint32_t *checks;      ///< 校验值列
+    const int32_t *scores;       ///< 分数列
+    const uint8_t *codes;        ///< 事件编码列
+  };
+
+  MappedFile m_file;           ///< 内存映射
+  std::vector<Block> m_blocks; ///< 各块
+  uint64_t m_gameCount;        ///< 对局数
+  uint64_t m_eventCount;       ///< 事件总数
+  uint64_t m_tornBytes;        ///< 末尾被忽略的字节数
+};
+
+/**
+ * @brief 语料追加写入器
+ * 回放先在内存中按列暂存，攒满一块后写到文件末尾
+ */
+class ReplayCorpusWriter {
+public:
+  static const int DEFAULT_BLOCK_GAMES = 4096; ///< 默认每块对局数
+
+  /**
+   * @brief 构造函数
+   * @param blockGames 每块对局数
+   */
+  explicit ReplayCorpusWriter(int blockGames = DEFAULT_BLOCK_GAMES);
+
+  /**
+   * @brief 析构函数
+   * 写出暂存的对局
+   */
+  ~ReplayCorpusWriter();
+
+  ReplayCorpusWriter(const ReplayCorpusWriter &) = delete;
+  ReplayCorpusWriter &operator=(const ReplayCorpusWriter &) = delete;
+
+  /**
+   * @brief 打开语料文件以追加
+   * 文件不存在时创建；存在时校验文件头并截掉末尾不完整的块
+   * （上次写入中断留下的），截掉的字节数由 truncatedBytes() 获取
+   * @param path 文件路径
+   * @param error 可选，失败时输出原因
+   * @return true 表示打开成功
+   */
+  bool open(const std::string &path, std::string *error = nullptr);
+
+  /**
+   * @brief 追加一局
+   * 重新模拟整局，核对每个事件的校验值并得到分数列
+   * @param replay 回放
+   * @param error 可选，失败时输出原因
+   * @return false 表示未打开或回放与规则不符（不写入）
+   */
+  bool add(const Replay &replay, std::string *error = nullptr);
+
+  /**
+   * @brief 把暂存的对局写成一块
+   * @return false 表示写入失败
+   */
+  bool flush();
+
+  /**
+   * @brief 写出暂存的对局并关闭文件
+   * @return false 表示写入失败
+   */
+  bool close();
+
+  // 获取本次打开后追加的对局数
+  uint64_t gamesAdded() const { return m_gamesAdded; }
+
+  // 获取本次打开时截掉的不完整块的字节数
+  uint64_t truncatedBytes() const { return m_truncatedBytes; }
+
+private:
+  int m_blockGames;                    ///< 每块对局数
+  std::ofstream m_file;                ///< 输出文件
+  uint64_t m_gamesAdded;               ///< 已追加的对局数
+  uint64_t m_truncatedBytes;           ///< 打开时截掉的字节数
+  std::vector<uint64_t> m_seeds;       ///< 暂存：种子
+  std::vector<uint32_t> m_eventStarts; ///< 暂存：事件起点
+  std::vector<int32_t> m_finalScores;  ///< 暂存：最终分数
+  std::vector<uint8_t> m_flags;        ///< 暂存：标志
+  std::vector<uint32_t> m_deltas;      ///< 暂存：时间间隔
+  std::vector<uint32_t> m_checks;      ///< 暂存：校验值
+  std::vector<int32_t> m_scores;       ///< 暂存：分数
+  std::vector<uint8_t> m_codes;        ///< 暂存：事件编码
+};
+
+/**
+ * @brief 语料对局的重新模拟器
+ * 持有一个复用的会话，每个线程各用一个。visitor 需提供：
+ *   void eliminated(int event, GameMap::Mask matched)  每个消除阶段之前
+ *   void eventDone(int event, const GameSession &session, int cascades)
+ *                                                      每个事件结算之后
+ */
+class CorpusSimulator {
+public:
+  /**
+   * @brief 构造函数
+   */
+  CorpusSimulator() : m_session(0) {}
+
+  /**
+   * @brief 重新模拟一局
+   * 逐阶段推进以便观察每次消除，并核对每个事件的校验值
+   * @param game 对局
+   * @param visitor 观察者
+   * @return -1 表示全部一致，否则为第一个不一致事件的序号（从 0 开始）
+   */
+  template <class Visitor>
+  int run(const CorpusGame &game, Visitor &visitor) {
+    GameMap &map = m_session.map();
+    map.setSeed(game.seed);
+    map.setRefillPolicy(game.refillPolicy);
+    map.setColumnStreams(game.columnStreams);
+    m_session.newGame();
+    for (int i = 0; i < game.turns; i++) {
+      const uint8_t code = game.codes[i];
+      int cascades = 0;
+      if (code == Replay::CODE_UNDO) {
+        if (!m_session.undo()) {
+          return i;
+        }
+      } else if (code == Replay::CODE_SCORE_RESET) {
+        m_session.setScore(0);
+      } else {
+        const Move move = Replay::decodeMove(code);
+        if (code >= ROW * COL * 2 ||
+            !m_session.trySwap(move.r1, move.c1, move.r2, move.c2)) {
+          return i;
+        }
+        for (;;) {
+          const GameMap::Mask matched = map.matchMask();
+          if (matched) {
+            visitor.eliminated(i, matched);
+          }
+          const StepResult result = m_session.step();
+          if (result == STEP_ELIMINATED) {
+            cascades++;
+          } else if (result == STEP_SETTLED || result == STEP_RESHUFFLED) {
+            break;
+          }
+        }
+      }
+      if (static_cast<uint32_t>(Replay::stateHash(m_session)) !=
+          game.checks[i]) {
+        return i;
+      }
+      visitor.eventDone(i, m_session, cascades);
+    }
+    return -1;
+  }
+
+private:
+  GameSession m_session; ///< 复用的会话
+};
+
+#endif // REPLAYCORPUS_H
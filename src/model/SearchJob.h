@@ -0,0 +1,186 @@
+#ifndef SEARCHJOB_H
+#define SEARCHJOB_H
+
+#include "GameMap.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief 搜索的作废标记
+ * 异步搜索登记时取得一个代数，工作线程的代数变化后该搜索即作废；
+ * 同步搜索不关联代数，永不作废
+ */
+struct SearchTicket {
+  const std::atomic<uint64_t> *generation; ///< 所属工作线程的代数，空表示同步
+  uint64_t ticket;                         ///< 登记时的代数
+
+  SearchTicket() : generation(nullptr), ticket(0) {}
+
+  // 是否已被更新的任务取代
+  bool cancelled() const {
+    return generation != nullptr &&
+           generation->load(std::memory_order_relaxed) != ticket;
+  }
+};
+
+/**
+ * @brief 搜索输入的公共部分
+ * 根局面按值复制，可安全地交给其他线程；提示引擎与自动对局器在此基础上
+ * 增加各自的搜索参数
+ * @tparam MapType 地图类型
+ */
+template <class MapType> struct BasicSearchJob {
+  typedef std::chrono::steady_clock Clock; ///< 截止时间所用的时钟
+
+  typename MapType::Snapshot root;  ///< 根局面
+  RefillPolicy refill;              ///< 补充策略（与实际对局一致）
+  typename MapType::MoveList moves; ///< 根局面的合法交换
+  uint64_t seed;                    ///< 随机种子
+  Clock::time_point deadline;       ///< 截止时间
+  SearchTicket cancel;              ///< 作废标记（异步搜索被取代时停止）
+
+  /**
+   * @brief 从地图复制根局面并设定截止时间
+   * @param map 当前地图（只在调用期间读取）
+   * @param searchSeed 随机种子
+   * @param timeBudgetMs 时间预算（毫秒）
+   */
+  void capture(const MapType &map, uint64_t searchSeed, int timeBudgetMs) {
+    map.saveSnapshot(root);
+    refill = map.refillPolicy();
+    map.findMoves(moves);
+    seed = searchSeed;
+    deadline =
+        Clock::now() + std::chrono::milliseconds(std::max(0, timeBudgetMs));
+  }
+};
+
+namespace search_detail {
+
+/**
+ * @brief 在模拟地图上执行一次交换并结算全部连锁
+ * 提示引擎与自动对局器共用，与 GameSession 的回合结算得分一致
+ * @param sim 模拟地图
+ * @param move 交换
+ * @return 本回合得分
+ */
+template <class MapType> int playMove(MapType &sim, const Move &move) {
+  sim.swap(move.r1, move.c1, move.r2, move.c2);
+  int points = 0;
+  for (;;) {
+    const typename MapType::Mask mask = sim.checkMatchMask();
+    if (!mask) {
+      break;
+    }
+    points += sim.maskScore(mask);
+    sim.eliminate(mask);
+    sim.applyGravity();
+  }
+  return points;
+}
+
+} // namespace search_detail
+
+/**
+ * @brief 只执行最新任务的后台搜索线程
+ * 长驻一个协调线程，第一次登记任务时启动。post() 只保存任务并唤醒线程，
+ * 调用方从不等待；新任务到达时旧任务作废，搜索在下一次检查作废标记时放弃，
+ * 作废的结果不回调。析构时作废当前任务并回收线程
+ * @tparam Job 搜索输入，需有 SearchTicket 类型的成员 cancel
+ * @tparam Result 搜索结果
+ */
+template <class Job, class Result> class LatestSearchWorker {
+public:
+  typedef std::function<Result(const Job &)> Search;    ///< 搜索函数
+  typedef std::function<void(const Result &)> Callback; ///< 完成回调
+
+  /**
+   * @brief 构造函数
+   * @param search 在协调线程中执行的搜索函数
+   */
+  explicit LatestSearchWorker(Search search)
+      : m_search(std::move(search)), m_generation(0), m_hasJob(false),
+        m_stopping(false) {}
+
+  /**
+   * @brief 析构函数
+   * 作废进行中的搜索，等待协调线程退出
+   */
+  ~LatestSearchWorker() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+      m_generation.fetch_add(1);
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  LatestSearchWorker(const LatestSearchWorker &) = delete;
+  LatestSearchWorker &operator=(const LatestSearchWorker &) = delete;
+
+  /**
+   * @brief 登记任务
+   * 取代尚未开始或正在进行的上一个任务，立即返回
+   * @param job 搜索输入（其 cancel 成员在此设置）
+   * @param done 完成回调（在协调线程执行）
+   */
+  void post(Job job, Callback done) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      job.cancel.generation = &m_generation;
+      job.cancel.ticket = m_generation.fetch_add(1) + 1;
+      m_job = std::move(job);
+      m_done = std::move(done);
+      m_hasJob = true;
+      if (!m_thread.joinable()) {
+        m_thread = std::thread(&LatestSearchWorker::loop, this);
+      }
+    }
+    m_wake.notify_one();
+  }
+
+private:
+  Search m_search;                    ///< 搜索函数
+  std::atomic<uint64_t> m_generation; ///< 任务代数，每次登记或析构加一
+  std::mutex m_mutex;                 ///< 保护待执行任务
+  std::condition_variable m_wake;     ///< 新任务或停止通知
+  Job m_job;                          ///< 待执行任务
+  Callback m_done;                    ///< 待执行任务的回调
+  bool m_hasJob;                      ///< 是否有待执行任务
+  bool m_stopping;                    ///< 是否正在停止
+  std::thread m_thread;               ///< 协调线程
+
+  // 协调线程主循环：取出最新任务执行，未作废时回调
+  void loop() {
+    for (;;) {
+      Job job;
+      Callback done;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this]() { return m_stopping || m_hasJob; });
+        if (m_stopping) {
+          return;
+        }
+        job = std::move(m_job);
+        done = std::move(m_done);
+        m_hasJob = false;
+      }
+      const Result result = m_search(job);
+      if (done && !job.cancel.cancelled()) {
+        done(result);
+      }
+    }
+  }
+};
+
+#endif // SEARCHJOB_H
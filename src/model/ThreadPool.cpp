@@ -0,0 +1,54 @@
+#include "ThreadPool.h"
+
+/**
+ * @brief ThreadPool构造函数实现
+ * @param threads 工作线程数，0 表示使用硬件并发数
+ */
+ThreadPool::ThreadPool(int threads) : m_stopping(false) {
+  if (threads <= 0) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  if (threads <= 0) {
+    threads = 1; // 无法获取硬件并发数时至少保留一个线程
+  }
+  for (int i = 0; i < threads; i++) {
+    m_workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+/**
+ * @brief ThreadPool析构函数实现
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  for (std::thread &worker : m_workers) {
+    worker.join();
+  }
+}
+
+// 获取工作线程数
+int ThreadPool::size() const { return static_cast<int>(m_workers.size()); }
+
+/**
+ * @brief 工作线程主循环实现
+ * 队列为空时等待；停止后仍会先把队列中剩余任务执行完
+ */
+void ThreadPool::workerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+      if (m_tasks.empty()) {
+        return; // 已停止且没有剩余任务
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop();
+    }
+    task();
+  }
+}
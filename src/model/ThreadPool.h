@@ -0,0 +1,71 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 固定大小的线程池
+ * 启动时创建全部工作线程，任务按提交顺序从共享队列中取出执行；
+ * 析构时等待队列中已有的任务执行完毕
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数，0 表示使用硬件并发数
+   */
+  explicit ThreadPool(int threads = 0);
+
+  /**
+   * @brief 析构函数
+   * 等待已提交的任务全部完成后回收线程
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief 获取工作线程数
+   * @return 线程数
+   */
+  int size() const;
+
+  /**
+   * @brief 提交任务
+   * @param task 无参数、无返回值的任务
+   * @return 任务完成时就绪的 future（任务抛出的异常由 get() 重新抛出）
+   */
+  template <class Task> std::future<void> submit(Task task) {
+    auto packaged =
+        std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> done = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push([packaged]() { (*packaged)(); });
+    }
+    m_wake.notify_one();
+    return done;
+  }
+
+private:
+  std::vector<std::thread> m_workers;        ///< 工作线程
+  std::queue<std::function<void()>> m_tasks; ///< 待执行任务
+  std::mutex m_mutex;                        ///< 保护任务队列
+  std::condition_variable m_wake;            ///< 新任务或停止通知
+  bool m_stopping;                           ///< 是否正在停止
+
+  /**
+   * @brief 工作线程主循环
+   */
+  void workerLoop();
+};
+
+#endif // THREADPOOL_H
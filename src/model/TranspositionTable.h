@@ -0,0 +1,113 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief 定长无锁置换表
+ * 槽位数为 2 的幂，按哈希低位直接定位，新条目总是覆盖旧条目。
+ * 每个槽位由若干 64 位原子字组成：数据字加一个校验字，
+ * 校验字存放“键 ^ 所有数据字”。读写都不加锁，多个线程同时写同一槽位时
+ * 读到的字可能来自不同的写入，此时校验不通过，按未命中处理
+ * @tparam Payload 条目数据（需可平凡复制）
+ */
+template <class Payload> class TranspositionTable {
+  static_assert(std::is_trivially_copyable<Payload>::value,
+                "条目数据按字节拷贝进原子字");
+
+public:
+  static const int WORDS = (sizeof(Payload) + 7) / 8; ///< 每个条目的数据字数
+
+  /**
+   * @brief 构造函数
+   * @param bytes 内存预算，取不超过预算的最大 2 的幂个槽位（至少 1 个）
+   */
+  explicit TranspositionTable(size_t bytes) : m_mask(0) {
+    size_t slots = 1;
+    while (slots * 2 * sizeof(Slot) <= bytes) {
+      slots *= 2;
+    }
+    m_slots.reset(new Slot[slots]);
+    m_mask = slots - 1;
+    clear();
+  }
+
+  TranspositionTable(const TranspositionTable &) = delete;
+  TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+  /**
+   * @brief 查询
+   * @param key 局面哈希
+   * @param value 命中时输出条目数据
+   * @return true 表示命中
+   */
+  bool probe(uint64_t key, Payload &value) const {
+    const Slot &slot = m_slots[key & m_mask];
+    uint64_t words[WORDS];
+    uint64_t check = slot.check.load(std::memory_order_acquire);
+    for (int i = 0; i < WORDS; i++) {
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+      check ^= words[i];
+    }
+    if (check != key) {
+      return false;
+    }
+    std::memcpy(&value, words, sizeof(Payload));
+    return true;
+  }
+
+  /**
+   * @brief 写入
+   * @param key 局面哈希
+   * @param value 条目数据
+   */
+  void store(uint64_t key, const Payload &value) {
+    Slot &slot = m_slots[key & m_mask];
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(Payload));
+    uint64_t check = key;
+    for (int i = 0; i < WORDS; i++) {
+      slot.words[i].store(words[i], std::memory_order_relaxed);
+      check ^= words[i];
+    }
+    slot.check.store(check, std::memory_order_release);
+  }
+
+  /**
+   * @brief 清空
+   * 全部字清零。空槽位只与哈希 0 匹配，Zobrist.h 让空棋盘的哈希也不为 0
+   */
+  void clear() {
+    for (size_t s = 0; s <= m_mask; s++) {
+      m_slots[s].check.store(0, std::memory_order_relaxed);
+      for (int i = 0; i < WORDS; i++) {
+        m_slots[s].words[i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief 获取槽位数
+   * @return 槽位数
+   */
+  size_t size() const { return m_mask + 1; }
+
+private:
+  /**
+   * @brief 槽位
+   */
+  struct Slot {
+    std::atomic<uint64_t> check;        ///< 键 ^ 所有数据字
+    std::atomic<uint64_t> words[WORDS]; ///< 条目数据
+  };
+
+  std::unique_ptr<Slot[]> m_slots; ///< 槽位数组
+  size_t m_mask;                   ///< 槽位数 - 1
+};
+
+#endif // TRANSPOSITIONTABLE_H
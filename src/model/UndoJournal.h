@@ -0,0 +1,308 @@
+#ifndef UNDOJOURNAL_H
+#define UNDOJOURNAL_H
+
+#include "BitMask.h"
+#include "Gem.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 增量撤销日志
+ * 每一步只记录本回合内被改写过的格子在回合开始时的值，而不是整张地图。
+ * 最新一步处于“打开”状态，改写格子时首次写入才登记；开始新的一步时
+ * 打开的步骤被封存进固定容量的环形字节缓冲，容量即内存预算，
+ * 超出预算时丢弃最旧的步骤，预算足够时撤销深度不受限制。
+ *
+ * 封存格式：[格子数 u16][分数 i32][格子数 x (格子号 u16, 宝石 u8)][格子数 u16]，
+ * 首尾各存一份格子数，便于从两端弹出
+ * @tparam Cells 地图格子数
+ */
+template <int Cells> class UndoJournal {
+  static_assert(Cells <= 65536, "格子号按 16 位存储");
+
+public:
+  typedef typename MaskFor<Cells>::type Mask; ///< 格子掩码类型
+
+  static const size_t DEFAULT_BUDGET = 64 * 1024; ///< 默认内存预算（字节）
+
+  UndoJournal()
+      : m_budget(DEFAULT_BUDGET), m_head(0), m_used(0), m_sealedSteps(0),
+        m_open(false), m_openScore(0), m_openCount(0), m_touched() {}
+
+  /**
+   * @brief 设置内存预算
+   * 缩小预算时按需丢弃最旧的步骤
+   * @param bytes 环形缓冲的字节数
+   */
+  void setBudget(size_t bytes) {
+    if (bytes == m_budget) {
+      return;
+    }
+    std::vector<uint8_t> old;
+    old.swap(m_ring);
+    const size_t oldHead = m_head;
+    const size_t oldUsed = m_used;
+    const size_t oldSize = old.size();
+    m_budget = bytes;
+    m_head = 0;
+    m_used = 0;
+    if (oldUsed == 0) {
+      return;
+    }
+    // 先丢弃放不下的旧步骤，再把剩余部分按顺序搬入新缓冲
+    size_t skip = 0;
+    size_t steps = m_sealedSteps;
+    while (oldUsed - skip > bytes) {
+      const size_t at = (oldHead + skip) % oldSize;
+      skip += recordSize(old[at] | (old[(at + 1) % oldSize] << 8));
+      steps--;
+    }
+    m_sealedSteps = steps;
+    if (oldUsed == skip) {
+      return;
+    }
+    m_ring.resize(m_budget);
+    for (size_t i = skip; i < oldUsed; i++) {
+      m_ring[m_used++] = old[(oldHead + i) % oldSize];
+    }
+  }
+
+  /**
+   * @brief 获取内存预算
+   * @return 环形缓冲的字节数
+   */
+  size_t budget() const { return m_budget; }
+
+  /**
+   * @brief 获取当前可撤销的步数
+   * @return 步数
+   */
+  size_t depth() const { return m_sealedSteps + (m_open ? 1 : 0); }
+
+  /**
+   * @brief 是否正在记录
+   * 没有打开的步骤时，格子改写不登记
+   * @return true 表示有打开的步骤
+   */
+  bool isOpen() const { return m_open; }
+
+  /**
+   * @brief 开始新的一步
+   * 封存当前打开的步骤（丢弃已改回原值的格子），然后打开新步骤
+   * @param score 本步开始时的分数
+   * @param current 按格子号读取当前宝石的函数
+   */
+  template <class Current> void begin(int score, Current current) {
+    if (m_open) {
+      seal(current);
+    }
+    m_open = true;
+    m_openScore = score;
+    m_openCount = 0;
+    m_touched = Mask();
+  }
+
+  /**
+   * @brief 登记格子改写
+   * 只有本步内首次改写才记录原值
+   * @param cell 格子号
+   * @param before 改写前的宝石
+   */
+  void record(int cell, const Gem &before) {
+    const Mask bit = maskBit<Mask>(cell);
+    if (!m_open || (m_touched & bit)) {
+      return;
+    }
+    m_touched |= bit;
+    m_openCells[m_openCount] = static_cast<uint16_t>(cell);
+    m_openGems[m_openCount] = packGem(before);
+    m_openCount++;
+  }
+
+  /**
+   * @brief 获取最新一步的分数
+   * @return 分数，没有历史记录返回 -1
+   */
+  int topScore() const { return m_open ? m_openScore : -1; }
+
+  /**
+   * @brief 回滚最新一步
+   * 关闭记录后逐格调用 restore(格子号, 原宝石)，再取出上一步作为新的打开步骤
+   * @param restore 写回函数
+   * @param score 输出该步开始时的分数
+   * @return true 表示回滚成功
+   */
+  template <class Restore> bool rollback(Restore restore, int &score) {
+    if (!m_open) {
+      return false;
+    }
+    m_open = false;
+    for (int i = 0; i < m_openCount; i++) {
+      restore(m_openCells[i], unpackGem(m_openGems[i]));
+    }
+    score = m_openScore;
+    unsealNewest();
+    return true;
+  }
+
+  /**
+   * @brief 丢弃最新一步
+   * 不回滚地图：该步的改动并入上一步，上一步撤销时仍能完整还原
+   */
+  void discardTop() {
+    if (!m_open) {
+      return;
+    }
+    const int count = m_openCount;
+    uint16_t cells[Cells];
+    uint8_t gems[Cells];
+    for (int i = 0; i < count; i++) {
+      cells[i] = m_openCells[i];
+      gems[i] = m_openGems[i];
+    }
+    m_open = false;
+    if (!unsealNewest()) {
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      record(cells[i], unpackGem(gems[i]));
+    }
+  }
+
+  /**
+   * @brief 清空日志
+   * 保留已分配的缓冲，新对局开始时不必重新分配
+   */
+  void clear() {
+    m_head = 0;
+    m_used = 0;
+    m_sealedSteps = 0;
+    m_open = false;
+    m_openCount = 0;
+    m_touched = Mask();
+  }
+
+private:
+  static const size_t HEADER_SIZE = 6;  ///< 格子数 + 分数
+  static const size_t TRAILER_SIZE = 2; ///< 格子数
+  static const size_t ENTRY_SIZE = 3;   ///< 格子号 + 宝石
+
+  std::vector<uint8_t> m_ring; ///< 环形缓冲，首次封存时按预算分配
+  size_t m_budget;             ///< 内存预算
+  size_t m_head;               ///< 最旧记录的起始偏移
+  size_t m_used;               ///< 已用字节数
+  size_t m_sealedSteps;        ///< 已封存的步数
+
+  bool m_open;                 ///< 是否有打开的步骤
+  int m_openScore;             ///< 打开步骤的分数
+  int m_openCount;             ///< 打开步骤已登记的格子数
+  Mask m_touched;              ///< 打开步骤已登记的格子
+  uint16_t m_openCells[Cells]; ///< 已登记的格子号
+  uint8_t m_openGems[Cells];   ///< 已登记格子的原值
+
+  // 宝石压缩为一个字节：低 7 位颜色，最高位待消除标记
+  static uint8_t packGem(const Gem &gem) {
+    return static_cast<uint8_t>(gem.type | (gem.isMatched ? 0x80 : 0));
+  }
+
+  static Gem unpackGem(uint8_t packed) {
+    Gem gem(static_cast<GemType>(packed & 0x7f));
+    gem.isMatched = (packed & 0x80) != 0;
+    return gem;
+  }
+
+  static size_t recordSize(size_t count) {
+    return HEADER_SIZE + count * ENTRY_SIZE + TRAILER_SIZE;
+  }
+
+  uint8_t byteAt(size_t offset) const {
+    return m_ring[(m_head + offset) % m_ring.size()];
+  }
+
+  void putByte(size_t offset, uint8_t value) {
+    m_ring[(m_head + offset) % m_ring.size()] = value;
+  }
+
+  // 丢弃最旧的一条记录
+  void dropOldest() {
+    const size_t size = recordSize(byteAt(0) | (byteAt(1) << 8));
+    m_head = (m_head + size) % m_ring.size();
+    m_used -= size;
+    m_sealedSteps--;
+  }
+
+  // 封存打开的步骤，原值与当前值相同的格子不写入
+  template <class Current> void seal(Current current) {
+    int kept = 0;
+    for (int i = 0; i < m_openCount; i++) {
+      if (packGem(current(m_openCells[i])) != m_openGems[i]) {
+        m_openCells[kept] = m_openCells[i];
+        m_openGems[kept] = m_openGems[i];
+        kept++;
+      }
+    }
+    m_open = false;
+
+    const size_t size = recordSize(kept);
+    if (size > m_budget) {
+      // 单步超出预算，无法保留任何历史
+      clear();
+      return;
+    }
+    if (m_ring.size() != m_budget) {
+      m_ring.assign(m_budget, 0);
+      m_head = 0;
+      m_used = 0;
+      m_sealedSteps = 0;
+    }
+    while (m_budget - m_used < size) {
+      dropOldest();
+    }
+
+    size_t at = m_used;
+    const uint32_t score = static_cast<uint32_t>(m_openScore);
+    putByte(at++, static_cast<uint8_t>(kept));
+    putByte(at++, static_cast<uint8_t>(kept >> 8));
+    for (int s = 0; s < 32; s += 8) {
+      putByte(at++, static_cast<uint8_t>(score >> s));
+    }
+    for (int i = 0; i < kept; i++) {
+      putByte(at++, static_cast<uint8_t>(m_openCells[i]));
+      putByte(at++, static_cast<uint8_t>(m_openCells[i] >> 8));
+      putByte(at++, m_openGems[i]);
+    }
+    putByte(at++, static_cast<uint8_t>(kept));
+    putByte(at++, static_cast<uint8_t>(kept >> 8));
+    m_used = at;
+    m_sealedSteps++;
+  }
+
+  // 取出最新的封存记录作为打开步骤
+  bool unsealNewest() {
+    if (m_sealedSteps == 0) {
+      return false;
+    }
+    const size_t count = byteAt(m_used - 2) | (byteAt(m_used - 1) << 8);
+    const size_t start = m_used - recordSize(count);
+    size_t at = start + 2;
+    uint32_t score = 0;
+    for (int s = 0; s < 32; s += 8) {
+      score |= uint32_t(byteAt(at++)) << s;
+    }
+    m_open = true;
+    m_openScore = static_cast<int>(score);
+    m_openCount = 0;
+    m_touched = Mask();
+    for (size_t i = 0; i < count; i++) {
+      const int cell = byteAt(at) | (byteAt(at + 1) << 8);
+      record(cell, unpackGem(byteAt(at + 2)));
+      at += ENTRY_SIZE;
+    }
+    m_used = start;
+    m_sealedSteps--;
+    return true;
+  }
+};
+
+#endif // UNDOJOURNAL_H
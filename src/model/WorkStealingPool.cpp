@@ -0,0 +1,131 @@
+#include "WorkStealingPool.h"
+
+namespace {
+
+thread_local const WorkStealingPool *t_pool = nullptr; ///< 当前线程所属的池
+thread_local int t_index = -1; ///< 当前线程在所属池中的序号
+
+} // namespace
+
+/**
+ * @brief WorkStealingPool构造函数实现
+ * @param threads 工作线程数，0 表示使用硬件并发数
+ */
+WorkStealingPool::WorkStealingPool(int threads)
+    : m_pending(0), m_nextQueue(0), m_steals(0), m_stopping(false) {
+  if (threads <= 0) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  if (threads <= 0) {
+    threads = 1; // 无法获取硬件并发数时至少保留一个线程
+  }
+  for (int i = 0; i < threads; i++) {
+    m_queues.emplace_back(new Queue());
+  }
+  for (int i = 0; i < threads; i++) {
+    m_workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+  }
+}
+
+/**
+ * @brief WorkStealingPool析构函数实现
+ */
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  for (std::thread &worker : m_workers) {
+    worker.join();
+  }
+}
+
+// 获取工作线程数
+int WorkStealingPool::size() const {
+  return static_cast<int>(m_workers.size());
+}
+
+/**
+ * @brief 提交任务实现
+ * 先入队再在休眠锁内增加计数，等待中的线程被唤醒时一定能看到任务
+ * @param task 任务
+ */
+void WorkStealingPool::submit(std::function<void()> task) {
+  if (t_pool == this) {
+    Queue &own = *m_queues[t_index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.tasks.push_back(std::move(task));
+  } else {
+    const unsigned i = m_nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                       m_queues.size();
+    Queue &queue = *m_queues[i];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_pending++;
+  }
+  m_wake.notify_one();
+}
+
+// 获取窃取次数
+uint64_t WorkStealingPool::steals() const {
+  return m_steals.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 取一个任务实现
+ * 自己的队列按后进先出取，刚派生的任务数据仍在缓存中；
+ * 窃取按先进先出，取走最早、通常也最大的工作
+ * @param self 当前工作线程序号
+ * @param task 输出任务
+ * @return false 表示所有队列都为空
+ */
+bool WorkStealingPool::take(int self, std::function<void()> &task) {
+  {
+    Queue &own = *m_queues[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  const int count = static_cast<int>(m_queues.size());
+  for (int k = 1; k < count; k++) {
+    Queue &victim = *m_queues[(self + k) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      m_steals.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 工作线程主循环实现
+ * 没有待取任务时休眠；停止后仍会先把剩余任务执行完
+ * @param self 工作线程序号
+ */
+void WorkStealingPool::workerLoop(int self) {
+  t_pool = this;
+  t_index = self;
+  for (;;) {
+    std::function<void()> task;
+    if (take(self, task)) {
+      m_pending--;
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_wake.wait(lock, [this]() { return m_stopping || m_pending > 0; });
+    if (m_stopping && m_pending == 0) {
+      return; // 已停止且没有剩余任务
+    }
+  }
+}
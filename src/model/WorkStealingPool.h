@@ -0,0 +1,92 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 工作窃取线程池
+ * 每个工作线程有自己的双端队列：工作线程内提交的任务压入自己队列的尾部并从尾部取出，
+ * 外部线程提交的任务轮流分给各队列；自己的队列空了就从其他队列的头部窃取。
+ * 适合大量短小、会继续派生任务的工作（如许多会话各自的结算）；
+ * 析构时等待已提交的任务全部完成
+ */
+class WorkStealingPool {
+public:
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数，0 表示使用硬件并发数
+   */
+  explicit WorkStealingPool(int threads = 0);
+
+  /**
+   * @brief 析构函数
+   * 等待已提交的任务全部完成后回收线程
+   */
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  /**
+   * @brief 获取工作线程数
+   * @return 线程数
+   */
+  int size() const;
+
+  /**
+   * @brief 提交任务
+   * 可在任意线程调用，包括本池的任务内部
+   * @param task 无参数、无返回值的任务（不应抛出异常）
+   */
+  void submit(std::function<void()> task);
+
+  /**
+   * @brief 获取窃取次数
+   * 从其他线程队列取走的任务累计数，用于观察负载是否均衡
+   * @return 次数
+   */
+  uint64_t steals() const;
+
+private:
+  /**
+   * @brief 单个工作线程的任务队列
+   */
+  struct Queue {
+    std::mutex mutex;                        ///< 保护任务队列
+    std::deque<std::function<void()>> tasks; ///< 待执行任务
+  };
+
+  std::vector<std::unique_ptr<Queue>> m_queues; ///< 各工作线程的队列
+  std::vector<std::thread> m_workers;           ///< 工作线程
+  std::mutex m_sleepMutex;                      ///< 保护休眠与停止状态
+  std::condition_variable m_wake;               ///< 新任务或停止通知
+  std::atomic<int> m_pending;                   ///< 已提交未取走的任务数
+  std::atomic<unsigned> m_nextQueue;            ///< 外部提交的轮转位置
+  std::atomic<uint64_t> m_steals;               ///< 窃取次数
+  bool m_stopping;                              ///< 是否正在停止
+
+  /**
+   * @brief 取一个任务
+   * 先从自己队列的尾部取，再依次从其他队列的头部窃取
+   * @param self 当前工作线程序号
+   * @param task 输出任务
+   * @return false 表示所有队列都为空
+   */
+  bool take(int self, std::function<void()> &task);
+
+  /**
+   * @brief 工作线程主循环
+   * @param self 工作线程序号
+   */
+  void workerLoop(int self);
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,35 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Const.h"
+#include "Random.h"
+#include <cstdint>
+
+/**
+ * @brief Zobrist 键表
+ * 每个（格子, 颜色）对应一个 64 位随机键，局面哈希为所有非空格子键的异或，
+ * 改写一个格子只需异或掉旧键、异或进新键。
+ * 键由 splitmix64 在编译期生成，同一尺寸的哈希在不同进程、不同机器间一致，
+ * 可以直接写入文件或在进程间比较
+ * @tparam Cells 格子数
+ */
+template <int Cells> struct ZobristTable {
+  uint64_t keys[Cells][GEM_KIND + 1]; ///< keys[格子号][颜色]，EMPTY 列为 0
+
+  constexpr ZobristTable() : keys() {
+    uint64_t x = 0x5eed0f2b7a3c91d4ULL ^ uint64_t(Cells);
+    for (int i = 0; i < Cells; i++) {
+      for (int k = 1; k <= GEM_KIND; k++) {
+        keys[i][k] = Random::splitMix64(x);
+      }
+    }
+  }
+};
+
+template <int Cells>
+inline constexpr ZobristTable<Cells> kZobrist = ZobristTable<Cells>();
+
+/// 空棋盘的哈希。取非零值，使清零的置换表槽位不会与任何真实局面匹配
+const uint64_t ZOBRIST_EMPTY_BOARD = 0x243f6a8885a308d3ULL;
+
+#endif // ZOBRIST_H
@@ -0,0 +1,11 @@
+# 链接 gamecore 静态库：在子工程中 include(<path>/src/model/gamecore.pri)
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+LIBS += -L$$top_builddir/lib -lgamecore
+
+# 提示引擎与自动对局器使用 std::thread
+CONFIG += thread
+
+win32-msvc*: PRE_TARGETDEPS += $$top_builddir/lib/gamecore.lib
+else: PRE_TARGETDEPS += $$top_builddir/lib/libgamecore.a
@@ -0,0 +1,57 @@
+TEMPLATE = lib
+TARGET = gamecore
+
+# 纯 C++ 规则库，不链接任何 Qt 模块
+CONFIG += staticlib c++17 thread
+CONFIG -= qt
+
+DESTDIR = $$top_builddir/lib
+
+SOURCES += \
+    AutoPlayer.cpp \
+    BoardBatch.cpp \
+    DynamicGameMap.cpp \
+    GameMap.cpp \
+    GameSession.cpp \
+    HintEngine.cpp \
+    MappedFile.cpp \
+    PositionCache.cpp \
+    Replay.cpp \
+    ReplayCorpus.cpp \
+    ThreadPool.cpp \
+    WorkStealingPool.cpp
+
+HEADERS += \
+    AutoPlayer.h \
+    AutoPlayerImpl.h \
+    BitBoard.h \
+    BitMask.h \
+    BoardBatch.h \
+    CellPos.h \
+    Challenge.h \
+    Const.h \
+    DynamicGameMap.h \
+    FixedVector.h \
+    Gem.h \
+    GameMap.h \
+    GameMapImpl.h \
+    GameSession.h \
+    GameSessionImpl.h \
+    GreedyPolicy.h \
+    HintEngine.h \
+    HintEngineImpl.h \
+    MappedFile.h \
+    Move.h \
+    MovePatterns.h \
+    Percentile.h \
+    PositionCache.h \
+    PositionCacheImpl.h \
+    Random.h \
+    Replay.h \
+    ReplayCorpus.h \
+    SearchJob.h \
+    ThreadPool.h \
+    TranspositionTable.h \
+    UndoJournal.h \
+    WorkStealingPool.h \
+    Zobrist.h
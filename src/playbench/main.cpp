@@ -0,0 +1,185 @@
+// playbench: 端到端对局吞吐基准。
+// 用确定性的贪心机器人驱动真实的 GameWidget 连续对局，去掉结算动画的节奏，
+// 可选地把每一帧经 paintEvent 渲染到离屏图像，输出吞吐、绘制耗时与峰值内存的 JSON 报告
+
+#include "GameWidget.h"
+#include "GreedyPolicy.h"
+#include "Percentile.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const int DEFAULT_GAMES = 20;  ///< 默认对局数
+const int DEFAULT_TURNS = 100; ///< 默认每局回合数
+
+/**
+ * @brief 获取进程的峰值常驻内存
+ * @return 千字节，平台不支持时为 0
+ */
+qint64 peakRssKb() {
+#if defined(Q_OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return static_cast<qint64>(counters.PeakWorkingSetSize / 1024);
+  }
+  return 0;
+#elif defined(Q_OS_UNIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(Q_OS_MACOS)
+  return usage.ru_maxrss / 1024; // macOS 以字节为单位
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+// 取分位数并由纳秒换算为微秒，无样本时为 0
+double percentileUs(const std::vector<qint64> &sorted, double q) {
+  return nearestRank(sorted, q) / 1000.0;
+}
+
+} // namespace
+
+/**
+ * @brief 程序主函数
+ * 每局以“种子 + 局号”开局，机器人在地图稳定后立即走下一步，
+ * 结算阶段由间隔为 0 的定时器推进
+ */
+int main(int argc, char *argv[]) {
+  // 没有指定平台插件时使用 offscreen，无需显示器
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("End-to-end game throughput benchmark");
+  parser.addHelpOption();
+  QCommandLineOption gamesOption("games", "Number of games.", "n",
+                                 QString::number(DEFAULT_GAMES));
+  QCommandLineOption turnsOption("turns", "Turns per game.", "n",
+                                 QString::number(DEFAULT_TURNS));
+  QCommandLineOption seedOption("seed", "Seed of the first game.", "seed",
+                                "1");
+  QCommandLineOption renderOption(
+      "render", "Render every frame through GameWidget::paintEvent.");
+  QCommandLineOption outOption("out", "Write the JSON report to a file.",
+                               "file");
+  parser.addOption(gamesOption);
+  parser.addOption(turnsOption);
+  parser.addOption(seedOption);
+  parser.addOption(renderOption);
+  parser.addOption(outOption);
+  parser.process(app);
+
+  const int games = qMax(parser.value(gamesOption).toInt(), 1);
+  const int turnsPerGame = qMax(parser.value(turnsOption).toInt(), 1);
+  const quint64 seed = parser.value(seedOption).toULongLong();
+  const bool render = parser.isSet(renderOption);
+
+  GameWidget widget;
+  widget.setGameMode(ENDLESS);
+  widget.setStepInterval(0);
+
+  QImage frame(widget.size(), QImage::Format_ARGB32_Premultiplied);
+  std::vector<qint64> paintNs;
+  auto renderFrame = [&]() {
+    if (!render) {
+      return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    widget.render(&frame);
+    paintNs.push_back(timer.nsecsElapsed());
+  };
+
+  qint64 steps = 0;
+  qint64 cascadeSteps = 0;
+  QObject::connect(&widget, &GameWidget::stepFinished,
+                   [&](StepResult result) {
+                     steps++;
+                     if (result == STEP_ELIMINATED) {
+                       cascadeSteps++;
+                     }
+                     renderFrame();
+                   });
+
+  qint64 turns = 0;
+  qint64 totalScore = 0;
+  QElapsedTimer clock;
+  GameMap scratch(0); // 贪心机器人的试探地图
+  clock.start();
+  for (int g = 0; g < games; g++) {
+    widget.newGame(seed + g);
+    renderFrame();
+    for (int t = 0; t < turnsPerGame; t++) {
+      Move move;
+      if (!greedyMove(widget.session().map(), scratch, move) ||
+          !widget.playMove(move)) {
+        break;
+      }
+      turns++;
+      renderFrame();
+      // 间隔为 0 的定时器在每轮事件处理中推进一个阶段
+      while (widget.session().isResolving()) {
+        app.processEvents();
+      }
+    }
+    totalScore += widget.session().score();
+  }
+  const double seconds = clock.nsecsElapsed() / 1e9;
+
+  std::sort(paintNs.begin(), paintNs.end());
+  QJsonObject report;
+  report["benchmark"] = "gameplay";
+  report["platform"] = QGuiApplication::platformName();
+  report["seed"] = QString::number(seed);
+  report["games"] = games;
+  report["turnsPerGame"] = turnsPerGame;
+  report["render"] = render;
+  report["turns"] = turns;
+  report["steps"] = steps;
+  report["cascadeSteps"] = cascadeSteps;
+  report["totalScore"] = totalScore;
+  report["seconds"] = seconds;
+  report["gamesPerSec"] = games / seconds;
+  report["turnsPerSec"] = turns / seconds;
+  report["cascadeStepsPerSec"] = cascadeSteps / seconds;
+  report["frames"] = static_cast<qint64>(paintNs.size());
+  report["paintP50Us"] = percentileUs(paintNs, 0.50);
+  report["paintP99Us"] = percentileUs(paintNs, 0.99);
+  report["peakRssKb"] = peakRssKb();
+  const QByteArray json = QJsonDocument(report).toJson();
+
+  if (!parser.isSet(outOption)) {
+    QTextStream(stdout) << json;
+    return 0;
+  }
+  QFile file(parser.value(outOption));
+  if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+    QTextStream(stderr) << "cannot write " << file.fileName() << "\n";
+    return 1;
+  }
+  return 0;
+}
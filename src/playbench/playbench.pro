@@ -0,0 +1,33 @@
+QT       += core gui widgets multimedia
+
+TEMPLATE = app
+TARGET = playbench
+
+# 端到端吞吐基准：驱动真实的 GameWidget，默认在 offscreen 平台上运行
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+# 与界面程序共用 GameWidget
+INCLUDEPATH += $$PWD ../view
+
+SOURCES += \
+    main.cpp \
+    ../view/BoardRenderer.cpp \
+    ../view/GameWidget.cpp
+
+HEADERS += \
+    ../view/BoardRenderer.h \
+    ../view/GameWidget.h
+
+FORMS += \
+    ../view/GameWidget.ui
+
+RESOURCES += \
+    ../../resources.qrc
+
+win32: LIBS += -lpsapi
+
+DESTDIR = $$top_builddir/bin
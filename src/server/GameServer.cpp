@@ -0,0 +1,169 @@
+#include "GameServer.h"
+#include <QHostAddress>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * @brief GameServer构造函数实现
+ * @param threads 工作线程数
+ * @param maxSessions 会话数上限
+ * @param parent 父对象
+ */
+GameServer::GameServer(int threads, int maxSessions, QObject *parent)
+    : QObject(parent), m_host(new SessionHost(threads, maxSessions)),
+      m_local(new QLocalServer(this)), m_tcp(new QTcpServer(this)),
+      m_nextConnection(1) {
+  connect(m_local, &QLocalServer::newConnection, this,
+          &GameServer::acceptLocal);
+  connect(m_tcp, &QTcpServer::newConnection, this, &GameServer::acceptTcp);
+}
+
+/**
+ * @brief GameServer析构函数实现
+ * 先断开套接字信号，再等待线程池；其间排队的应答随本对象一起丢弃
+ */
+GameServer::~GameServer() {
+  for (Connection *connection : std::as_const(m_connections)) {
+    connection->socket->disconnect(this); // 析构期间不再回调
+  }
+  qDeleteAll(m_connections);
+  delete m_host;
+}
+
+/**
+ * @brief 在本地套接字上监听实现
+ * @param name 服务名
+ * @return false 表示监听失败
+ */
+bool GameServer::listenLocal(const QString &name) {
+  QLocalServer::removeServer(name);
+  if (!m_local->listen(name)) {
+    m_error = m_local->errorString();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 在本机 TCP 端口上监听实现
+ * 只绑定回环地址，不对外暴露
+ * @param port 端口
+ * @return false 表示监听失败
+ */
+bool GameServer::listenTcp(quint16 port) {
+  if (!m_tcp->listen(QHostAddress::LocalHost, port)) {
+    m_error = m_tcp->errorString();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 接受本地套接字连接实现
+ */
+void GameServer::acceptLocal() {
+  while (QLocalSocket *socket = m_local->nextPendingConnection()) {
+    const quint64 id = addConnection(socket);
+    connect(socket, &QLocalSocket::disconnected, this,
+            [this, id]() { dropConnection(id); });
+  }
+}
+
+/**
+ * @brief 接受 TCP 连接实现
+ * 应答很小，关闭 Nagle 算法以免被延迟合并
+ */
+void GameServer::acceptTcp() {
+  while (QTcpSocket *socket = m_tcp->nextPendingConnection()) {
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    const quint64 id = addConnection(socket);
+    connect(socket, &QTcpSocket::disconnected, this,
+            [this, id]() { dropConnection(id); });
+  }
+}
+
+/**
+ * @brief 登记新连接实现
+ * @param socket 套接字
+ * @return 连接编号
+ */
+quint64 GameServer::addConnection(QIODevice *socket) {
+  const quint64 id = m_nextConnection++;
+  Connection *connection = new Connection();
+  connection->socket = socket;
+  m_connections.insert(id, connection);
+  connect(socket, &QIODevice::readyRead, this,
+          [this, id]() { readFrames(id); });
+  return id;
+}
+
+/**
+ * @brief 读取并处理连接上的完整帧实现
+ * 应答回调在线程池中执行，只捕获连接编号，经排队调用回到本线程
+ * @param id 连接编号
+ */
+void GameServer::readFrames(quint64 id) {
+  Connection *connection = m_connections.value(id);
+  if (!connection) {
+    return;
+  }
+  const QByteArray bytes = connection->socket->readAll();
+  connection->reader.append(bytes.constData(),
+                            static_cast<size_t>(bytes.size()));
+
+  const SessionHost::Reply reply = [this, id](std::vector<uint8_t> &&frame) {
+    const QByteArray data(reinterpret_cast<const char *>(frame.data()),
+                          static_cast<int>(frame.size()));
+    QMetaObject::invokeMethod(
+        this, [this, id, data]() { deliver(id, data); },
+        Qt::QueuedConnection);
+  };
+  std::vector<uint8_t> body;
+  ServerRequest request;
+  while (connection->reader.next(body)) {
+    if (!decodeRequest(body.data(), body.size(), request)) {
+      // 类型或长度不对：直接应答错误后断开，流中之后的数据无法信任
+      const uint32_t tag =
+          body.size() >= 5 ? readLittle<uint32_t>(body.data() + 1) : 0;
+      FrameWriter w(MSG_ERROR, tag);
+      w.u8(ERR_MALFORMED);
+      const std::vector<uint8_t> frame = w.finish();
+      connection->socket->write(reinterpret_cast<const char *>(frame.data()),
+                                static_cast<qint64>(frame.size()));
+      connection->socket->close();
+      return;
+    }
+    m_host->handle(request, id, reply);
+  }
+  if (connection->reader.broken()) {
+    connection->socket->close();
+  }
+}
+
+/**
+ * @brief 把应答写回连接实现
+ * @param id 连接编号
+ * @param frame 完整帧
+ */
+void GameServer::deliver(quint64 id, const QByteArray &frame) {
+  Connection *connection = m_connections.value(id);
+  if (connection && connection->socket->isOpen()) {
+    connection->socket->write(frame);
+  }
+}
+
+/**
+ * @brief 断开连接实现
+ * @param id 连接编号
+ */
+void GameServer::dropConnection(quint64 id) {
+  Connection *connection = m_connections.take(id);
+  if (!connection) {
+    return;
+  }
+  m_host->closeOwner(id);
+  connection->socket->deleteLater();
+  delete connection;
+}
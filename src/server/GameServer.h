@@ -0,0 +1,114 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include "SessionHost.h"
+#include <QHash>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+
+class QLocalServer;
+class QTcpServer;
+
+/**
+ * @brief 对局服务器的网络层
+ * 在本地套接字（Unix 域套接字 / Windows 命名管道）与本机 TCP 上接受连接，
+ * 在事件循环线程中分帧并交给 SessionHost；结算在线程池中完成，
+ * 应答经排队调用回到事件循环线程写回对应连接
+ */
+class GameServer : public QObject {
+  Q_OBJECT
+
+public:
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数，0 表示使用硬件并发数
+   * @param maxSessions 会话数上限
+   * @param parent 父对象
+   */
+  GameServer(int threads, int maxSessions, QObject *parent = nullptr);
+
+  /**
+   * @brief 析构函数
+   * 断开全部连接并等待线程池结算完毕
+   */
+  ~GameServer();
+
+  /**
+   * @brief 在本地套接字上监听
+   * 同名的残留套接字文件会先被移除
+   * @param name 服务名
+   * @return false 表示监听失败（见 errorString()）
+   */
+  bool listenLocal(const QString &name);
+
+  /**
+   * @brief 在本机回环地址的 TCP 端口上监听
+   * @param port 端口
+   * @return false 表示监听失败（见 errorString()）
+   */
+  bool listenTcp(quint16 port);
+
+  // 获取最近一次监听失败的原因
+  QString errorString() const { return m_error; }
+
+  // 获取会话宿主
+  const SessionHost &host() const { return *m_host; }
+
+private slots:
+  /**
+   * @brief 接受本地套接字连接
+   */
+  void acceptLocal();
+
+  /**
+   * @brief 接受 TCP 连接
+   */
+  void acceptTcp();
+
+private:
+  /**
+   * @brief 一个客户端连接
+   */
+  struct Connection {
+    QIODevice *socket;  ///< 套接字（QLocalSocket 或 QTcpSocket）
+    FrameReader reader; ///< 分帧缓冲
+  };
+
+  /**
+   * @brief 登记新连接
+   * @param socket 套接字
+   * @return 连接编号
+   */
+  quint64 addConnection(QIODevice *socket);
+
+  /**
+   * @brief 读取并处理连接上的完整帧
+   * 帧无法解析时断开连接
+   * @param id 连接编号
+   */
+  void readFrames(quint64 id);
+
+  /**
+   * @brief 把应答写回连接
+   * 在事件循环线程中执行；连接已断开时丢弃
+   * @param id 连接编号
+   * @param frame 完整帧
+   */
+  void deliver(quint64 id, const QByteArray &frame);
+
+  /**
+   * @brief 断开连接并关闭其全部会话
+   * @param id 连接编号
+   */
+  void dropConnection(quint64 id);
+
+  SessionHost *m_host;                        ///< 会话宿主
+  QLocalServer *m_local;                      ///< 本地套接字服务
+  QTcpServer *m_tcp;                          ///< TCP 服务
+  QHash<quint64, Connection *> m_connections; ///< 连接表
+  quint64 m_nextConnection;                   ///< 下一个连接编号
+  QString m_error;                            ///< 最近一次监听失败的原因
+};
+
+#endif // GAMESERVER_H
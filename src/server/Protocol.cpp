@@ -0,0 +1,130 @@
+#include "Protocol.h"
+
+/**
+ * @brief 解码请求消息体实现
+ * @param body 消息体
+ * @param size 字节数
+ * @param request 输出请求
+ * @return false 表示类型未知或长度不符
+ */
+bool decodeRequest(const uint8_t *body, size_t size, ServerRequest &request) {
+  if (size < 5) {
+    return false;
+  }
+  request = ServerRequest{body[0], readLittle<uint32_t>(body + 1), 0, 0, 0, 0};
+  const uint8_t *p = body + 5;
+  switch (request.type) {
+  case MSG_NEW:
+    if (size != 5 + 9) {
+      return false;
+    }
+    request.seed = readLittle<uint64_t>(p);
+    request.flags = p[8];
+    return true;
+  case MSG_MOVE:
+    if (size != 5 + 5) {
+      return false;
+    }
+    request.session = readLittle<uint32_t>(p);
+    request.code = p[4];
+    return true;
+  case MSG_UNDO:
+  case MSG_BOARD:
+  case MSG_CLOSE:
+    if (size != 5 + 4) {
+      return false;
+    }
+    request.session = readLittle<uint32_t>(p);
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief FrameWriter构造函数实现
+ * @param type 消息类型
+ * @param tag 标签
+ */
+FrameWriter::FrameWriter(uint8_t type, uint32_t tag) {
+  m_frame.reserve(FRAME_HEADER_SIZE + 24 + BOARD_BYTES);
+  u16(0); // 长度占位
+  u8(type);
+  u32(tag);
+}
+
+void FrameWriter::u8(uint8_t v) { m_frame.push_back(v); }
+
+void FrameWriter::u16(uint16_t v) {
+  u8(static_cast<uint8_t>(v));
+  u8(static_cast<uint8_t>(v >> 8));
+}
+
+void FrameWriter::u32(uint32_t v) {
+  u16(static_cast<uint16_t>(v));
+  u16(static_cast<uint16_t>(v >> 16));
+}
+
+void FrameWriter::u64(uint64_t v) {
+  u32(static_cast<uint32_t>(v));
+  u32(static_cast<uint32_t>(v >> 32));
+}
+
+void FrameWriter::raw(const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  m_frame.insert(m_frame.end(), bytes, bytes + size);
+}
+
+/**
+ * @brief 结束编码实现
+ * @return 完整的帧
+ */
+std::vector<uint8_t> FrameWriter::finish() {
+  const size_t body = m_frame.size() - FRAME_HEADER_SIZE;
+  m_frame[0] = static_cast<uint8_t>(body);
+  m_frame[1] = static_cast<uint8_t>(body >> 8);
+  return std::move(m_frame);
+}
+
+/**
+ * @brief FrameReader构造函数实现
+ */
+FrameReader::FrameReader() : m_pos(0), m_broken(false) {}
+
+/**
+ * @brief 追加收到的字节实现
+ * 已处理的前缀超过一半时先压缩缓冲
+ * @param data 数据
+ * @param size 字节数
+ */
+void FrameReader::append(const void *data, size_t size) {
+  if (m_pos > 0 && m_pos * 2 >= m_buffer.size()) {
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_pos);
+    m_pos = 0;
+  }
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+/**
+ * @brief 取出下一个完整的消息体实现
+ * @param body 输出消息体
+ * @return false 表示数据不足或流已损坏
+ */
+bool FrameReader::next(std::vector<uint8_t> &body) {
+  if (m_broken || m_buffer.size() - m_pos < FRAME_HEADER_SIZE) {
+    return false;
+  }
+  const size_t size = readLittle<uint16_t>(m_buffer.data() + m_pos);
+  if (size == 0 || size > MAX_MESSAGE_SIZE) {
+    m_broken = true;
+    return false;
+  }
+  if (m_buffer.size() - m_pos < FRAME_HEADER_SIZE + size) {
+    return false;
+  }
+  const auto begin = m_buffer.begin() + m_pos + FRAME_HEADER_SIZE;
+  body.assign(begin, begin + size);
+  m_pos += FRAME_HEADER_SIZE + size;
+  return true;
+}
@@ -0,0 +1,165 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "Const.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 对局服务器的二进制协议（小端序）
+ *
+ * 每帧为 2 字节的消息体长度加消息体；消息体以 1 字节类型与 4 字节标签开头，
+ * 标签由客户端选择，应答原样带回。同一会话的请求按顺序应答，不同会话的应答可能交错。
+ *
+ * 请求：
+ *   MSG_NEW    种子 u64、标志 u8（bit0 = REFILL_PLAYABLE）
+ *   MSG_MOVE   会话 u32、交换编码 u8（见 Replay::encodeMove()）
+ *   MSG_UNDO   会话 u32
+ *   MSG_BOARD  会话 u32
+ *   MSG_CLOSE  会话 u32
+ * 应答：
+ *   MSG_CREATED      会话 u32、分数 i32、棋盘
+ *   MSG_MOVED        会话 u32、是否接受 u8、连锁轮数 u8、消除数 u16、
+ *                    得分 i32、分数 i32、是否重置 u8、哈希 u64、棋盘
+ *   MSG_UNDONE       会话 u32、是否成功 u8、分数 i32、哈希 u64
+ *   MSG_BOARD_STATE  会话 u32、分数 i32、哈希 u64、棋盘
+ *   MSG_CLOSED       会话 u32
+ *   MSG_ERROR        错误码 u8
+ * 棋盘为 ROW * COL 字节，按行存放各格颜色（GemType）
+ */
+
+/**
+ * @brief 消息类型
+ */
+enum MessageType {
+  MSG_NEW = 0x01,         ///< 创建会话
+  MSG_MOVE = 0x02,        ///< 交换
+  MSG_UNDO = 0x03,        ///< 撤销
+  MSG_BOARD = 0x04,       ///< 查询棋盘
+  MSG_CLOSE = 0x05,       ///< 关闭会话
+  MSG_CREATED = 0x81,     ///< 会话已创建
+  MSG_MOVED = 0x82,       ///< 交换已结算
+  MSG_UNDONE = 0x83,      ///< 撤销结果
+  MSG_BOARD_STATE = 0x84, ///< 棋盘状态
+  MSG_CLOSED = 0x85,      ///< 会话已关闭
+  MSG_ERROR = 0xFF        ///< 错误
+};
+
+/**
+ * @brief 错误码
+ */
+enum ErrorCode {
+  ERR_MALFORMED = 1,         ///< 消息格式错误
+  ERR_UNKNOWN_SESSION = 2,   ///< 会话不存在或不属于本连接
+  ERR_TOO_MANY_SESSIONS = 3, ///< 会话数已达上限
+  ERR_BAD_MOVE = 4           ///< 交换编码无效
+};
+
+const int FRAME_HEADER_SIZE = 2;   ///< 帧头（消息体长度）字节数
+const int MAX_MESSAGE_SIZE = 256;  ///< 消息体长度上限
+const int BOARD_BYTES = ROW * COL; ///< 棋盘字节数
+
+/**
+ * @brief 解码后的请求
+ */
+struct ServerRequest {
+  uint8_t type;     ///< 消息类型
+  uint32_t tag;     ///< 客户端标签
+  uint32_t session; ///< 会话编号（MSG_NEW 无）
+  uint64_t seed;    ///< 种子（仅 MSG_NEW）
+  uint8_t flags;    ///< 标志（仅 MSG_NEW）
+  uint8_t code;     ///< 交换编码（仅 MSG_MOVE）
+};
+
+/**
+ * @brief 解码请求消息体
+ * @param body 消息体
+ * @param size 字节数
+ * @param request 输出请求
+ * @return false 表示类型未知或长度不符
+ */
+bool decodeRequest(const uint8_t *body, size_t size, ServerRequest &request);
+
+/**
+ * @brief 帧编码器
+ * 按字段追加消息体，finish() 回填长度，得到一个完整的帧
+ */
+class FrameWriter {
+public:
+  /**
+   * @brief 构造函数
+   * 写入帧头占位、类型与标签
+   * @param type 消息类型
+   * @param tag 标签
+   */
+  FrameWriter(uint8_t type, uint32_t tag);
+
+  void u8(uint8_t v);
+  void u16(uint16_t v);
+  void u32(uint32_t v);
+  void u64(uint64_t v);
+
+  /**
+   * @brief 追加原始字节
+   * @param data 数据
+   * @param size 字节数
+   */
+  void raw(const void *data, size_t size);
+
+  /**
+   * @brief 结束编码
+   * @return 完整的帧（含帧头）
+   */
+  std::vector<uint8_t> finish();
+
+private:
+  std::vector<uint8_t> m_frame; ///< 帧缓冲
+};
+
+/**
+ * @brief 帧解析器
+ * 从字节流中切出完整的消息体，处理半包与粘包
+ */
+class FrameReader {
+public:
+  FrameReader();
+
+  /**
+   * @brief 追加收到的字节
+   * @param data 数据
+   * @param size 字节数
+   */
+  void append(const void *data, size_t size);
+
+  /**
+   * @brief 取出下一个完整的消息体
+   * @param body 输出消息体
+   * @return false 表示数据不足或流已损坏（见 broken()）
+   */
+  bool next(std::vector<uint8_t> &body);
+
+  // 是否遇到超长或空的消息，之后的数据无法再分帧
+  bool broken() const { return m_broken; }
+
+private:
+  std::vector<uint8_t> m_buffer; ///< 未处理的字节
+  size_t m_pos;                  ///< 已处理的偏移
+  bool m_broken;                 ///< 流是否已损坏
+};
+
+/**
+ * @brief 读取小端序整数
+ * @tparam T 无符号整数类型
+ * @param p 起始地址
+ * @return 数值
+ */
+template <class T> T readLittle(const uint8_t *p) {
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    v |= T(p[i]) << (8 * i);
+  }
+  return v;
+}
+
+#endif // PROTOCOL_H
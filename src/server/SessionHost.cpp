@@ -0,0 +1,201 @@
+#include "SessionHost.h"
+#include "Replay.h"
+
+namespace {
+
+// 应答错误
+void replyError(const SessionHost::Reply &reply, uint32_t tag, ErrorCode code) {
+  FrameWriter w(MSG_ERROR, tag);
+  w.u8(static_cast<uint8_t>(code));
+  reply(w.finish());
+}
+
+// 写入棋盘
+void writeBoard(FrameWriter &w, const GameMap &map) {
+  uint8_t board[BOARD_BYTES];
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      board[r * COL + c] = static_cast<uint8_t>(map.getGemType(r, c));
+    }
+  }
+  w.raw(board, sizeof(board));
+}
+
+} // namespace
+
+/**
+ * @brief SessionHost构造函数实现
+ * @param threads 工作线程数
+ * @param maxSessions 会话数上限
+ */
+SessionHost::SessionHost(int threads, int maxSessions)
+    : m_nextId(1), m_maxSessions(maxSessions), m_pool(threads) {}
+
+/**
+ * @brief SessionHost析构函数实现
+ * 线程池最先析构，等待已排队的请求处理完
+ */
+SessionHost::~SessionHost() {}
+
+/**
+ * @brief 处理一个请求实现
+ * 会话的创建与查找在网络线程中完成，结算在线程池中进行
+ * @param request 请求
+ * @param owner 连接编号
+ * @param reply 应答回调
+ */
+void SessionHost::handle(const ServerRequest &request, uint64_t owner,
+                         Reply reply) {
+  const uint32_t tag = request.tag;
+  if (request.type == MSG_NEW) {
+    if (sessionCount() >= m_maxSessions) {
+      replyError(reply, tag, ERR_TOO_MANY_SESSIONS);
+      return;
+    }
+    // 编号 0 保留不用，回绕后跳过仍在使用的编号
+    while (m_nextId == 0 || m_sessions.count(m_nextId)) {
+      m_nextId++;
+    }
+    const uint32_t id = m_nextId++;
+    auto session = std::make_shared<Session>(owner);
+    m_sessions.emplace(id, session);
+    const uint64_t seed = request.seed;
+    const RefillPolicy policy =
+        (request.flags & 1) ? REFILL_PLAYABLE : REFILL_RANDOM;
+    enqueue(session, [session, id, tag, seed, policy, reply]() {
+      GameMap &map = session->game.map();
+      map.setSeed(seed);
+      map.setRefillPolicy(policy);
+      session->game.newGame();
+      FrameWriter w(MSG_CREATED, tag);
+      w.u32(id);
+      w.u32(static_cast<uint32_t>(session->game.score()));
+      writeBoard(w, map);
+      reply(w.finish());
+    });
+    return;
+  }
+
+  auto it = m_sessions.find(request.session);
+  if (it == m_sessions.end() || it->second->owner != owner) {
+    replyError(reply, tag, ERR_UNKNOWN_SESSION);
+    return;
+  }
+  const std::shared_ptr<Session> session = it->second;
+  const uint32_t id = request.session;
+  switch (request.type) {
+  case MSG_MOVE: {
+    if (request.code >= ROW * COL * 2) {
+      replyError(reply, tag, ERR_BAD_MOVE);
+      return;
+    }
+    const Move move = Replay::decodeMove(request.code);
+    enqueue(session, [session, id, tag, move, reply]() {
+      GameSession &game = session->game;
+      const TurnResult result = game.playMove(move);
+      FrameWriter w(MSG_MOVED, tag);
+      w.u32(id);
+      w.u8(result.accepted ? 1 : 0);
+      w.u8(static_cast<uint8_t>(result.cascades));
+      w.u16(static_cast<uint16_t>(result.gemsCleared));
+      w.u32(static_cast<uint32_t>(result.points));
+      w.u32(static_cast<uint32_t>(game.score()));
+      w.u8(result.reshuffled ? 1 : 0);
+      w.u64(game.map().hash());
+      writeBoard(w, game.map());
+      reply(w.finish());
+    });
+    break;
+  }
+  case MSG_UNDO:
+    enqueue(session, [session, id, tag, reply]() {
+      GameSession &game = session->game;
+      const bool ok = game.undo();
+      FrameWriter w(MSG_UNDONE, tag);
+      w.u32(id);
+      w.u8(ok ? 1 : 0);
+      w.u32(static_cast<uint32_t>(game.score()));
+      w.u64(game.map().hash());
+      reply(w.finish());
+    });
+    break;
+  case MSG_BOARD:
+    enqueue(session, [session, id, tag, reply]() {
+      const GameSession &game = session->game;
+      FrameWriter w(MSG_BOARD_STATE, tag);
+      w.u32(id);
+      w.u32(static_cast<uint32_t>(game.score()));
+      w.u64(game.map().hash());
+      writeBoard(w, game.map());
+      reply(w.finish());
+    });
+    break;
+  case MSG_CLOSE:
+    // 排在已有请求之后应答，客户端收到时该会话的应答已全部发出
+    m_sessions.erase(it);
+    enqueue(session, [id, tag, reply]() {
+      FrameWriter w(MSG_CLOSED, tag);
+      w.u32(id);
+      reply(w.finish());
+    });
+    break;
+  default:
+    replyError(reply, tag, ERR_MALFORMED);
+    break;
+  }
+}
+
+/**
+ * @brief 关闭某个连接的全部会话实现
+ * @param owner 连接编号
+ */
+void SessionHost::closeOwner(uint64_t owner) {
+  for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+    if (it->second->owner == owner) {
+      it->second->closed = true;
+      it = m_sessions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+/**
+ * @brief 把请求排入会话队列实现
+ * @param session 会话
+ * @param job 请求
+ */
+void SessionHost::enqueue(const std::shared_ptr<Session> &session,
+                          std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    session->jobs.push_back(std::move(job));
+    if (session->scheduled) {
+      return; // 正在处理该会话的线程会接着处理
+    }
+    session->scheduled = true;
+  }
+  m_pool.submit([this, session]() { drain(session); });
+}
+
+/**
+ * @brief 依次处理会话队列中的请求实现
+ * 连接已断开时丢弃剩余请求
+ * @param session 会话
+ */
+void SessionHost::drain(const std::shared_ptr<Session> &session) {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::lock_guard<std::mutex> lock(session->mutex);
+      if (session->jobs.empty() || session->closed) {
+        session->jobs.clear();
+        session->scheduled = false;
+        return;
+      }
+      job = std::move(session->jobs.front());
+      session->jobs.pop_front();
+    }
+    job();
+  }
+}
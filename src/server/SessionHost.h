@@ -0,0 +1,108 @@
+#ifndef SESSIONHOST_H
+#define SESSIONHOST_H
+
+#include "GameSession.h"
+#include "Protocol.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief 多会话宿主
+ * 持有大量 GameSession，把每个请求作为任务交给工作窃取线程池：
+ * 同一会话的请求排成队列，同一时刻只有一个线程处理，保证按序结算；
+ * 不同会话的结算在各线程上并行。不依赖 Qt，网络层只负责分帧与收发
+ */
+class SessionHost {
+public:
+  /**
+   * @brief 应答回调
+   * 在线程池中调用，参数为编码好的完整帧
+   */
+  typedef std::function<void(std::vector<uint8_t> &&frame)> Reply;
+
+  static const int DEFAULT_MAX_SESSIONS = 65536; ///< 默认会话数上限
+
+  /**
+   * @brief 构造函数
+   * @param threads 工作线程数，0 表示使用硬件并发数
+   * @param maxSessions 会话数上限
+   */
+  explicit SessionHost(int threads = 0,
+                       int maxSessions = DEFAULT_MAX_SESSIONS);
+
+  /**
+   * @brief 析构函数
+   * 等待已提交的请求全部结算完毕
+   */
+  ~SessionHost();
+
+  SessionHost(const SessionHost &) = delete;
+  SessionHost &operator=(const SessionHost &) = delete;
+
+  /**
+   * @brief 处理一个请求
+   * 只在网络线程中调用；请求无效时直接应答错误
+   * @param request 请求
+   * @param owner 发出请求的连接编号，会话只接受其创建者的请求
+   * @param reply 应答回调
+   */
+  void handle(const ServerRequest &request, uint64_t owner, Reply reply);
+
+  /**
+   * @brief 关闭某个连接的全部会话
+   * 只在网络线程中调用；正在执行的请求会完成，尚未开始的请求被丢弃，均不再应答
+   * @param owner 连接编号
+   */
+  void closeOwner(uint64_t owner);
+
+  // 获取会话数
+  int sessionCount() const { return static_cast<int>(m_sessions.size()); }
+
+  // 获取工作线程数
+  int threadCount() const { return m_pool.size(); }
+
+  // 获取线程池的窃取次数
+  uint64_t steals() const { return m_pool.steals(); }
+
+private:
+  /**
+   * @brief 一个会话
+   */
+  struct Session {
+    GameSession game;                       ///< 对局
+    uint64_t owner;                         ///< 所属连接
+    std::mutex mutex;                       ///< 保护请求队列与调度标记
+    std::deque<std::function<void()>> jobs; ///< 待处理的请求
+    bool scheduled;                         ///< 是否已交给线程池
+    std::atomic<bool> closed;               ///< 所属连接是否已断开
+
+    explicit Session(uint64_t ownerId)
+        : game(0), owner(ownerId), scheduled(false), closed(false) {}
+  };
+
+  /**
+   * @brief 把请求排入会话队列
+   * 会话未在处理中时交给线程池
+   */
+  void enqueue(const std::shared_ptr<Session> &session,
+               std::function<void()> job);
+
+  /**
+   * @brief 依次处理会话队列中的请求，直到队列为空
+   */
+  void drain(const std::shared_ptr<Session> &session);
+
+  typedef std::unordered_map<uint32_t, std::shared_ptr<Session>> SessionTable;
+
+  SessionTable m_sessions; ///< 会话表（只在网络线程中访问）
+  uint32_t m_nextId;       ///< 下一个会话编号
+  int m_maxSessions;       ///< 会话数上限
+  WorkStealingPool m_pool; ///< 线程池（最后声明，析构时最先等待任务完成）
+};
+
+#endif // SESSIONHOST_H
@@ -0,0 +1,56 @@
+// gameserver: 多会话对局服务器。
+// 一个进程承载大量 GameSession，客户端经本地套接字或本机 TCP 以二进制协议（见 Protocol.h）
+// 创建会话、交换与撤销；不同会话的结算在工作窃取线程池中并行进行
+
+#include "GameServer.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+/**
+ * @brief 程序主函数
+ */
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Multi-session game server");
+  parser.addHelpOption();
+  QCommandLineOption localOption("local", "Local socket name.", "name",
+                                 "bejeweled");
+  QCommandLineOption tcpOption("tcp", "Also listen on this localhost port.",
+                               "port");
+  QCommandLineOption threadsOption(
+      "threads", "Worker threads, 0 for the hardware concurrency.", "n", "0");
+  QCommandLineOption maxSessionsOption(
+      "max-sessions", "Maximum number of concurrent sessions.", "n",
+      QString::number(SessionHost::DEFAULT_MAX_SESSIONS));
+  parser.addOption(localOption);
+  parser.addOption(tcpOption);
+  parser.addOption(threadsOption);
+  parser.addOption(maxSessionsOption);
+  parser.process(app);
+
+  QTextStream err(stderr);
+  GameServer server(qMax(parser.value(threadsOption).toInt(), 0),
+                    qMax(parser.value(maxSessionsOption).toInt(), 1));
+  const QString name = parser.value(localOption);
+  if (!server.listenLocal(name)) {
+    err << "cannot listen on " << name << ": " << server.errorString()
+        << "\n";
+    return 1;
+  }
+  err << "listening on local socket " << name;
+  if (parser.isSet(tcpOption)) {
+    const quint16 port = parser.value(tcpOption).toUShort();
+    if (!server.listenTcp(port)) {
+      err << "\ncannot listen on port " << port << ": "
+          << server.errorString() << "\n";
+      return 1;
+    }
+    err << " and 127.0.0.1:" << port;
+  }
+  err << " with " << server.host().threadCount() << " threads\n";
+  err.flush();
+  return app.exec();
+}
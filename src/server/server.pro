@@ -0,0 +1,25 @@
+QT       += core network
+QT       -= gui
+
+TEMPLATE = app
+TARGET = gameserver
+
+# 多会话对局服务器：本地套接字与本机 TCP，不需要图形界面
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+SOURCES += \
+    GameServer.cpp \
+    Protocol.cpp \
+    SessionHost.cpp \
+    main.cpp
+
+HEADERS += \
+    GameServer.h \
+    Protocol.h \
+    SessionHost.h
+
+DESTDIR = $$top_builddir/bin
@@ -0,0 +1,576 @@
+// gemsim: 批量对局模拟。
+// 以一段连续种子开局，用随机、贪心或提示引擎策略自动对局，在工作窃取线程池上并行；
+// 统计得分分布、连锁长度、死局频率与闯关模式各关的过关率，输出 JSON 或 CSV 报告，
+// 用于在调整数值前用足够大的样本评估游戏平衡
+
+#include "Challenge.h"
+#include "GameSession.h"
+#include "GreedyPolicy.h"
+#include "HintEngine.h"
+#include "Percentile.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int DEFAULT_GAMES = 10000;   ///< 默认对局数
+const uint64_t DEFAULT_SEED = 1;   ///< 默认首局种子
+const int DEFAULT_TURNS = 200;     ///< 无尽模式默认每局交换数
+const int DEFAULT_LEVELS = 20;     ///< 闯关模式默认模拟的关卡上限
+const int DEFAULT_THINK_MS = 2000; ///< 闯关模式默认每步思考时间（毫秒）
+const int MAX_CASCADE_BUCKET = 16; ///< 连锁长度分布的最后一档（含更长）
+const int MAX_CHUNK = 256;         ///< 每个任务最多模拟的对局数
+const int HINT_BUDGET_MS = 60000;  ///< 提示策略的时间预算（只作保险）
+
+/**
+ * @brief 选择交换的策略
+ */
+enum SimPolicy {
+  POLICY_RANDOM, ///< 从合法交换中均匀随机选择
+  POLICY_GREEDY, ///< 选择直接消除得分最高的交换
+  POLICY_HINT    ///< 使用提示引擎的前瞻搜索
+};
+
+/**
+ * @brief 命令行选项
+ */
+struct Options {
+  bool challenge;      ///< 是否模拟闯关模式（否则为无尽模式）
+  SimPolicy policy;    ///< 选择交换的策略
+  int games;           ///< 对局数
+  uint64_t seed;       ///< 首局种子，第 i 局为 seed + i
+  int turns;           ///< 无尽模式的每局交换数
+  int levels;          ///< 闯关模式模拟的关卡上限
+  int thinkMs;         ///< 闯关模式每步的思考时间（毫秒）
+  RefillPolicy refill; ///< 补充策略
+  int threads;         ///< 线程数，0 表示硬件并发数
+  int hintDepth;       ///< 提示策略的搜索深度
+  int hintSamples;     ///< 提示策略每个候选的采样次数
+  bool csv;            ///< 是否输出 CSV（否则为 JSON）
+  std::string out;     ///< 输出文件，空表示标准输出
+};
+
+void usage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s [--mode challenge|endless] "
+               "[--policy random|greedy|hint]\n"
+               "       [--games N] [--seed N] [--turns N] [--levels N] "
+               "[--think-ms N]\n"
+               "       [--refill playable|random] [--threads N] "
+               "[--hint-depth N] [--hint-samples N]\n"
+               "       [--format json|csv] [--out FILE]\n",
+               program);
+}
+
+/**
+ * @brief 解析命令行
+ * @return false 表示参数有误
+ */
+bool parseOptions(int argc, char *argv[], Options &options) {
+  options.challenge = true;
+  options.policy = POLICY_GREEDY;
+  options.games = DEFAULT_GAMES;
+  options.seed = DEFAULT_SEED;
+  options.turns = DEFAULT_TURNS;
+  options.levels = DEFAULT_LEVELS;
+  options.thinkMs = DEFAULT_THINK_MS;
+  options.refill = REFILL_PLAYABLE; // 与界面程序一致
+  options.threads = 0;
+  options.hintDepth = HintEngine::DEFAULT_DEPTH;
+  options.hintSamples = HintEngine::DEFAULT_SAMPLES;
+  options.csv = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const std::string value = argv[++i];
+    if (arg == "--mode" && (value == "challenge" || value == "endless")) {
+      options.challenge = value == "challenge";
+    } else if (arg == "--policy" && value == "random") {
+      options.policy = POLICY_RANDOM;
+    } else if (arg == "--policy" && value == "greedy") {
+      options.policy = POLICY_GREEDY;
+    } else if (arg == "--policy" && value == "hint") {
+      options.policy = POLICY_HINT;
+    } else if (arg == "--games") {
+      options.games = std::atoi(value.c_str());
+    } else if (arg == "--seed") {
+      options.seed = std::strtoull(value.c_str(), nullptr, 0);
+    } else if (arg == "--turns") {
+      options.turns = std::atoi(value.c_str());
+    } else if (arg == "--levels") {
+      options.levels = std::atoi(value.c_str());
+    } else if (arg == "--think-ms") {
+      options.thinkMs = std::atoi(value.c_str());
+    } else if (arg == "--refill" &&
+               (value == "playable" || value == "random")) {
+      options.refill = value == "playable" ? REFILL_PLAYABLE : REFILL_RANDOM;
+    } else if (arg == "--threads") {
+      options.threads = std::atoi(value.c_str());
+    } else if (arg == "--hint-depth") {
+      options.hintDepth = std::atoi(value.c_str());
+    } else if (arg == "--hint-samples") {
+      options.hintSamples = std::atoi(value.c_str());
+    } else if (arg == "--format" && (value == "json" || value == "csv")) {
+      options.csv = value == "csv";
+    } else if (arg == "--out") {
+      options.out = value;
+    } else {
+      return false;
+    }
+  }
+  return options.games > 0 && options.turns > 0 && options.levels > 0 &&
+         options.thinkMs >= 0 && options.threads >= 0 &&
+         options.hintDepth > 0 && options.hintSamples > 0;
+}
+
+/**
+ * @brief 一批对局的统计
+ * 每个任务写自己的一份，结束后按种子顺序合并，结果与线程调度无关
+ */
+struct Stats {
+  std::vector<int> scores;           ///< 各局得分（闯关模式为各关得分之和）
+  uint64_t moves;                    ///< 交换数
+  uint64_t reshuffles;               ///< 死局重置次数
+  uint64_t deadlockedGames;          ///< 出现过死局的对局数
+  std::vector<uint64_t> cascades;    ///< 各连锁长度的交换数
+  std::vector<uint64_t> attempts;    ///< 各关的挑战次数（下标为关卡数）
+  std::vector<uint64_t> passes;      ///< 各关的过关次数
+  std::vector<uint64_t> passSeconds; ///< 各关过关用时之和（秒）
+  std::vector<uint64_t> passMoves;   ///< 各关过关所用交换数之和
+
+  explicit Stats(int levels = 0)
+      : moves(0), reshuffles(0), deadlockedGames(0),
+        cascades(MAX_CASCADE_BUCKET + 1, 0), attempts(levels + 1, 0),
+        passes(levels + 1, 0), passSeconds(levels + 1, 0),
+        passMoves(levels + 1, 0) {}
+
+  // 记录一个回合
+  void addTurn(const TurnResult &result) {
+    moves++;
+    cascades[std::min(result.cascades, MAX_CASCADE_BUCKET)]++;
+    reshuffles += result.reshuffled;
+  }
+
+  void merge(const Stats &o) {
+    scores.insert(scores.end(), o.scores.begin(), o.scores.end());
+    moves += o.moves;
+    reshuffles += o.reshuffles;
+    deadlockedGames += o.deadlockedGames;
+    for (size_t i = 0; i < cascades.size(); i++) {
+      cascades[i] += o.cascades[i];
+    }
+    for (size_t i = 0; i < attempts.size(); i++) {
+      attempts[i] += o.attempts[i];
+      passes[i] += o.passes[i];
+      passSeconds[i] += o.passSeconds[i];
+      passMoves[i] += o.passMoves[i];
+    }
+  }
+};
+
+/**
+ * @brief 按策略选择交换
+ * 每个任务持有一个；随机数与提示引擎按对局种子重设，同一种子的对局可复现
+ */
+class Player {
+public:
+  explicit Player(const Options &options)
+      : m_policy(options.policy), m_sim(0) {
+    m_sim.setRefillPolicy(options.refill);
+    if (m_policy == POLICY_HINT) {
+      // 每个任务一个单线程引擎，并行度由外层线程池提供
+      m_engine.reset(new HintEngine(1));
+      m_engine->setDepth(options.hintDepth);
+      m_engine->setSamples(options.hintSamples);
+    }
+  }
+
+  // 开始一局
+  void reset(uint64_t seed) {
+    m_random.setSeed(seed ^ 0x9e3779b97f4a7c15ULL);
+    if (m_engine) {
+      m_engine->setSeed(seed);
+    }
+  }
+
+  /**
+   * @brief 选择交换
+   * @param map 当前地图
+   * @param move 输出交换
+   * @return false 表示没有合法交换
+   */
+  bool choose(const GameMap &map, Move &move) {
+    if (m_policy == POLICY_GREEDY) {
+      return greedyMove(map, m_sim, move);
+    }
+    GameMap::MoveList moves;
+    if (map.findMoves(moves) == 0) {
+      return false;
+    }
+    if (m_policy == POLICY_RANDOM) {
+      move = moves[m_random.bounded(moves.size())];
+      return true;
+    }
+    const HintResult hint = m_engine->findBestMove(map, HINT_BUDGET_MS);
+    move = hint.found ? hint.move : moves[0];
+    return true;
+  }
+
+private:
+  SimPolicy m_policy;                   ///< 策略
+  Random m_random;                      ///< 随机策略的随机数
+  GameMap m_sim;                        ///< 贪心策略的试探地图
+  std::unique_ptr<HintEngine> m_engine; ///< 提示策略的引擎
+};
+
+/**
+ * @brief 模拟一局无尽模式
+ * 固定交换数，得分为最终分数
+ */
+void playEndless(const Options &options, GameSession &session,
+                 Player &player, Stats &stats) {
+  bool deadlocked = false;
+  Move move;
+  for (int t = 0; t < options.turns && player.choose(session.map(), move);
+       t++) {
+    const TurnResult result = session.playMove(move);
+    stats.addTurn(result);
+    deadlocked |= result.reshuffled;
+  }
+  stats.scores.push_back(session.score());
+  stats.deadlockedGames += deadlocked;
+}
+
+/**
+ * @brief 模拟一局闯关模式
+ * 与界面的计时规则一致：每步耗时为思考时间加结算动画
+ * （每轮连锁消除与下落各一个 STEP_INTERVAL_MS）；
+ * 分数在结算结束且不晚于时限时达到目标即过关，过关后分数清零、地图保留，
+ * 进入下一关；超时或达到关卡上限时结束。得分为各关得分之和
+ */
+void playChallenge(const Options &options, GameSession &session,
+                   Player &player, Stats &stats) {
+  bool deadlocked = false;
+  int total = 0;
+  int level = 1;
+  int levelMoves = 0;
+  int64_t elapsedMs = 0;
+  stats.attempts[level]++;
+  Move move;
+  while (player.choose(session.map(), move)) {
+    const TurnResult result = session.playMove(move);
+    stats.addTurn(result);
+    deadlocked |= result.reshuffled;
+    total += result.points;
+    levelMoves++;
+    elapsedMs += options.thinkMs +
+                 int64_t(2) * result.cascades * STEP_INTERVAL_MS;
+    if (elapsedMs > int64_t(challengeTime(level)) * 1000) {
+      break; // 超时
+    }
+    if (session.score() < challengeTargetScore(level)) {
+      continue;
+    }
+    // 界面每秒检查一次是否过关
+    stats.passes[level]++;
+    stats.passSeconds[level] += (elapsedMs + 999) / 1000;
+    stats.passMoves[level] += levelMoves;
+    if (level == options.levels) {
+      break;
+    }
+    level++;
+    stats.attempts[level]++;
+    session.setScore(0);
+    levelMoves = 0;
+    elapsedMs = 0;
+  }
+  stats.scores.push_back(total);
+  stats.deadlockedGames += deadlocked;
+}
+
+/**
+ * @brief 一次模拟的共享状态
+ */
+struct Batch {
+  const Options *options;       ///< 命令行选项
+  int chunk;                    ///< 每个任务的对局数
+  std::vector<Stats> chunks;    ///< 各任务的统计，下标为首局序号 / chunk
+  std::mutex mutex;             ///< 保护 remaining
+  std::condition_variable done; ///< 全部任务完成的通知
+  int remaining;                ///< 未完成的任务数
+};
+
+/**
+ * @brief 模拟序号 [begin, end) 的对局
+ * 区间超过一个任务时把后一半作为新任务压入本线程队列，自己继续处理前一半：
+ * 空闲线程从队列头部窃取的总是最早压入、也最大的那一半
+ */
+void runRange(WorkStealingPool &pool, Batch &batch, int begin, int end) {
+  const int chunk = batch.chunk;
+  while (end - begin > chunk) {
+    const int count = (end - begin + chunk - 1) / chunk;
+    const int mid = begin + count / 2 * chunk;
+    pool.submit([&pool, &batch, mid, end]() {
+      runRange(pool, batch, mid, end);
+    });
+    end = mid;
+  }
+
+  const Options &options = *batch.options;
+  Stats &stats = batch.chunks[begin / chunk];
+  stats.scores.reserve(end - begin);
+  GameSession session(0);
+  session.map().setRefillPolicy(options.refill);
+  Player player(options);
+  for (int g = begin; g < end; g++) {
+    const uint64_t seed = options.seed + g;
+    session.map().setSeed(seed);
+    session.newGame();
+    player.reset(seed);
+    if (options.challenge) {
+      playChallenge(options, session, player, stats);
+    } else {
+      playEndless(options, session, player, stats);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(batch.mutex);
+  if (--batch.remaining == 0) {
+    batch.done.notify_all();
+  }
+}
+
+/**
+ * @brief 汇总后的报告数据
+ */
+struct Summary {
+  double seconds;     ///< 模拟耗时
+  int threads;        ///< 线程数
+  uint64_t steals;    ///< 线程池的窃取次数
+  double scoreMean;   ///< 平均得分
+  double scoreStddev; ///< 得分标准差
+  int scoreMin;       ///< 最低得分
+  int scoreP10;       ///< 得分 10% 分位
+  int scoreP50;       ///< 得分中位数
+  int scoreP90;       ///< 得分 90% 分位
+  int scoreP99;       ///< 得分 99% 分位
+  int scoreMax;       ///< 最高得分
+  double cascadeMean; ///< 平均连锁长度
+};
+
+Summary summarize(Stats &total) {
+  Summary s = Summary();
+  std::vector<int> &scores = total.scores;
+  double sum = 0;
+  double squares = 0;
+  for (int score : scores) {
+    sum += score;
+    squares += double(score) * score;
+  }
+  const double n = static_cast<double>(scores.size());
+  s.scoreMean = sum / n;
+  s.scoreStddev = std::sqrt(std::max(0.0, squares / n - s.scoreMean *
+                                                            s.scoreMean));
+  std::sort(scores.begin(), scores.end());
+  s.scoreMin = scores.front();
+  s.scoreP10 = nearestRank(scores, 0.10);
+  s.scoreP50 = nearestRank(scores, 0.50);
+  s.scoreP90 = nearestRank(scores, 0.90);
+  s.scoreP99 = nearestRank(scores, 0.99);
+  s.scoreMax = scores.back();
+  double cascadeSum = 0;
+  for (size_t i = 1; i < total.cascades.size(); i++) {
+    cascadeSum += double(i) * total.cascades[i];
+  }
+  s.cascadeMean = total.moves ? cascadeSum / total.moves : 0;
+  return s;
+}
+
+const char *policyName(SimPolicy policy) {
+  switch (policy) {
+  case POLICY_RANDOM:
+    return "random";
+  case POLICY_GREEDY:
+    return "greedy";
+  default:
+    return "hint";
+  }
+}
+
+// 比值，分母为 0 时为 0
+double ratio(double a, double b) { return b > 0 ? a / b : 0; }
+
+/**
+ * @brief 写出 JSON 报告
+ */
+void writeJson(std::ostream &out, const Options &options,
+               const Stats &total, const Summary &s) {
+  const double games = options.games;
+  out << "{\n  \"simulation\": \"gemsim\",\n"
+      << "  \"mode\": \"" << (options.challenge ? "challenge" : "endless")
+      << "\",\n  \"policy\": \"" << policyName(options.policy) << "\",\n"
+      << "  \"refill\": \""
+      << (options.refill == REFILL_PLAYABLE ? "playable" : "random")
+      << "\",\n  \"games\": " << options.games << ",\n"
+      << "  \"firstSeed\": " << options.seed << ",\n"
+      << "  \"threads\": " << s.threads << ",\n"
+      << "  \"steals\": " << s.steals << ",\n"
+      << "  \"seconds\": " << s.seconds << ",\n"
+      << "  \"gamesPerSec\": " << games / s.seconds << ",\n"
+      << "  \"movesPerSec\": " << total.moves / s.seconds << ",\n"
+      << "  \"movesPerGame\": " << total.moves / games << ",\n"
+      << "  \"score\": {\"mean\": " << s.scoreMean
+      << ", \"stddev\": " << s.scoreStddev << ", \"min\": " << s.scoreMin
+      << ", \"p10\": " << s.scoreP10 << ", \"p50\": " << s.scoreP50
+      << ", \"p90\": " << s.scoreP90 << ", \"p99\": " << s.scoreP99
+      << ", \"max\": " << s.scoreMax << "},\n"
+      << "  \"cascadeMean\": " << s.cascadeMean << ",\n"
+      << "  \"cascadeLength\": [";
+  for (size_t i = 1; i < total.cascades.size(); i++) {
+    out << (i > 1 ? ", " : "") << total.cascades[i];
+  }
+  out << "],\n  \"deadlocks\": " << total.reshuffles << ",\n"
+      << "  \"deadlocksPerMove\": " << ratio(total.reshuffles, total.moves)
+      << ",\n  \"gamesWithDeadlock\": " << total.deadlockedGames;
+  if (options.challenge) {
+    out << ",\n  \"thinkMs\": " << options.thinkMs << ",\n  \"levels\": [";
+    for (int level = 1; level <= options.levels; level++) {
+      out << (level > 1 ? ",\n    " : "\n    ") << "{\"level\": " << level
+          << ", \"timeLimit\": " << challengeTime(level)
+          << ", \"targetScore\": " << challengeTargetScore(level)
+          << ", \"attempts\": " << total.attempts[level]
+          << ", \"passes\": " << total.passes[level] << ", \"passRate\": "
+          << ratio(total.passes[level], total.attempts[level])
+          << ", \"meanPassSeconds\": "
+          << ratio(total.passSeconds[level], total.passes[level])
+          << ", \"meanPassMoves\": "
+          << ratio(total.passMoves[level], total.passes[level]) << "}";
+    }
+    out << "\n  ]";
+  }
+  out << "\n}\n";
+}
+
+/**
+ * @brief 写出 CSV 报告
+ * 长表格式：每行一个指标，index 为连锁长度或关卡数，便于直接透视
+ */
+void writeCsv(std::ostream &out, const Options &options, const Stats &total,
+              const Summary &s) {
+  const double games = options.games;
+  out << "metric,index,value\n"
+      << "games,," << options.games << "\n"
+      << "firstSeed,," << options.seed << "\n"
+      << "threads,," << s.threads << "\n"
+      << "seconds,," << s.seconds << "\n"
+      << "gamesPerSec,," << games / s.seconds << "\n"
+      << "movesPerGame,," << total.moves / games << "\n"
+      << "scoreMean,," << s.scoreMean << "\n"
+      << "scoreStddev,," << s.scoreStddev << "\n"
+      << "scoreMin,," << s.scoreMin << "\n"
+      << "scoreP10,," << s.scoreP10 << "\n"
+      << "scoreP50,," << s.scoreP50 << "\n"
+      << "scoreP90,," << s.scoreP90 << "\n"
+      << "scoreP99,," << s.scoreP99 << "\n"
+      << "scoreMax,," << s.scoreMax << "\n"
+      << "cascadeMean,," << s.cascadeMean << "\n";
+  for (size_t i = 1; i < total.cascades.size(); i++) {
+    out << "cascadeLength," << i << "," << total.cascades[i] << "\n";
+  }
+  out << "deadlocks,," << total.reshuffles << "\n"
+      << "deadlocksPerMove,," << ratio(total.reshuffles, total.moves) << "\n"
+      << "gamesWithDeadlock,," << total.deadlockedGames << "\n";
+  if (!options.challenge) {
+    return;
+  }
+  for (int level = 1; level <= options.levels; level++) {
+    out << "timeLimit," << level << "," << challengeTime(level) << "\n"
+        << "targetScore," << level << "," << challengeTargetScore(level)
+        << "\n"
+        << "attempts," << level << "," << total.attempts[level] << "\n"
+        << "passes," << level << "," << total.passes[level] << "\n"
+        << "passRate," << level << ","
+        << ratio(total.passes[level], total.attempts[level]) << "\n"
+        << "meanPassSeconds," << level << ","
+        << ratio(total.passSeconds[level], total.passes[level]) << "\n"
+        << "meanPassMoves," << level << ","
+        << ratio(total.passMoves[level], total.passes[level]) << "\n";
+  }
+}
+
+void writeReport(std::ostream &out, const Options &options,
+                 const Stats &total, const Summary &s) {
+  if (options.csv) {
+    writeCsv(out, options, total, s);
+  } else {
+    writeJson(out, options, total, s);
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Stats total(options.levels);
+  int threads = 0;
+  uint64_t steals = 0;
+  {
+    WorkStealingPool pool(options.threads);
+    Batch batch;
+    batch.options = &options;
+    // 每个线程至少分到十几个任务，窃取才有余地均衡各局长短不一的耗时
+    batch.chunk = std::max(
+        1, std::min(MAX_CHUNK, options.games / (pool.size() * 16)));
+    batch.remaining = (options.games + batch.chunk - 1) / batch.chunk;
+    batch.chunks.assign(batch.remaining, Stats(options.levels));
+    pool.submit([&pool, &batch, &options]() {
+      runRange(pool, batch, 0, options.games);
+    });
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&batch]() { return batch.remaining == 0; });
+    lock.unlock();
+
+    threads = pool.size();
+    steals = pool.steals();
+    for (const Stats &stats : batch.chunks) {
+      total.merge(stats);
+    }
+  }
+  Summary summary = summarize(total);
+  summary.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  summary.threads = threads;
+  summary.steals = steals;
+
+  if (options.out.empty()) {
+    writeReport(std::cout, options, total, summary);
+    return 0;
+  }
+  std::ofstream file(options.out);
+  if (!file) {
+    std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+    return 1;
+  }
+  writeReport(file, options, total, summary);
+  return file ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = gemsim
+
+# 批量对局模拟：命令行程序，不链接任何 Qt 模块
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+SOURCES += \
+    main.cpp
+
+DESTDIR = $$top_builddir/bin
@@ -0,0 +1,50 @@
+#include "TestSupport.h"
+#include <cstdio>
+
+namespace {
+
+const uint64_t BITBOARD_SEED = 20240605; ///< 随机种子
+const int RANDOM_BOARDS = 300;           ///< 每个尺寸的随机棋盘数
+
+/**
+ * @brief 随机棋盘测试
+ * 含空格、颜色较少的棋盘直接写入地图，核对匹配掩码、得分与坐标列表
+ */
+template <int Rows, int Cols> void testRandomBoards(uint64_t seed) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  typedef typename MapType::Board Board;
+  char label[32];
+  std::snprintf(label, sizeof(label), "bitboard %dx%d", Rows, Cols);
+
+  Random rng(seed);
+  for (int i = 0; i < RANDOM_BOARDS; i++) {
+    const Grid grid = randomGrid(Rows, Cols, rng);
+    MapType map(seed + i);
+    loadGrid(map, grid);
+    const typename MapType::Mask mask = map.matchMask();
+    check(maskMatches<MapType>(mask, grid), "%s: matchMask", label);
+    check(map.maskScore(mask) == grid.matchScore(), "%s: maskScore", label);
+
+    typename MapType::CellList cells;
+    map.checkMatches(cells);
+    typename MapType::Mask fromCells = typename MapType::Mask();
+    for (const CellPos &cell : cells) {
+      fromCells |= Board::cellBit(Board::bitIndex(cell.row, cell.col));
+    }
+    check(maskMatches<MapType>(fromCells, grid), "%s: checkMatches", label);
+    check(map.checkMatches().size() == static_cast<size_t>(cells.size()),
+          "%s: checkMatches (vector)", label);
+  }
+}
+
+} // namespace
+
+/**
+ * @brief 位棋盘测试实现
+ */
+void testBitBoard() {
+  testRandomBoards<8, 8>(BITBOARD_SEED);
+  testRandomBoards<9, 9>(BITBOARD_SEED + 1);
+  testRandomBoards<10, 10>(BITBOARD_SEED + 2);
+  testRandomBoards<6, 5>(BITBOARD_SEED + 3);
+}
@@ -0,0 +1,52 @@
+#include "BoardBatch.h"
+#include "TestSupport.h"
+
+namespace {
+
+const uint64_t BATCH_SEED = 20240609; ///< 随机种子
+const int BATCH_BOARDS = 1003; ///< 棋盘数（不是通道数的整数倍，覆盖尾部）
+
+} // namespace
+
+/**
+ * @brief 批量评估测试实现
+ * 普通开局与含空格的随机棋盘混合，每种可用指令集的匹配掩码、
+ * 合法交换数与现成得分逐盘与朴素实现比较
+ */
+void testBoardBatch() {
+  Random rng(BATCH_SEED);
+  std::vector<Grid> grids;
+  std::vector<PackedBoard> boards;
+  for (int i = 0; i < BATCH_BOARDS; i++) {
+    GameMap map(BATCH_SEED + i);
+    if (i % 4 == 0) {
+      map.init();
+    } else {
+      loadGrid(map, randomGrid(ROW, COL, rng));
+    }
+    grids.push_back(gridOf(map));
+    boards.push_back(BoardBatch::pack(map));
+  }
+
+  for (int isa = BATCH_SCALAR; isa <= BoardBatch::bestIsa(); isa++) {
+    const char *name = BoardBatch::isaName(static_cast<BatchIsa>(isa));
+    std::vector<BoardEval> results(boards.size());
+    BoardBatch::evaluate(boards.data(), static_cast<int>(boards.size()),
+                         results.data(), static_cast<BatchIsa>(isa));
+    for (size_t i = 0; i < boards.size(); i++) {
+      const Grid &grid = grids[i];
+      uint64_t matches = 0;
+      for (int r = 0; r < ROW; r++) {
+        for (int c = 0; c < COL; c++) {
+          matches |= grid.matched(r, c) ? uint64_t(1) << (r * COL + c) : 0;
+        }
+      }
+      check(results[i].matches == matches, "batch %s: matches (board %zu)",
+            name, i);
+      check(results[i].moves == static_cast<int>(grid.moves().size()),
+            "batch %s: moves (board %zu)", name, i);
+      check(results[i].score == grid.matchScore(),
+            "batch %s: score (board %zu)", name, i);
+    }
+  }
+}
@@ -0,0 +1,108 @@
+#include "DynamicGameMap.h"
+#include "TestSupport.h"
+
+namespace {
+
+const uint64_t DYNAMIC_SEED = 20240607; ///< 随机种子
+const int DYNAMIC_BOARDS = 40;          ///< 每个尺寸的开局数
+
+/**
+ * @brief 测试的棋盘尺寸
+ */
+struct DynamicSize {
+  int rows;  ///< 行数
+  int cols;  ///< 列数
+  int kinds; ///< 宝石种类数
+};
+
+// 3 色小棋盘常有死局，覆盖 hasPossibleMove 的两种结果
+const DynamicSize DYNAMIC_SIZES[] = {
+    {3, 3, 3}, {4, 7, 3}, {8, 8, GEM_KIND}, {13, 21, 4}, {64, 48, 5}};
+
+// 读取大棋盘的各格颜色
+Grid gridOf(const DynamicGameMap &map) {
+  Grid grid{map.rows(), map.cols(), {}};
+  const uint8_t *cells = map.data();
+  for (int i = 0; i < map.rows() * map.cols(); i++) {
+    grid.cells.push_back(static_cast<GemType>(cells[i]));
+  }
+  return grid;
+}
+
+// 朴素实现判定的匹配格数
+size_t matchedCount(const Grid &grid) {
+  size_t count = 0;
+  for (int r = 0; r < grid.rows; r++) {
+    for (int c = 0; c < grid.cols; c++) {
+      count += grid.matched(r, c);
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief 核对稳定局面
+ * 没有现成匹配、没有空格，死局判定与逐对交换的结果一致
+ * @param dead 累计死局数
+ * @param alive 累计有步可走的局面数
+ */
+void checkStable(DynamicGameMap &map, const char *stage, int &dead,
+                 int &alive) {
+  const Grid grid = gridOf(map);
+  const int rows = map.rows();
+  const int cols = map.cols();
+  check(matchedCount(grid) == 0, "dynamic %dx%d: match after %s", rows, cols,
+        stage);
+  check(map.findMatches() == 0, "dynamic %dx%d: findMatches after %s", rows,
+        cols, stage);
+  bool full = true;
+  for (GemType type : grid.cells) {
+    full = full && type != EMPTY;
+  }
+  check(full, "dynamic %dx%d: empty cell after %s", rows, cols, stage);
+
+  const bool expected = !grid.moves().empty();
+  check(map.hasPossibleMove() == expected,
+        "dynamic %dx%d: hasPossibleMove after %s", rows, cols, stage);
+  (expected ? alive : dead)++;
+}
+
+} // namespace
+
+/**
+ * @brief 大棋盘测试实现
+ * 开局后核对没有现成匹配与死局判定；随机交换制造匹配后，
+ * 核对标记数与坐标列表，再结算到稳定并重复开局时的检查
+ */
+void testDynamicGameMap() {
+  Random rng(DYNAMIC_SEED);
+  int dead = 0;
+  int alive = 0;
+  for (const DynamicSize &size : DYNAMIC_SIZES) {
+    for (int i = 0; i < DYNAMIC_BOARDS; i++) {
+      DynamicGameMap map(size.rows, size.cols, size.kinds,
+                         DYNAMIC_SEED + i);
+      map.init();
+      checkStable(map, "init", dead, alive);
+
+      for (int n = size.rows * size.cols / 8; n >= 0; n--) {
+        const int r = rng.bounded(size.rows - 1);
+        const int c = rng.bounded(size.cols - 1);
+        if (rng.bounded(2)) {
+          map.swap(r, c, r, c + 1);
+        } else {
+          map.swap(r, c, r + 1, c);
+        }
+      }
+      const size_t matched = matchedCount(gridOf(map));
+      check(map.findMatches() == matched, "dynamic %dx%d: findMatches",
+            size.rows, size.cols);
+      check(map.checkMatches().size() == matched,
+            "dynamic %dx%d: checkMatches", size.rows, size.cols);
+      map.settle();
+      checkStable(map, "settle", dead, alive);
+    }
+  }
+  check(dead > 0 && alive > 0, "dynamic: %d dead, %d alive boards", dead,
+        alive);
+}
@@ -0,0 +1,75 @@
+#include "HintEngine.h"
+#include "TestSupport.h"
+#include <chrono>
+
+namespace {
+
+const uint64_t HINT_SEED = 20240613; ///< 随机种子
+const int HINT_BOARDS = 5;           ///< 每项检查的开局数
+const int DEEP_BUDGET_MS = 40;       ///< 深层搜索的时间预算
+const int DEADLINE_SLACK_MS = 20;    ///< 超出预算的容许量
+const int RELAXED_BUDGET_MS = 60000; ///< 足够完成全部采样的预算
+
+/**
+ * @brief 截止时间测试
+ * 深层搜索的单次采样远超预算，仍须在预算附近返回，且只报告完整的采样
+ */
+void testDeadline() {
+  typedef std::chrono::steady_clock Clock;
+  HintEngine engine;
+  engine.setSamples(1000);
+  for (int depth = 5; depth <= 6; depth++) {
+    engine.setDepth(depth);
+    for (int i = 0; i < HINT_BOARDS; i++) {
+      GameMap map(HINT_SEED + i);
+      map.init();
+      const Clock::time_point start = Clock::now();
+      const HintResult result = engine.findBestMove(map, DEEP_BUDGET_MS);
+      const long long elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                                start)
+              .count();
+      check(elapsed <= DEEP_BUDGET_MS + DEADLINE_SLACK_MS,
+            "hint depth %d: took %lld ms for a %d ms budget", depth, elapsed,
+            DEEP_BUDGET_MS);
+      check(result.found, "hint depth %d: no move", depth);
+      check(result.timedOut, "hint depth %d: not timed out", depth);
+    }
+  }
+}
+
+/**
+ * @brief 确定性测试
+ * 预算充足时结果与线程数无关，且完成全部采样
+ */
+void testDeterminism() {
+  HintEngine single(1);
+  HintEngine pooled(4);
+  for (HintEngine *engine : {&single, &pooled}) {
+    engine->setDepth(2);
+    engine->setSamples(4);
+    engine->setSeed(HINT_SEED);
+  }
+  for (int i = 0; i < HINT_BOARDS; i++) {
+    GameMap map(HINT_SEED + i);
+    map.init();
+    const HintResult a = single.findBestMove(map, RELAXED_BUDGET_MS);
+    const HintResult b = pooled.findBestMove(map, RELAXED_BUDGET_MS);
+    GameMap::MoveList moves;
+    check(!a.timedOut && a.samples == map.findMoves(moves) * 4,
+          "hint: samples %d", a.samples);
+    check(a.move == b.move, "hint: move depends on threads");
+    check(a.expectedScore == b.expectedScore,
+          "hint: score depends on threads");
+  }
+}
+
+} // namespace
+
+/**
+ * @brief 提示引擎测试实现
+ */
+void testHintEngine() {
+  testDeadline();
+  testDeterminism();
+}
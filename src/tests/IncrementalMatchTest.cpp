@@ -0,0 +1,50 @@
+#include "TestSupport.h"
+#include <cstdio>
+
+namespace {
+
+const uint64_t INCREMENTAL_SEED = 20240601; ///< 随机种子
+const int INCREMENTAL_ROUNDS = 400;         ///< 每个尺寸的对局回合数
+
+/**
+ * @brief 增量匹配测试
+ * 随机走合法交换、偶尔非法交换或改写格子，结算的每个阶段中
+ * 只检查脏行列的 checkMatchMask 都与全盘扫描及朴素实现一致
+ */
+template <int Rows, int Cols> void testIncremental(uint64_t seed) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  char label[32];
+  std::snprintf(label, sizeof(label), "incremental %dx%d", Rows, Cols);
+
+  const auto stage = [label](const MapType &map,
+                             typename MapType::Mask mask) {
+    check(maskMatches<MapType>(mask, gridOf(map)), "%s: checkMatchMask",
+          label);
+    check(mask == map.matchMask(), "%s: matchMask", label);
+  };
+
+  Random rng(seed);
+  MapType map(seed);
+  map.init();
+  for (int round = 0; round < INCREMENTAL_ROUNDS; round++) {
+    if (!map.hasAnyMove()) {
+      map.reset();
+      settle(map, stage);
+      continue;
+    }
+    randomChange(map, rng);
+    settle(map, stage);
+  }
+}
+
+} // namespace
+
+/**
+ * @brief 增量匹配测试实现
+ */
+void testIncrementalMatch() {
+  testIncremental<8, 8>(INCREMENTAL_SEED);
+  testIncremental<9, 9>(INCREMENTAL_SEED + 1);
+  testIncremental<10, 10>(INCREMENTAL_SEED + 2);
+  testIncremental<6, 5>(INCREMENTAL_SEED + 3);
+}
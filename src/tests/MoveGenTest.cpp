@@ -0,0 +1,70 @@
+#include "TestSupport.h"
+#include <cstdio>
+
+namespace {
+
+const uint64_t MOVE_SEED = 20240603; ///< 随机种子
+const int MOVE_BOARDS = 300;         ///< 每个尺寸的随机棋盘数
+const int MOVE_ROUNDS = 300;         ///< 每个尺寸的对局回合数
+
+/**
+ * @brief 核对合法交换与死局判定
+ * 各个 findMoves 重载的结果与顺序都与朴素实现相同
+ */
+template <class MapType> void checkMoves(MapType &map, const char *label) {
+  const std::vector<Move> expected = gridOf(map).moves();
+  typename MapType::MoveList moves;
+  const int count = map.findMoves(moves);
+  check(count == static_cast<int>(expected.size()) &&
+            std::vector<Move>(moves.begin(), moves.end()) == expected,
+        "%s: findMoves (%d, expected %d)", label, count,
+        static_cast<int>(expected.size()));
+  std::vector<Move> list(1, Move{0, 0, 0, 0}); // 输出前应先清空
+  map.findMoves(list);
+  check(list == expected, "%s: findMoves (vector)", label);
+  check(map.findMoves() == expected, "%s: findMoves (return)", label);
+  check(map.hasAnyMove() == !expected.empty(), "%s: hasAnyMove", label);
+  check(map.hasPossibleMove() == !expected.empty(), "%s: hasPossibleMove",
+        label);
+}
+
+/**
+ * @brief 交换生成测试
+ * 含空格、颜色较少的随机棋盘，以及随机对局中的稳定局面
+ */
+template <int Rows, int Cols> void testMoves(uint64_t seed) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  char label[32];
+  std::snprintf(label, sizeof(label), "moves %dx%d", Rows, Cols);
+
+  Random rng(seed);
+  for (int i = 0; i < MOVE_BOARDS; i++) {
+    MapType map(seed + i);
+    loadGrid(map, randomGrid(Rows, Cols, rng));
+    checkMoves(map, label);
+  }
+
+  MapType map(seed);
+  map.init();
+  for (int round = 0; round < MOVE_ROUNDS; round++) {
+    checkMoves(map, label);
+    if (!map.hasAnyMove()) {
+      map.reset();
+      continue;
+    }
+    randomChange(map, rng);
+    settle(map);
+  }
+}
+
+} // namespace
+
+/**
+ * @brief 交换生成测试实现
+ */
+void testMoveGen() {
+  testMoves<8, 8>(MOVE_SEED);
+  testMoves<9, 9>(MOVE_SEED + 1);
+  testMoves<10, 10>(MOVE_SEED + 2);
+  testMoves<6, 5>(MOVE_SEED + 3);
+}
@@ -0,0 +1,97 @@
+#include "Replay.h"
+#include "TestSupport.h"
+#include <filesystem>
+#include <string>
+
+namespace {
+
+const uint64_t REPLAY_SEED = 20240611; ///< 随机种子
+const int REPLAY_GAMES = 12;           ///< 回放对局数
+const int REPLAY_TURNS = 150;          ///< 每局回放的事件数上限
+
+} // namespace
+
+/**
+ * @brief 回放测试实现
+ * 录制含交换、撤销与分数清零的对局，序列化后解析、逐事件校验，
+ * 并以随机顺序跳转到每个事件，状态哈希与录制时一致
+ */
+void testReplay() {
+  const uint64_t seed = REPLAY_SEED;
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "gametests.bjr").string();
+  Random rng(seed);
+  for (int g = 0; g < REPLAY_GAMES; g++) {
+    GameSession session(seed + g);
+    session.map().setRefillPolicy(g % 2 ? REFILL_PLAYABLE : REFILL_RANDOM);
+    session.map().setColumnStreams(g % 3 == 0);
+    session.newGame();
+    Replay replay;
+    replay.begin(session, 1 + g % 8);
+    std::vector<uint64_t> hashes(1, Replay::stateHash(session));
+    for (int t = 0; t < REPLAY_TURNS; t++) {
+      const uint32_t action = rng.bounded(20);
+      const uint32_t delta = rng.bounded(5000);
+      if (action < 3 && session.undo()) {
+        replay.recordUndo(delta, session);
+      } else if (action == 3) {
+        session.setScore(0);
+        replay.recordScoreReset(delta, session);
+      } else {
+        GameMap::MoveList moves;
+        if (session.map().findMoves(moves) == 0) {
+          break;
+        }
+        const Move move = moves[rng.bounded(moves.size())];
+        session.playMove(move);
+        replay.recordMove(move, delta, session);
+      }
+      hashes.push_back(Replay::stateHash(session));
+    }
+
+    const std::vector<uint8_t> bytes = replay.serialize();
+    Replay parsed;
+    std::string error;
+    check(parsed.parse(bytes, &error), "replay %d: parse: %s", g,
+          error.c_str());
+    check(parsed.serialize() == bytes, "replay %d: round trip", g);
+    check(parsed.turns() == replay.turns() &&
+              parsed.finalHash() == hashes.back(),
+          "replay %d: header", g);
+    for (int i = 0; i < parsed.turns() && i < replay.turns(); i++) {
+      const ReplayEvent &a = replay.event(i);
+      const ReplayEvent &b = parsed.event(i);
+      check(a.code == b.code && a.deltaMs == b.deltaMs && a.check == b.check,
+            "replay %d: event %d", g, i);
+    }
+
+    Replay loaded;
+    check(replay.save(path) && loaded.load(path, &error) &&
+              loaded.serialize() == bytes,
+          "replay %d: save/load %s", g, error.c_str());
+
+    ReplayPlayer player(parsed);
+    check(player.verify() == -1, "replay %d: verify", g);
+    std::vector<int> order;
+    for (int t = 0; t <= parsed.turns(); t++) {
+      order.push_back(t);
+    }
+    for (int i = static_cast<int>(order.size()) - 1; i > 0; i--) {
+      std::swap(order[i], order[rng.bounded(i + 1)]);
+    }
+    for (int t : order) {
+      check(player.seek(t) && player.turn() == t &&
+                Replay::stateHash(player.session()) == hashes[t],
+            "replay %d: seek %d", g, t);
+    }
+    check(!player.seek(parsed.turns() + 1), "replay %d: seek past end", g);
+    check(player.seek(0) && player.turn() == 0, "replay %d: seek 0", g);
+    for (int t = 1; t <= parsed.turns(); t++) {
+      check(player.step() &&
+                Replay::stateHash(player.session()) == hashes[t],
+            "replay %d: step %d", g, t);
+    }
+    check(!player.step(), "replay %d: step past end", g);
+  }
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,137 @@
+#include "TestSupport.h"
+#include "GameMapImpl.h"
+#include <cstdarg>
+#include <cstdio>
+#include <utility>
+
+template class BasicGameMap<6, 5, GEM_KIND>;
+
+namespace {
+
+const int MAX_REPORTED = 20; ///< 最多逐条报告的失败数
+
+int g_checks = 0;   ///< 检查总数
+int g_failures = 0; ///< 失败数
+
+} // namespace
+
+/**
+ * @brief 记录一项检查实现
+ * @param ok 检查是否通过
+ * @param format 失败说明
+ */
+void check(bool ok, const char *format, ...) {
+  g_checks++;
+  if (ok) {
+    return;
+  }
+  if (++g_failures <= MAX_REPORTED) {
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(stderr, format, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+  }
+}
+
+// 获取检查总数
+int checkCount() { return g_checks; }
+
+// 获取失败数
+int failureCount() { return g_failures; }
+
+/**
+ * @brief 同色连续段长度实现
+ * @param r 行
+ * @param c 列
+ * @param dr 行方向
+ * @param dc 列方向
+ * @return 经过 (r, c) 的连续段长度
+ */
+int Grid::run(int r, int c, int dr, int dc) const {
+  const GemType type = at(r, c);
+  int length = 1;
+  for (int sign = -1; sign <= 1; sign += 2) {
+    int nr = r + sign * dr;
+    int nc = c + sign * dc;
+    while (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
+           at(nr, nc) == type) {
+      length++;
+      nr += sign * dr;
+      nc += sign * dc;
+    }
+  }
+  return length;
+}
+
+// 现成匹配的得分
+int Grid::matchScore() const {
+  int score = 0;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      score += matched(r, c) ? GEM_SCORES[at(r, c)] : 0;
+    }
+  }
+  return score;
+}
+
+/**
+ * @brief 合法交换实现
+ * 逐对交换后检查两格，右、下两个方向依次枚举
+ * @return 合法交换列表
+ */
+std::vector<Move> Grid::moves() const {
+  std::vector<Move> result;
+  Grid trial = *this;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      const Move candidates[2] = {{r, c, r, c + 1}, {r, c, r + 1, c}};
+      for (const Move &move : candidates) {
+        if (move.r2 >= rows || move.c2 >= cols) {
+          continue;
+        }
+        GemType &a = trial.cells[move.r1 * cols + move.c1];
+        GemType &b = trial.cells[move.r2 * cols + move.c2];
+        if (a == b || a == EMPTY || b == EMPTY) {
+          continue;
+        }
+        std::swap(a, b);
+        if (trial.matched(move.r1, move.c1) ||
+            trial.matched(move.r2, move.c2)) {
+          result.push_back(move);
+        }
+        std::swap(a, b);
+      }
+    }
+  }
+  return result;
+}
+
+// 左右镜像
+Grid Grid::mirrored() const {
+  Grid result = *this;
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      result.cells[r * cols + c] = at(r, cols - 1 - c);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief 随机棋盘实现
+ * @param rows 行数
+ * @param cols 列数
+ * @param rng 随机数
+ * @return 棋盘
+ */
+Grid randomGrid(int rows, int cols, Random &rng) {
+  const int kinds = 3 + rng.bounded(GEM_KIND - 2);
+  Grid grid{rows, cols, std::vector<GemType>(rows * cols, EMPTY)};
+  for (GemType &type : grid.cells) {
+    if (rng.bounded(12) != 0) {
+      type = static_cast<GemType>(1 + rng.bounded(kinds));
+    }
+  }
+  return grid;
+}
@@ -0,0 +1,162 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include "GameMap.h"
+#include "Random.h"
+#include <vector>
+
+// 非方形棋盘只在测试中实例化（见 TestSupport.cpp）
+extern template class BasicGameMap<6, 5, GEM_KIND>;
+
+/**
+ * @brief 记录一项检查
+ * 失败时按 printf 格式报告（超过一定条数后只计数）
+ * @param ok 检查是否通过
+ * @param format 失败说明
+ */
+void check(bool ok, const char *format, ...);
+
+// 获取检查总数
+int checkCount();
+
+// 获取失败数
+int failureCount();
+
+/**
+ * @brief 朴素实现用的棋盘
+ * 按行优先存放各格颜色，所有判定都逐格计算，不依赖位运算
+ */
+struct Grid {
+  int rows;                   ///< 行数
+  int cols;                   ///< 列数
+  std::vector<GemType> cells; ///< 各格颜色
+
+  GemType at(int r, int c) const { return cells[r * cols + c]; }
+
+  // 同色连续段经过 (r, c) 的长度，(dr, dc) 为方向
+  int run(int r, int c, int dr, int dc) const;
+
+  // 该格是否在三连及以上的横线或竖线中
+  bool matched(int r, int c) const {
+    return at(r, c) != EMPTY && (run(r, c, 0, 1) >= 3 || run(r, c, 1, 0) >= 3);
+  }
+
+  // 现成匹配的得分
+  int matchScore() const;
+
+  // 合法交换：两格非空、颜色不同，交换后任一格在三连中；顺序与 findMoves 相同
+  std::vector<Move> moves() const;
+
+  // 左右镜像
+  Grid mirrored() const;
+};
+
+/**
+ * @brief 随机棋盘
+ * 颜色数在 3 ~ GEM_KIND 之间随机，颜色少时匹配多；约 1/12 的格子为空
+ */
+Grid randomGrid(int rows, int cols, Random &rng);
+
+// 读取地图的各格颜色
+template <class MapType> Grid gridOf(const MapType &map) {
+  Grid grid{MapType::ROWS, MapType::COLS, {}};
+  for (int r = 0; r < MapType::ROWS; r++) {
+    for (int c = 0; c < MapType::COLS; c++) {
+      grid.cells.push_back(map.getGemType(r, c));
+    }
+  }
+  return grid;
+}
+
+// 把各格颜色逐格写入地图
+template <class MapType> void loadGrid(MapType &map, const Grid &grid) {
+  for (int r = 0; r < grid.rows; r++) {
+    for (int c = 0; c < grid.cols; c++) {
+      map.setGemType(r, c, grid.at(r, c));
+    }
+  }
+}
+
+// 掩码中的格子是否恰为朴素实现判定的匹配格
+template <class MapType>
+bool maskMatches(typename MapType::Mask mask, const Grid &grid) {
+  typedef typename MapType::Board Board;
+  for (int r = 0; r < grid.rows; r++) {
+    for (int c = 0; c < grid.cols; c++) {
+      if (bool(mask & Board::cellBit(Board::bitIndex(r, c))) !=
+          grid.matched(r, c)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 随机改动一步（不结算）
+ * 多数为合法交换，偶尔为任意相邻交换（可能不形成匹配）或改写几个格子
+ * @param map 地图（需有合法交换）
+ * @param rng 随机数
+ */
+template <class MapType> void randomChange(MapType &map, Random &rng) {
+  const int rows = MapType::ROWS;
+  const int cols = MapType::COLS;
+  const uint32_t action = rng.bounded(10);
+  if (action < 2) {
+    const int r = rng.bounded(rows - 1);
+    const int c = rng.bounded(cols - 1);
+    if (rng.bounded(2)) {
+      map.swap(r, c, r, c + 1);
+    } else {
+      map.swap(r, c, r + 1, c);
+    }
+  } else if (action < 3) {
+    for (int n = 1 + rng.bounded(3); n > 0; n--) {
+      map.setGemType(rng.bounded(rows), rng.bounded(cols),
+                     static_cast<GemType>(1 + rng.bounded(GEM_KIND)));
+    }
+  } else {
+    typename MapType::MoveList moves;
+    map.findMoves(moves);
+    const Move &move = moves[rng.bounded(moves.size())];
+    map.swap(move.r1, move.c1, move.r2, move.c2);
+  }
+}
+
+/**
+ * @brief 结算到稳定
+ * @param map 地图
+ * @param stage 每次增量检测后调用 stage(map, mask)，map 仍为检测前的棋盘
+ * @return 本回合得分
+ */
+template <class MapType, class Stage> int settle(MapType &map, Stage stage) {
+  int points = 0;
+  for (;;) {
+    const typename MapType::Mask mask = map.checkMatchMask();
+    stage(static_cast<const MapType &>(map), mask);
+    if (!mask) {
+      return points;
+    }
+    points += map.maskScore(mask);
+    map.eliminate(mask);
+    map.applyGravity();
+  }
+}
+
+// 结算到稳定，不检查中间阶段
+template <class MapType> int settle(MapType &map) {
+  return settle(map, [](const MapType &, typename MapType::Mask) {});
+}
+
+// 各组测试，分别定义在同名的 *Test.cpp 中
+void testBitBoard();
+void testBoardBatch();
+void testDynamicGameMap();
+void testHintEngine();
+void testIncrementalMatch();
+void testMoveGen();
+void testReplay();
+void testUndo();
+void testZobrist();
+
+#endif // TESTSUPPORT_H
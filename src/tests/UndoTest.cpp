@@ -0,0 +1,240 @@
+#include "TestSupport.h"
+#include "UndoJournal.h"
+#include <cstdio>
+#include <deque>
+
+namespace {
+
+const uint64_t UNDO_SEED = 20240608; ///< 随机种子
+const int UNDO_ROUNDS = 600;         ///< 每个用例的对局回合数
+
+// 小预算：40 字节只放得下改动不超过 10 格的一步
+const size_t SMALL_BUDGETS[] = {40, 96, 512, 4096};
+
+/**
+ * @brief 撤销前的完整状态
+ */
+struct Saved {
+  Grid grid;     ///< 棋盘
+  int score;     ///< 分数
+  uint64_t hash; ///< 局面哈希
+};
+
+/**
+ * @brief 撤销日志的预期模型
+ * 只记录每条封存记录的字节数，按 UndoJournal 的规则推算
+ * 环形缓冲的占用、淘汰与回绕，从而得到精确的预期撤销深度
+ */
+struct JournalModel {
+  size_t budget;              ///< 内存预算
+  size_t head = 0;            ///< 最旧记录的起始偏移
+  size_t used = 0;            ///< 已用字节数
+  std::deque<size_t> records; ///< 已封存记录的字节数，最旧的在前
+  bool open = false;          ///< 是否有打开的步骤
+  int evictions = 0;          ///< 因空间不足丢弃的步数
+  int wraps = 0;              ///< 记录跨过缓冲末尾的次数
+  int oversized = 0;          ///< 单步超出预算的次数
+
+  explicit JournalModel(size_t bytes) : budget(bytes) {}
+
+  size_t depth() const { return records.size() + (open ? 1 : 0); }
+
+  void clear() {
+    records.clear();
+    head = 0;
+    used = 0;
+    open = false;
+  }
+
+  // 丢弃最旧的记录
+  void dropOldest() {
+    head = (head + records.front()) % budget;
+    used -= records.front();
+    records.pop_front();
+  }
+
+  /**
+   * @brief 封存打开的步骤
+   * @param kept 与步骤开始时不同的格子数
+   * @return 被丢弃的步数（含本步）
+   */
+  size_t seal(size_t kept) {
+    const size_t size = 8 + 3 * kept;
+    open = false;
+    if (size > budget) {
+      oversized++;
+      const size_t dropped = records.size() + 1;
+      clear();
+      return dropped;
+    }
+    size_t dropped = 0;
+    while (budget - used < size) {
+      dropOldest();
+      evictions++;
+      dropped++;
+    }
+    if ((head + used) % budget + size > budget) {
+      wraps++;
+    }
+    used += size;
+    records.push_back(size);
+    return dropped;
+  }
+
+  // 取出最新的封存记录作为打开步骤（撤销或丢弃最新一步后）
+  void popNewest() {
+    if (!open) {
+      return;
+    }
+    open = !records.empty();
+    if (open) {
+      used -= records.back();
+      records.pop_back();
+    }
+  }
+
+  /**
+   * @brief 改变预算
+   * @return 被丢弃的步数
+   */
+  size_t resize(size_t bytes) {
+    if (bytes == budget) {
+      return 0;
+    }
+    size_t dropped = 0;
+    while (used > bytes) {
+      used -= records.front();
+      records.pop_front();
+      dropped++;
+    }
+    budget = bytes;
+    head = 0;
+    return dropped;
+  }
+};
+
+// 两个棋盘不同的格子数
+size_t diffCells(const Grid &a, const Grid &b) {
+  size_t count = 0;
+  for (size_t i = 0; i < a.cells.size(); i++) {
+    count += a.cells[i] != b.cells[i];
+  }
+  return count;
+}
+
+/**
+ * @brief 撤销测试
+ * 每步开始前保存完整状态，随机对局中穿插连续撤销与丢弃最新一步，
+ * 每次撤销后的棋盘、分数与哈希都与保存的状态一致，且恢复的局面已稳定；
+ * 撤销深度与按预算推算的模型逐步相同
+ * @param budget 内存预算
+ * @param resizes 对局中是否随机改变预算（在 SMALL_BUDGETS 中选取）
+ * @return 预期模型，供调用方检查淘汰、回绕等情形确实发生
+ */
+template <int Rows, int Cols>
+JournalModel testUndo(uint64_t seed, size_t budget, bool resizes) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  char label[48];
+  std::snprintf(label, sizeof(label), "undo %dx%d (%zu bytes%s)", Rows, Cols,
+                budget, resizes ? ", resized" : "");
+
+  Random rng(seed);
+  MapType map(seed);
+  map.init();
+  map.setHistoryBudget(budget);
+  JournalModel model(budget);
+  std::deque<Saved> saved; // 与可撤销的步骤一一对应，最旧的在前
+  int score = 0;
+  for (int round = 0; round < UNDO_ROUNDS; round++) {
+    check(map.historyDepth() == model.depth(), "%s: historyDepth", label);
+    check(saved.size() == model.depth(), "%s: snapshot count", label);
+    if (!map.hasAnyMove()) {
+      map.reset();
+      settle(map);
+      map.clearHistory();
+      model.clear();
+      saved.clear();
+      continue;
+    }
+
+    const uint32_t action = rng.bounded(20);
+    if (resizes && action == 0) {
+      const size_t bytes = SMALL_BUDGETS[rng.bounded(4)];
+      map.setHistoryBudget(bytes);
+      saved.erase(saved.begin(), saved.begin() + model.resize(bytes));
+      continue;
+    }
+    if (action < 2) {
+      map.popLastState();
+      if (!saved.empty()) {
+        saved.pop_back();
+      }
+      model.popNewest();
+      continue;
+    }
+    if (action < 4) {
+      for (int n = 1 + rng.bounded(4); n > 0; n--) {
+        if (!map.undo()) {
+          check(saved.empty(), "%s: undo refused", label);
+          break;
+        }
+        if (saved.empty()) {
+          check(false, "%s: undo past the last step", label);
+          break;
+        }
+        const Saved &top = saved.back();
+        check(gridOf(map).cells == top.grid.cells, "%s: undo board", label);
+        check(map.getLastUndoScore() == top.score, "%s: undo score", label);
+        check(map.hash() == top.hash, "%s: undo hash", label);
+        score = top.score;
+        saved.pop_back();
+        model.popNewest();
+        check(settle(map) == 0, "%s: undo left a match", label);
+      }
+      continue;
+    }
+
+    if (model.open) {
+      const size_t kept = diffCells(saved.back().grid, gridOf(map));
+      saved.erase(saved.begin(), saved.begin() + model.seal(kept));
+    }
+    saved.push_back(Saved{gridOf(map), score, map.hash()});
+    map.saveCurState(score);
+    model.open = true;
+    check(map.getLastStepScore() == score, "%s: step score", label);
+    randomChange(map, rng);
+    score += settle(map);
+  }
+  return model;
+}
+
+} // namespace
+
+/**
+ * @brief 撤销测试实现
+ * 默认预算下深度不受限；小预算下还要求淘汰最旧步骤、环形缓冲回绕
+ * 与单步超出预算的情形都实际发生过
+ */
+void testUndo() {
+  const size_t defaultBudget = UndoJournal<ROW * COL>::DEFAULT_BUDGET;
+  testUndo<8, 8>(UNDO_SEED, defaultBudget, false);
+  testUndo<9, 9>(UNDO_SEED + 1, defaultBudget, false);
+  testUndo<10, 10>(UNDO_SEED + 2, defaultBudget, false);
+  testUndo<6, 5>(UNDO_SEED + 3, defaultBudget, false);
+
+  int oversized = 0;
+  for (size_t i = 0; i < 4; i++) {
+    const size_t budget = SMALL_BUDGETS[i];
+    const JournalModel model =
+        testUndo<10, 10>(UNDO_SEED + 10 + i, budget, false);
+    check(model.evictions > 0, "undo %zu bytes: no step evicted", budget);
+    check(model.wraps > 0, "undo %zu bytes: ring never wrapped", budget);
+    oversized += model.oversized;
+    testUndo<6, 5>(UNDO_SEED + 20 + i, budget, false);
+  }
+  check(oversized > 0, "undo: no step exceeded the budget");
+
+  const JournalModel model =
+      testUndo<8, 8>(UNDO_SEED + 30, SMALL_BUDGETS[0], true);
+  check(model.evictions > 0, "undo (resized): no step evicted");
+}
@@ -0,0 +1,115 @@
+#include "PositionCache.h"
+#include "TestSupport.h"
+#include <cstdio>
+
+namespace {
+
+const uint64_t ZOBRIST_SEED = 20240615; ///< 随机种子
+const int HASH_ROUNDS = 300;            ///< 每个尺寸的对局回合数
+const int CACHE_BOARDS = 500;           ///< 局面缓存的棋盘数
+
+/**
+ * @brief 核对增量哈希
+ * 哈希与镜像哈希都与按当前棋盘逐格重建的地图一致，规范哈希取两者中较小的
+ */
+template <class MapType> void checkHash(const MapType &map, const char *label) {
+  const Grid grid = gridOf(map);
+  MapType rebuilt(0);
+  loadGrid(rebuilt, grid);
+  check(map.hash() == rebuilt.hash(), "%s: hash", label);
+  MapType mirror(0);
+  loadGrid(mirror, grid.mirrored());
+  check(map.mirrorHash() == mirror.hash(), "%s: mirrorHash", label);
+  bool mirrored = false;
+  const uint64_t canonical = map.canonicalHash(&mirrored);
+  check(canonical == (mirrored ? map.mirrorHash() : map.hash()) &&
+            canonical <= map.hash() && canonical <= map.mirrorHash(),
+        "%s: canonicalHash", label);
+}
+
+/**
+ * @brief 增量哈希测试
+ * 随机对局中每次改动与每个结算阶段之后都核对哈希
+ */
+template <int Rows, int Cols> void testHash(uint64_t seed) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  char label[32];
+  std::snprintf(label, sizeof(label), "hash %dx%d", Rows, Cols);
+
+  Random rng(seed);
+  MapType map(seed);
+  map.init();
+  for (int round = 0; round < HASH_ROUNDS; round++) {
+    checkHash(map, label);
+    if (!map.hasAnyMove()) {
+      map.reset();
+      continue;
+    }
+    randomChange(map, rng);
+    settle(map, [label](const MapType &stage, typename MapType::Mask) {
+      checkHash(stage, label);
+    });
+  }
+}
+
+/**
+ * @brief 局面缓存测试
+ * 未命中、命中与镜像命中返回的交换都与直接计算相同；
+ * 搜索值按规范局面存取，镜像局面读到同一个值
+ */
+template <int Rows, int Cols> void testPositionCache(uint64_t seed) {
+  typedef BasicGameMap<Rows, Cols, GEM_KIND> MapType;
+  char label[32];
+  std::snprintf(label, sizeof(label), "cache %dx%d", Rows, Cols);
+
+  Random rng(seed);
+  BasicPositionCache<Rows, Cols, GEM_KIND> cache(64 << 10);
+  for (int i = 0; i < CACHE_BOARDS; i++) {
+    MapType map(seed + i);
+    if (i % 2 == 0) {
+      map.init();
+    } else {
+      loadGrid(map, randomGrid(Rows, Cols, rng));
+    }
+    const Grid grid = gridOf(map);
+    MapType mirror(0);
+    loadGrid(mirror, grid.mirrored());
+    const std::vector<Move> expected = grid.moves();
+    const std::vector<Move> expectedMirror = grid.mirrored().moves();
+
+    for (int pass = 0; pass < 2; pass++) {
+      typename MapType::MoveList moves;
+      cache.findMoves(map, moves);
+      check(std::vector<Move>(moves.begin(), moves.end()) == expected,
+            "%s: findMoves (board %d, pass %d)", label, i, pass);
+      cache.findMoves(mirror, moves);
+      check(std::vector<Move>(moves.begin(), moves.end()) == expectedMirror,
+            "%s: mirrored findMoves (board %d, pass %d)", label, i, pass);
+      check(cache.hasAnyMove(map) == !expected.empty(),
+            "%s: hasAnyMove (board %d, pass %d)", label, i, pass);
+    }
+
+    const int value = static_cast<int>(rng.bounded(100000));
+    cache.storeValue(map, 3, value);
+    int probed = -1;
+    check(cache.probeValue(mirror, 3, probed) && probed == value,
+          "%s: mirrored value (board %d)", label, i);
+    check(!cache.probeValue(map, 4, probed), "%s: deeper probe (board %d)",
+          label, i);
+  }
+  check(cache.hits() > 0, "%s: no hits", label);
+}
+
+} // namespace
+
+/**
+ * @brief Zobrist 哈希与局面缓存测试实现
+ */
+void testZobrist() {
+  testHash<8, 8>(ZOBRIST_SEED);
+  testHash<9, 9>(ZOBRIST_SEED + 1);
+  testHash<10, 10>(ZOBRIST_SEED + 2);
+  testHash<6, 5>(ZOBRIST_SEED + 3);
+  testPositionCache<8, 8>(ZOBRIST_SEED + 4);
+  testPositionCache<10, 10>(ZOBRIST_SEED + 5);
+}
@@ -0,0 +1,27 @@
+/**
+ * gametests：规则库的暴力等价测试
+ * 位棋盘内核、增量匹配、撤销日志、批量评估、局面缓存与回放的结果
+ * 逐项与朴素的逐格实现比较；任一项不一致时返回 1
+ */
+#include "TestSupport.h"
+#include <cstdio>
+
+/**
+ * @brief 程序主函数
+ * 各组测试使用固定种子，结果可复现
+ */
+int main() {
+  testBitBoard();
+  testIncrementalMatch();
+  testDynamicGameMap();
+  testBoardBatch();
+  testZobrist();
+  testMoveGen();
+  testUndo();
+  testReplay();
+  testHintEngine();
+
+  std::fprintf(stderr, "%d checks, %d failed\n", checkCount(),
+               failureCount());
+  return failureCount() ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+TEMPLATE = app
+TARGET = gametests
+
+# 规则库的暴力等价测试：命令行程序，不链接任何 Qt 模块；make check 运行
+CONFIG += console c++17 testcase
+CONFIG -= qt app_bundle
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+HEADERS += \
+    TestSupport.h
+
+SOURCES += \
+    BitBoardTest.cpp \
+    BoardBatchTest.cpp \
+    DynamicGameMapTest.cpp \
+    HintEngineTest.cpp \
+    IncrementalMatchTest.cpp \
+    main.cpp \
+    MoveGenTest.cpp \
+    ReplayTest.cpp \
+    TestSupport.cpp \
+    UndoTest.cpp \
+    ZobristTest.cpp
+
+DESTDIR = $$top_builddir/bin
@@ -0,0 +1,222 @@
+#include "BoardRenderer.h"
+#include <QStyle>
+#include <QStyleOption>
+#include <QWidget>
+
+/**
+ * @brief BoardRenderer构造函数实现
+ * 各层在第一次绘制时生成
+ */
+BoardRenderer::BoardRenderer() : m_gemsValid(false), m_dpr(0) {}
+
+// 使背景层失效
+void BoardRenderer::invalidateBackground() { m_background = QPixmap(); }
+
+/**
+ * @brief 绘制一帧实现
+ * 按背景、宝石、选中框、提示、分数的顺序合成，与原先逐项绘制的层次一致
+ * @param painter 窗口的绘制器
+ * @param widget 窗口
+ * @param dirty 重绘区域
+ * @param frame 画面内容
+ */
+void BoardRenderer::paint(QPainter &painter, QWidget *widget,
+                          const QRegion &dirty, const BoardFrame &frame) {
+  const qreal dpr = widget->devicePixelRatioF();
+  if (dpr != m_dpr) {
+    rebuildSprites(dpr);
+  }
+  if (m_background.isNull()) {
+    rebuildBackground(widget);
+  }
+  syncGems(*frame.map);
+
+  // 背景层与宝石层只复制重绘区域内的部分
+  blit(painter, m_background, widget->rect(), dirty);
+  blit(painter, m_gems,
+       QRect(frame.origin, QSize(COL * GEM_SIZE, ROW * GEM_SIZE)), dirty);
+
+  // 覆盖层
+  const QPoint margin(OVERLAY_MARGIN, OVERLAY_MARGIN);
+  if (frame.selected != QPoint(-1, -1)) {
+    painter.drawPixmap(frame.origin + frame.selected * GEM_SIZE - margin,
+                       m_selection);
+  }
+  if (frame.hint1 != QPoint(-1, -1) && frame.hint2 != QPoint(-1, -1)) {
+    const QPoint first(qMin(frame.hint1.x(), frame.hint2.x()),
+                       qMin(frame.hint1.y(), frame.hint2.y()));
+    const int vertical = frame.hint1.x() == frame.hint2.x() ? 1 : 0;
+    painter.drawPixmap(frame.origin + first * GEM_SIZE - margin,
+                       m_hints[vertical]);
+  }
+
+  // 分数只在文字或字体变化时重新排版
+  const QRect shadowRect =
+      frame.scoreRect.adjusted(0, 0, SHADOW_OFFSET, SHADOW_OFFSET);
+  if (!dirty.intersects(shadowRect)) {
+    return;
+  }
+  if (frame.score != m_scoreText.text() || frame.scoreFont != m_scoreFont) {
+    m_scoreFont = frame.scoreFont;
+    m_scoreText.setText(frame.score);
+    m_scoreText.prepare(QTransform(), m_scoreFont);
+  }
+  const QSizeF size = m_scoreText.size();
+  const QPointF pos(frame.scoreRect.x() +
+                        (frame.scoreRect.width() - size.width()) / 2,
+                    frame.scoreRect.y() +
+                        (frame.scoreRect.height() - size.height()) / 2);
+  painter.setFont(m_scoreFont);
+  painter.setPen(Qt::black); // 阴影，右下偏移
+  painter.drawStaticText(pos + QPointF(SHADOW_OFFSET, SHADOW_OFFSET),
+                         m_scoreText);
+  painter.setPen(QColor(255, 215, 0)); // 金色主文字
+  painter.drawStaticText(pos, m_scoreText);
+}
+
+/**
+ * @brief 生成与设备像素比相关的缓存实现
+ * 宝石按设备像素缩放，高分屏上保持清晰；缺失的图片留空
+ * @param dpr 设备像素比
+ */
+void BoardRenderer::rebuildSprites(qreal dpr) {
+  static const char *const paths[GEM_KIND] = {
+      ":/gems/assets/images/red.png",    ":/gems/assets/images/orange.png",
+      ":/gems/assets/images/yellow.png", ":/gems/assets/images/green.png",
+      ":/gems/assets/images/white.png",  ":/gems/assets/images/blue.png",
+      ":/gems/assets/images/purple.png"};
+
+  m_dpr = dpr;
+  const int cell = qMax(1, qRound(GEM_SIZE * dpr));
+  m_atlas = QPixmap(cell * GEM_KIND, cell);
+  m_atlas.fill(Qt::transparent);
+  {
+    QPainter painter(&m_atlas);
+    for (int k = 0; k < GEM_KIND; k++) {
+      QPixmap gem(paths[k]);
+      if (!gem.isNull()) {
+        painter.drawPixmap(k * cell, 0,
+                           gem.scaled(cell, cell, Qt::KeepAspectRatio,
+                                      Qt::SmoothTransformation));
+      }
+    }
+  }
+
+  // 覆盖层小图四周各留出画笔超出格子的宽度
+  const int side = GEM_SIZE + 2 * OVERLAY_MARGIN;
+  m_selection = QPixmap(qRound(side * dpr), qRound(side * dpr));
+  m_selection.setDevicePixelRatio(dpr);
+  m_selection.fill(Qt::transparent);
+  {
+    QPainter painter(&m_selection);
+    painter.translate(OVERLAY_MARGIN, OVERLAY_MARGIN);
+    painter.setPen(QPen(QColor(255, 215, 0), 3));
+    painter.drawRect(0, 0, GEM_SIZE, GEM_SIZE);
+  }
+  for (int vertical = 0; vertical < 2; vertical++) {
+    const int dx = vertical ? 0 : GEM_SIZE; // 第二格相对第一格的偏移
+    const int dy = vertical ? GEM_SIZE : 0;
+    QPixmap &hint = m_hints[vertical];
+    hint = QPixmap(qRound((side + dx) * dpr), qRound((side + dy) * dpr));
+    hint.setDevicePixelRatio(dpr);
+    hint.fill(Qt::transparent);
+    QPainter painter(&hint);
+    painter.translate(OVERLAY_MARGIN, OVERLAY_MARGIN);
+    painter.setPen(QPen(QColor(255, 255, 0), 2, Qt::DashLine));
+    painter.drawRect(0, 0, GEM_SIZE, GEM_SIZE);
+    painter.drawRect(dx, dy, GEM_SIZE, GEM_SIZE);
+    painter.drawLine(GEM_SIZE / 2, GEM_SIZE / 2, dx + GEM_SIZE / 2,
+                     dy + GEM_SIZE / 2);
+  }
+
+  m_gemsValid = false;
+  m_background = QPixmap();
+}
+
+/**
+ * @brief 生成背景层实现
+ * 样式表背景只在这里画一次，之后每帧只复制
+ * @param widget 窗口
+ */
+void BoardRenderer::rebuildBackground(QWidget *widget) {
+  m_background = QPixmap(qRound(widget->width() * m_dpr),
+                         qRound(widget->height() * m_dpr));
+  m_background.setDevicePixelRatio(m_dpr);
+  m_background.fill(Qt::transparent);
+  QPainter painter(&m_background);
+  QStyleOption opt;
+  opt.initFrom(widget);
+  widget->style()->drawPrimitive(QStyle::PE_Widget, &opt, &painter, widget);
+}
+
+/**
+ * @brief 把宝石层中与地图不一致的格子重画实现
+ * 用 Source 模式直接覆盖格子，空格清为透明；变化的格子一次批量绘制
+ * @param map 地图
+ */
+void BoardRenderer::syncGems(const GameMap &map) {
+  if (!m_gemsValid) {
+    m_gems = QPixmap(qRound(COL * GEM_SIZE * m_dpr),
+                     qRound(ROW * GEM_SIZE * m_dpr));
+    m_gems.setDevicePixelRatio(m_dpr);
+    m_gems.fill(Qt::transparent);
+    for (int r = 0; r < ROW; r++) {
+      for (int c = 0; c < COL; c++) {
+        m_layerGems[r][c] = EMPTY;
+      }
+    }
+    m_gemsValid = true;
+  }
+
+  const int cell = m_atlas.height();          // 图集中一格的像素数
+  const qreal scale = qreal(GEM_SIZE) / cell; // 缩回逻辑尺寸 GEM_SIZE
+  QPainter::PixmapFragment fragments[ROW * COL];
+  int count = 0;
+  QPainter painter;
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      const GemType type = map.getGemType(r, c);
+      if (type == m_layerGems[r][c]) {
+        continue;
+      }
+      if (!painter.isActive()) {
+        painter.begin(&m_gems);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+      }
+      m_layerGems[r][c] = type;
+      if (type == EMPTY) {
+        painter.fillRect(c * GEM_SIZE, r * GEM_SIZE, GEM_SIZE, GEM_SIZE,
+                         Qt::transparent);
+        continue;
+      }
+      fragments[count++] = QPainter::PixmapFragment::create(
+          QPointF(c * GEM_SIZE + GEM_SIZE / 2.0, r * GEM_SIZE + GEM_SIZE / 2.0),
+          QRectF((type - 1) * cell, 0, cell, cell), scale, scale);
+    }
+  }
+  if (count > 0) {
+    painter.drawPixmapFragments(fragments, count, m_atlas);
+  }
+}
+
+/**
+ * @brief 把一层中落在重绘区域内的部分画到窗口实现
+ * 按重绘区域的各个矩形分别复制，不处理区域外的像素
+ * @param painter 窗口的绘制器
+ * @param layer 图层
+ * @param bounds 图层所在的矩形（窗口坐标）
+ * @param dirty 重绘区域
+ */
+void BoardRenderer::blit(QPainter &painter, const QPixmap &layer,
+                         const QRect &bounds, const QRegion &dirty) const {
+  for (const QRect &rect : dirty) {
+    const QRect part = rect & bounds;
+    if (part.isEmpty()) {
+      continue;
+    }
+    const QRectF source((part.x() - bounds.x()) * m_dpr,
+                        (part.y() - bounds.y()) * m_dpr,
+                        part.width() * m_dpr, part.height() * m_dpr);
+    painter.drawPixmap(QRectF(part), layer, source);
+  }
+}
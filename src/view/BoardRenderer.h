@@ -0,0 +1,103 @@
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include "GameMap.h"
+#include <QFont>
+#include <QPainter>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QRegion>
+#include <QStaticText>
+#include <QString>
+
+class QWidget;
+
+/**
+ * @brief 一帧的画面内容
+ * 由 GameWidget 在绘制时填写，渲染器只读取
+ */
+struct BoardFrame {
+  const GameMap *map; ///< 地图
+  QPoint origin;      ///< 第 0 行第 0 列格子的左上角（窗口坐标）
+  QPoint selected;    ///< 选中格（列, 行），(-1,-1) 表示未选
+  QPoint hint1;       ///< 提示格一（列, 行），无提示时为 (-1,-1)
+  QPoint hint2;       ///< 提示格二（列, 行），无提示时为 (-1,-1)
+  QString score;      ///< 分数文字
+  QFont scoreFont;    ///< 分数字体
+  QRect scoreRect;    ///< 分数标签的矩形（窗口坐标）
+};
+
+/**
+ * @brief 分层缓存的棋盘渲染器
+ * 画面分三层，每帧只在重绘区域内合成：
+ * 背景层缓存窗口样式背景，只在尺寸、样式或设备像素比变化时重新生成，结算中不会重画；
+ * 宝石层缓存整块棋盘，只重画与地图不一致的格子；
+ * 覆盖层的选中框、提示框为预先画好的小图，分数为缓存排版的 QStaticText
+ */
+class BoardRenderer {
+public:
+  static const int OVERLAY_MARGIN = 2; ///< 选中框与提示框超出格子的宽度
+  static const int SHADOW_OFFSET = 2;  ///< 分数阴影的偏移
+
+  BoardRenderer();
+
+  /**
+   * @brief 使背景层失效
+   * 窗口尺寸或样式表变化时调用，下一帧重新生成
+   */
+  void invalidateBackground();
+
+  /**
+   * @brief 绘制一帧
+   * @param painter 窗口的绘制器（已裁剪到重绘区域）
+   * @param widget 窗口，用于生成样式背景
+   * @param dirty 重绘区域
+   * @param frame 画面内容
+   */
+  void paint(QPainter &painter, QWidget *widget, const QRegion &dirty,
+             const BoardFrame &frame);
+
+private:
+  QPixmap m_background;          ///< 背景层（窗口大小）
+  QPixmap m_gems;                ///< 宝石层（棋盘大小）
+  GemType m_layerGems[ROW][COL]; ///< 宝石层中各格当前画的宝石
+  bool m_gemsValid;              ///< 宝石层是否已生成
+  QPixmap m_atlas;               ///< 预缩放的宝石图集，第 k 格为 GemType k + 1
+  QPixmap m_selection;           ///< 选中框小图
+  QPixmap m_hints[2];            ///< 提示框小图（0 横向相邻，1 纵向相邻）
+  QStaticText m_scoreText;       ///< 缓存排版的分数文字
+  QFont m_scoreFont;             ///< 分数文字排版所用的字体
+  qreal m_dpr;                   ///< 各层对应的设备像素比
+
+  /**
+   * @brief 生成与设备像素比相关的缓存
+   * 宝石图集与覆盖层小图；宝石层与背景层随之失效
+   * @param dpr 设备像素比
+   */
+  void rebuildSprites(qreal dpr);
+
+  /**
+   * @brief 生成背景层
+   * @param widget 窗口
+   */
+  void rebuildBackground(QWidget *widget);
+
+  /**
+   * @brief 把宝石层中与地图不一致的格子重画
+   * @param map 地图
+   */
+  void syncGems(const GameMap &map);
+
+  /**
+   * @brief 把一层中落在重绘区域内的部分画到窗口
+   * @param painter 窗口的绘制器
+   * @param layer 图层
+   * @param bounds 图层所在的矩形（窗口坐标）
+   * @param dirty 重绘区域
+   */
+  void blit(QPainter &painter, const QPixmap &layer, const QRect &bounds,
+            const QRegion &dirty) const;
+};
+
+#endif // BOARDRENDERER_H
@@ -1,10 +1,12 @@
 #include "GameWidget.h"
 #include "ui_GameWidget.h"
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
-#include <QStyleOption>
+#include <QPointer>
 
 /**
  * @brief GameWidget构造函数
@@ -12,13 +14,25 @@
  * @param parent 父窗口部件
  */
 GameWidget::GameWidget(QWidget *parent)
-    : QWidget(parent), ui(new Ui::GameWidget), m_game(new GameMap()),
+    : QWidget(parent), ui(new Ui::GameWidget), m_game(new GameSession()),
       m_stateTimer(new QTimer(this)),
       m_countTimer(new QTimer(this)), // 初始化计时定时器
-      m_selectedPos(-1, -1), m_state(IDLE), m_score(0), m_gameMode(ENDLESS),
-      m_challengeLevel(1), m_targetScore(1000), m_bgMusicPlayer(nullptr),
-      m_musicEnabled(true), m_musicBtn(nullptr), m_isHinting(false) {
+      m_stepInterval(STEP_INTERVAL_MS), m_selectedPos(-1, -1), m_state(IDLE),
+      m_gameMode(ENDLESS), m_challengeLevel(1), m_targetScore(1000),
+      m_bgMusicPlayer(nullptr), m_musicEnabled(true), m_musicBtn(nullptr),
+      m_isHinting(false), m_hintEngine(new HintEngine()), m_hintGeneration(0),
+      m_autoPlayer(new AutoPlayer()), m_autoPlaying(false),
+      m_autoGeneration(0), m_pendingDelta(0), m_hasPendingMove(false),
+      m_shownSelected(-1, -1) {
   ui->setupUi(this);
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      m_shownGems[r][c] = EMPTY;
+    }
+  }
+
+  // 补充宝石时避开死局，游戏中途不再整板重置和弹窗
+  m_game->map().setRefillPolicy(REFILL_PLAYABLE);
 
   // 初始化
   initGame();
@@ -35,6 +49,8 @@ GameWidget::GameWidget(QWidget *parent)
  * 释放所有资源
  */
 GameWidget::~GameWidget() {
+  delete m_hintEngine; // 先等待后台提示搜索与自动决策结束
+  delete m_autoPlayer;
   delete m_game;
   delete m_stateTimer;
   delete m_countTimer;
@@ -43,14 +59,21 @@ GameWidget::~GameWidget() {
 
 /**
  * @brief 初始化游戏
- * 重置游戏状态、地图、分数和UI
+ * 重置游戏状态、地图、分数和UI，并开始录制回放
+ * @param seed 随机种子
  */
-void GameWidget::initGame() {
-  // 初始化逻辑数据
-  m_game->clearHistory();
-  m_game->init();
+void GameWidget::initGame(uint64_t seed) {
+  // 初始化逻辑数据（清空历史、生成地图、分数归零）
+  // 每局重新设定种子，回放只需记录种子即可重建开局
+  m_game->map().setSeed(seed);
+  m_game->newGame();
+  m_replay.begin(*m_game);
+  m_replayClock.start();
+  m_hasPendingMove = false;
+  m_hintGeneration++;
+  m_autoGeneration++;
+  m_isHinting = false;
 
-  m_score = 0;
   m_selectedPos = QPoint(-1, -1);
   m_state = IDLE; // 重置游戏状态
 
@@ -82,7 +105,9 @@ void GameWidget::initGame() {
     ui->label_tarScore->setVisible(false);
   }
 
-  update();
+  // 自动对局开启时直接从新地图继续
+  requestAutoMove();
+  updateBoard();
 }
 
 /**
@@ -97,33 +122,38 @@ void GameWidget::updateTimeCount() {
   m_remainingTime--;
   ui->progressBar_time->setValue(m_remainingTime);
 
-  if (m_score >= m_targetScore) {
+  // 结算中途不过关，等地图稳定后的下一秒再判定：
+  // 回放把一次交换连同整个结算记为一个事件，分数清零只能落在两次交换之间
+  if (m_game->score() >= m_targetScore && !m_game->isResolving()) {
     int completedLevel = m_challengeLevel;
     int nextLevel = completedLevel + 1;
 
-    QMessageBox msgBox;
-    msgBox.setWindowTitle("关卡完成");
-    msgBox.setText(QString("恭喜！你完成了第%1关！\n进入第%2关！\n目标分数：%3")
-                       .arg(completedLevel)
-                       .arg(nextLevel)
-                       .arg(getChallengeTargetScore(nextLevel)));
-    msgBox.setStyleSheet(
-        "QLabel { color: black; } QPushButton { color: black; }");
-    msgBox.exec();
-
+    // 先进入下一关再弹窗，弹窗期间自动对局的交换记在分数清零之后
     m_challengeLevel = nextLevel;
     m_targetScore = getChallengeTargetScore(nextLevel);
     m_remainingTime = getChallengeTime(nextLevel);
 
     // 重置分数为0
-    m_score = 0;
+    m_game->setScore(0);
+    m_replay.recordScoreReset(replayDelta(), *m_game);
 
     // 更新UI显示
     ui->progressBar_time->setRange(0, m_remainingTime);
     ui->progressBar_time->setValue(m_remainingTime);
-    ui->label_score->setText(QString::number(m_score));
+    ui->label_score->setText(QString::number(m_game->score()));
     ui->label_tarScore->setText(
         QString::number(m_targetScore)); // 更新目标分数显示
+    updateBoard(); // 清零后的分数在弹窗前重绘
+
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("关卡完成");
+    msgBox.setText(QString("恭喜！你完成了第%1关！\n进入第%2关！\n目标分数：%3")
+                       .arg(completedLevel)
+                       .arg(nextLevel)
+                       .arg(getChallengeTargetScore(nextLevel)));
+    msgBox.setStyleSheet(
+        "QLabel { color: black; } QPushButton { color: black; }");
+    msgBox.exec();
     return;
   }
 
@@ -131,17 +161,19 @@ void GameWidget::updateTimeCount() {
     m_countTimer->stop();
     m_stateTimer->stop();
     m_state = GAME_OVER;
+    ui->btn_auto->setChecked(false);
+    saveReplay();
 
     QMessageBox msgBox;
     msgBox.setWindowTitle("游戏结束");
     msgBox.setText(QString("时间已到！\n你未完成第%1关！\n最终得分是：%2")
                        .arg(m_challengeLevel)
-                       .arg(m_score));
+                       .arg(m_game->score()));
     msgBox.setStyleSheet(
         "QLabel { color: black; } QPushButton { color: black; }");
     msgBox.exec();
 
-    emit gameOver(m_score, m_challengeLevel);
+    emit gameOver(m_game->score(), m_challengeLevel);
     emit backToMenu();
   }
 }
@@ -151,192 +183,95 @@ void GameWidget::updateTimeCount() {
  * 由定时器触发，处理消除->下落->生成的流程
  */
 void GameWidget::updateGameState() {
-  std::vector<QPoint> matches = m_game->checkMatches();
-
-  if (!matches.empty()) {
-    // 1. 计算本次消除的总分（按宝石颜色累加分值）
-    int roundScore = 0;
-    for (const auto &point : matches) {
-      int r = point.y(); // QPoint的y对应行，x对应列
-      int c = point.x();
-      roundScore += m_game->getGemScore(r, c); // 调用获取对应颜色分值的方法
+  const StepResult result = m_game->step();
+  switch (result) {
+  case STEP_ELIMINATED:
+    // 消除了一批宝石，刷新分数并继续下一个消除步骤
+    ui->label_score->setText(QString::number(m_game->score()));
+    m_stateTimer->start(m_stepInterval);
+    break;
+  case STEP_REFILLED:
+    // 下落后有新匹配，继续消除
+    m_stateTimer->start(m_stepInterval);
+    break;
+  case STEP_RESHUFFLED: {
+    // 下落完成后仍无匹配且为死局，会话已重置地图但保留分数
+    // （REFILL_PLAYABLE 策略下不会出现，仅作兜底）
+    // 重置同样由种子决定，回放中该交换的结算包含这次重置
+    if (m_hasPendingMove) {
+      m_replay.recordMove(m_pendingMove, m_pendingDelta, *m_game);
+      m_hasPendingMove = false;
     }
-
-    // 2. 执行消除操作
-    m_game->eliminate(matches);
-
-    // 3. 更新分数并刷新UI
-    m_score += roundScore;
-    ui->label_score->setText(QString::number(m_score));
-
-    // 继续下一个消除步骤
-    m_stateTimer->start(500);
-  } else {
-    // 无匹配时应用重力
-    m_game->applyGravity();
-    // 检查新的匹配
-    matches = m_game->checkMatches();
-    if (!matches.empty()) {
-      // 有新匹配继续消除
-      m_stateTimer->start(500);
-    } else {
-      // 下落完成后仍无匹配，检查是否为死局
-      if (!m_game->hasPossibleMove()) {
-        // 1. 显示死局提示对话框
-        QMessageBox msgBox;
-        msgBox.setWindowTitle("游戏提示");
-        msgBox.setText("当前已死局，即将重置地图！分数将保留。");
-        msgBox.setStyleSheet(
-            "QLabel { color: black; } QPushButton { color: black; }");
-        msgBox.exec();
-
-        // 2. 重置地图但不重置分数
-        m_game->reset(); // 仅重置地图宝石布局
-
-        // 3. 分数保持不变，无需修改m_score和label_score
-        qDebug() << "死局！已重置地图，分数保留";
-      }
-      // 停止定时器
-      m_stateTimer->stop();
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("游戏提示");
+    msgBox.setText("当前已死局，即将重置地图！分数将保留。");
+    msgBox.setStyleSheet(
+        "QLabel { color: black; } QPushButton { color: black; }");
+    msgBox.exec();
+    qDebug() << "死局！已重置地图，分数保留";
+    m_stateTimer->stop();
+    requestAutoMove();
+    break;
+  }
+  case STEP_SETTLED:
+    // 停止定时器，回合结算完成后记入回放，自动对局开启时请求下一步
+    m_stateTimer->stop();
+    if (m_hasPendingMove) {
+      m_replay.recordMove(m_pendingMove, m_pendingDelta, *m_game);
+      m_hasPendingMove = false;
     }
+    requestAutoMove();
+    break;
   }
-  // 刷新界面
-  update();
+  // 只重绘本阶段变化的格子与分数
+  updateBoard();
+  emit stepFinished(result);
 }
 
 /**
  * @brief 绘图事件处理函数
- * 负责绘制游戏界面的所有元素：背景、宝石、选中框、提示和分数
+ * 把当前画面内容交给分层渲染器，在重绘区域内合成背景、宝石、选中框、提示和分数
  * @param event 绘图事件
  */
 void GameWidget::paintEvent(QPaintEvent *event) {
-  Q_UNUSED(event);
   QPainter painter(this);
   painter.setRenderHint(QPainter::SmoothPixmapTransform); // 抗锯齿
 
-  // 绘制默认样式
-  QStyleOption opt;
-  opt.initFrom(this);
-  style()->drawPrimitive(QStyle::PE_Widget, &opt, &painter, this);
-
-  // 绘制宝石
-  // 获取游戏板的位置和大小
-  QRect boardRect = ui->frame_board->geometry();
-  int boardX = boardRect.x();
-  int boardY = boardRect.y();
-  int boardWidth = boardRect.width();
-  int boardHeight = boardRect.height();
-
-  // 计算宝石偏移量
-  int offsetX = (boardWidth - GEM_SIZE * COL) / 2;
-  int offsetY = (boardHeight - GEM_SIZE * ROW) / 2;
-
-  // 遍历地图，绘制所有宝石
-  for (int r = 0; r < ROW; r++) {
-    for (int c = 0; c < COL; c++) {
-      // 获取宝石类型
-      GemType gemType = m_game->getGemType(r, c);
-
-      // 根据宝石类型获取图片路径
-      QString imagePath;
-      switch (gemType) {
-      case RED:
-        imagePath = ":/gems/assets/images/red.png";
-        break;
-      case ORANGE:
-        imagePath = ":/gems/assets/images/orange.png";
-        break;
-      case YELLOW:
-        imagePath = ":/gems/assets/images/yellow.png";
-        break;
-      case GREEN:
-        imagePath = ":/gems/assets/images/green.png";
-        break;
-      case WHITE:
-        imagePath = ":/gems/assets/images/white.png";
-        break;
-      case BLUE:
-        imagePath = ":/gems/assets/images/blue.png";
-        break;
-      case PURPLE:
-        imagePath = ":/gems/assets/images/purple.png";
-        break;
-      default:
-        continue; // 跳过空宝石
-      }
-
-      // 加载并绘制宝石图片
-      QPixmap gemPixmap(imagePath);
-      if (!gemPixmap.isNull()) {
-        // 计算宝石的绘制位置
-        int x = boardX + offsetX + c * GEM_SIZE;
-        int y = boardY + offsetY + r * GEM_SIZE;
-
-        // 绘制宝石
-        painter.drawPixmap(x, y, GEM_SIZE, GEM_SIZE,
-                           gemPixmap.scaled(GEM_SIZE, GEM_SIZE,
-                                            Qt::KeepAspectRatio,
-                                            Qt::SmoothTransformation));
-      }
-    }
-  }
-
-  // 如果有选中的宝石，绘制选中框
-  if (m_selectedPos != QPoint(-1, -1)) {
-    int r = m_selectedPos.y();
-    int c = m_selectedPos.x();
-    int x = boardX + offsetX + c * GEM_SIZE;
-    int y = boardY + offsetY + r * GEM_SIZE;
-
-    // 绘制选中框（黄色边框）
-    QPen pen(QColor(255, 215, 0), 3);
-    painter.setPen(pen);
-    painter.drawRect(x, y, GEM_SIZE, GEM_SIZE);
-  }
+  BoardFrame frame;
+  frame.map = &m_game->map();
+  frame.origin = cellRect(0, 0).topLeft();
+  frame.selected = m_selectedPos;
+  const bool hinting = m_isHinting && m_hintPos1 != QPoint(-1, -1) &&
+                       m_hintPos2 != QPoint(-1, -1);
+  frame.hint1 = hinting ? m_hintPos1 : QPoint(-1, -1);
+  frame.hint2 = hinting ? m_hintPos2 : QPoint(-1, -1);
+  frame.score = ui->label_score->text();
+  frame.scoreFont = ui->label_score->font();
+  frame.scoreRect = ui->label_score->geometry();
+  m_renderer.paint(painter, this, event->region(), frame);
+}
 
-  // 如果有提示，绘制提示框（黄色虚线框）
-  if (m_isHinting && m_hintPos1 != QPoint(-1, -1) &&
-      m_hintPos2 != QPoint(-1, -1)) {
-    // 绘制第一个提示位置的框
-    int r1 = m_hintPos1.y();
-    int c1 = m_hintPos1.x();
-    int x1 = boardX + offsetX + c1 * GEM_SIZE;
-    int y1 = boardY + offsetY + r1 * GEM_SIZE;
-
-    QPen hintPen(QColor(255, 255, 0), 2, Qt::DashLine);
-    painter.setPen(hintPen);
-    painter.drawRect(x1, y1, GEM_SIZE, GEM_SIZE);
-
-    // 绘制第二个提示位置的框
-    int r2 = m_hintPos2.y();
-    int c2 = m_hintPos2.x();
-    int x2 = boardX + offsetX + c2 * GEM_SIZE;
-    int y2 = boardY + offsetY + r2 * GEM_SIZE;
-
-    painter.setPen(hintPen);
-    painter.drawRect(x2, y2, GEM_SIZE, GEM_SIZE);
-
-    // 在两个位置之间画一条连接线
-    painter.drawLine(x1 + GEM_SIZE / 2, y1 + GEM_SIZE / 2, x2 + GEM_SIZE / 2,
-                     y2 + GEM_SIZE / 2);
-  }
+/**
+ * @brief 尺寸变化事件处理函数
+ * 背景层按窗口大小缓存，需要重新生成
+ * @param event 尺寸变化事件
+ */
+void GameWidget::resizeEvent(QResizeEvent *event) {
+  m_renderer.invalidateBackground();
+  QWidget::resizeEvent(event);
+}
 
-  // 绘制分数
-  if (ui->label_score) {
-    // 绘制阴影（黑色，右下偏移2px）
-    painter.save(); // 保存当前画家状态
-    painter.setPen(Qt::black);
-    painter.setFont(ui->label_score->font());
-    QRect shadowRect = ui->label_score->geometry().translated(2, 2);
-    painter.drawText(shadowRect, Qt::AlignCenter, ui->label_score->text());
-    painter.restore(); // 恢复状态
-
-    // 绘制金色主文字
-    painter.setPen(QColor(255, 215, 0)); // 金色
-    painter.setFont(ui->label_score->font());
-    painter.drawText(ui->label_score->geometry(), Qt::AlignCenter,
-                     ui->label_score->text());
+/**
+ * @brief 状态变化事件处理函数
+ * 样式表或调色板变化后背景层需要重新生成
+ * @param event 事件
+ */
+void GameWidget::changeEvent(QEvent *event) {
+  if (event->type() == QEvent::StyleChange ||
+      event->type() == QEvent::PaletteChange) {
+    m_renderer.invalidateBackground();
   }
+  QWidget::changeEvent(event);
 }
 
 /**
@@ -372,26 +307,13 @@ void GameWidget::mousePressEvent(QMouseEvent *event) {
     }
 
     if (isAdjacent) {
-      // 交换前保存当前状态和分数
-      m_game->saveCurState(m_score);
-      m_game->swap(selectedR, selectedC, cur_r, cur_c);
-
-      std::vector<QPoint> matches = m_game->checkMatches();
-
-      if (matches.empty()) {
-        // 无匹配时交换回来，并删除无效快照
-        m_game->swap(cur_r, cur_c, selectedR, selectedC);
-        m_game->popLastState(); // 关键：清除无效状态
-      } else {
-        // 有匹配时开始消除流程
-        m_stateTimer->start(500);
-      }
+      applySwap(selectedR, selectedC, cur_r, cur_c);
     }
     // 清除选中状态
     m_selectedPos = QPoint(-1, -1);
   }
 
-  repaint();
+  updateBoard();
 }
 
 /**
@@ -401,22 +323,16 @@ void GameWidget::mousePressEvent(QMouseEvent *event) {
 void GameWidget::on_btn_reset_clicked() {
   m_countTimer->stop(); // 先停止当前计时
   initGame();           // 重新初始化游戏（会重新开始计时）
-  update();
+  updateBoard();
 }
 
 /**
  * @brief 提示按钮点击槽函数
- * 查找最佳移动并显示提示，3秒后自动隐藏
+ * 在后台查找最佳移动，结果返回后显示提示
  */
 void GameWidget::on_btn_hint_clicked() {
   findBestMove();
-  update();
-  QTimer::singleShot(1000, [this]() {
-    m_isHinting = false;
-    m_hintPos1 = QPoint(-1, -1);
-    m_hintPos2 = QPoint(-1, -1);
-    update();
-  });
+  updateBoard();
 }
 
 /**
@@ -425,105 +341,189 @@ void GameWidget::on_btn_hint_clicked() {
  */
 void GameWidget::on_btn_undo_clicked() {
   if (m_game->undo()) {
-    // 从GameMap获取撤销前的分数并更新
-    m_score = m_game->getLastUndoScore();
-    ui->label_score->setText(QString::number(m_score));
-    update();
+    m_replay.recordUndo(replayDelta(), *m_game);
+    m_hintGeneration++;
+    m_isHinting = false;
+    // 会话已恢复撤销前的分数
+    ui->label_score->setText(QString::number(m_game->score()));
+    requestAutoMove(); // 作废撤销前的自动决策，按新局面重新决策
+    updateBoard();
   }
 }
 
+/**
+ * @brief 自动按钮切换槽函数
+ * 开启后每当地图稳定就在后台决策下一步，经与玩家点击相同的入口交换
+ * @param checked true 表示开启自动对局
+ */
+void GameWidget::on_btn_auto_toggled(bool checked) {
+  m_autoPlaying = checked;
+  m_autoGeneration++;
+  // 正在结算时由 updateGameState 在回合结束后发起
+  requestAutoMove();
+}
+
 /**
  * @brief 结束游戏按钮点击槽函数
  * 处理结束游戏的逻辑，停止计时，显示最终得分，然后返回主菜单
  */
 void GameWidget::on_btn_endGame_clicked() {
-  // 停止计时器
+  // 停止计时器和自动对局
   m_countTimer->stop();
   m_stateTimer->stop();
+  ui->btn_auto->setChecked(false);
+  saveReplay();
 
   // 弹出消息框显示最终得分
   QMessageBox msgBox;
   if (m_gameMode == CHALLENGE) {
     msgBox.setWindowTitle("游戏结束");
-    if (m_score >= m_targetScore) {
+    if (m_game->score() >= m_targetScore) {
       msgBox.setText(QString("你结束了游戏！\n你完成了第%1关！\n最终得分是：%2")
                          .arg(m_challengeLevel)
-                         .arg(m_score));
+                         .arg(m_game->score()));
     } else {
       msgBox.setText(QString("你结束了游戏！\n你未完成第%1关！\n最终得分是：%2")
                          .arg(m_challengeLevel)
-                         .arg(m_score));
+                         .arg(m_game->score()));
     }
 
   } else {
     msgBox.setWindowTitle("游戏结束");
-    msgBox.setText(QString("你结束了游戏！\n最终得分是：%1").arg(m_score));
+    msgBox.setText(
+        QString("你结束了游戏！\n最终得分是：%1").arg(m_game->score()));
   }
   msgBox.setStyleSheet(
       "QLabel { color: black; } QPushButton { color: black; }");
   msgBox.exec();
 
   // 发出游戏结束信号和返回菜单信号
-  emit gameOver(m_score, m_challengeLevel);
+  emit gameOver(m_game->score(), m_challengeLevel);
   emit backToMenu();
 }
 
 /**
  * @brief 查找最佳移动
- * 遍历所有可能的移动，找到能获得最高分数的交换
+ * 交给提示引擎在后台对每个合法交换做连锁模拟与多步前瞻，
+ * 结果通过排队调用回到界面线程，由 showHint 显示
  */
 void GameWidget::findBestMove() {
   m_isHinting = false;
   m_hintPos1 = QPoint(-1, -1);
   m_hintPos2 = QPoint(-1, -1);
 
-  int bestScore = 0;
-
-  for (int r = 0; r < ROW; r++) {
-    for (int c = 0; c < COL; c++) {
-      const int dr[4] = {-1, 1, 0, 0}; // 上下左右四个方向
-      const int dc[4] = {0, 0, -1, 1};
-
-      for (int d = 0; d < 4; d++) {
-        int nr = r + dr[d];
-        int nc = c + dc[d];
-
-        if (nr < 0 || nr >= ROW || nc < 0 || nc >= COL)
-          continue;
-
-        GemType type1 = m_game->getGemType(r, c);
-        GemType type2 = m_game->getGemType(nr, nc);
-
-        if (type1 == type2)
-          continue; // 相同类型宝石交换无意义
+  // 在界面线程复制局面，搜索在引擎的线程池中进行，界面不阻塞
+  const int generation = ++m_hintGeneration;
+  QPointer<GameWidget> guard(this);
+  m_hintEngine->findBestMoveAsync(
+      m_game->map(), HINT_TIME_BUDGET_MS,
+      [guard, generation](const HintResult &result) {
+        if (!guard) {
+          return;
+        }
+        QMetaObject::invokeMethod(
+            guard.data(),
+            [guard, generation, result]() {
+              if (guard) {
+                guard->showHint(generation, result);
+              }
+            },
+            Qt::QueuedConnection);
+      });
+}
 
-        // 尝试交换
-        m_game->swap(r, c, nr, nc);
+/**
+ * @brief 显示提示搜索结果
+ * 显示 1 秒后自动隐藏
+ * @param generation 发起搜索时的代数
+ * @param result 搜索结果
+ */
+void GameWidget::showHint(int generation, const HintResult &result) {
+  if (generation != m_hintGeneration || !result.found ||
+      m_game->isResolving() || m_state == GAME_OVER) {
+    return;
+  }
+  m_hintPos1 = QPoint(result.move.c1, result.move.r1);
+  m_hintPos2 = QPoint(result.move.c2, result.move.r2);
+  m_isHinting = true;
+  updateBoard();
+
+  QTimer::singleShot(1000, this, [this, generation]() {
+    if (generation != m_hintGeneration) {
+      return; // 已有更新的提示或局面已变
+    }
+    m_isHinting = false;
+    m_hintPos1 = QPoint(-1, -1);
+    m_hintPos2 = QPoint(-1, -1);
+    updateBoard();
+  });
+}
 
-        // 检查是否有匹配
-        std::vector<QPoint> matches = m_game->checkMatches();
+/**
+ * @brief 交换两个宝石并开始结算
+ * 交换无匹配时会话会自动换回并清除快照；有匹配时开始消除流程
+ * @return true 表示交换被接受
+ */
+bool GameWidget::applySwap(int r1, int c1, int r2, int c2) {
+  if (!m_game->trySwap(r1, c1, r2, c2)) {
+    return false;
+  }
+  // 结算完成后再记入回放
+  m_pendingMove = Move{r1, c1, r2, c2};
+  m_pendingDelta = replayDelta();
+  m_hasPendingMove = true;
+  // 局面已变，正在进行的提示搜索与自动决策作废
+  m_hintGeneration++;
+  m_autoGeneration++;
+  m_isHinting = false;
+  m_stateTimer->start(m_stepInterval);
+  return true;
+}
 
-        // 计算得分
-        int moveScore = 0;
-        for (const auto &match : matches) {
-          int matchR = match.y();
-          int matchC = match.x();
-          moveScore += m_game->getGemScore(matchR, matchC);
+/**
+ * @brief 请求自动对局的下一步
+ * 未开启自动、游戏结束或正在结算时不请求
+ */
+void GameWidget::requestAutoMove() {
+  if (!m_autoPlaying || m_state == GAME_OVER || m_game->isResolving()) {
+    return;
+  }
+  const int generation = ++m_autoGeneration;
+  QPointer<GameWidget> guard(this);
+  m_autoPlayer->chooseMoveAsync(
+      m_game->map(), AUTOPLAY_TIME_BUDGET_MS,
+      [guard, generation](const AutoPlayResult &result) {
+        if (!guard) {
+          return;
         }
+        QMetaObject::invokeMethod(
+            guard.data(),
+            [guard, generation, result]() {
+              if (guard) {
+                guard->playAutoMove(generation, result);
+              }
+            },
+            Qt::QueuedConnection);
+      });
+}
 
-        // 交换回来
-        m_game->swap(r, c, nr, nc);
-
-        // 更新最佳移动
-        if (moveScore > bestScore) {
-          bestScore = moveScore;
-          m_hintPos1 = QPoint(c, r);
-          m_hintPos2 = QPoint(nc, nr);
-          m_isHinting = true;
-        }
-      }
-    }
+/**
+ * @brief 执行自动对局的决策结果
+ * 找不到可交换的步子时关闭自动对局
+ * @param generation 发起决策时的代数
+ * @param result 决策结果
+ */
+void GameWidget::playAutoMove(int generation, const AutoPlayResult &result) {
+  if (generation != m_autoGeneration || !m_autoPlaying ||
+      m_game->isResolving() || m_state == GAME_OVER) {
+    return;
   }
+  m_selectedPos = QPoint(-1, -1);
+  const Move &move = result.move;
+  if (!result.found || !applySwap(move.r1, move.c1, move.r2, move.c2)) {
+    ui->btn_auto->setChecked(false);
+  }
+  updateBoard();
 }
 
 /**
@@ -562,6 +562,84 @@ bool GameWidget::screenToRowCol(QPoint pt, int &r, int &c) {
   return false;
 }
 
+/**
+ * @brief 登记需要重绘的区域实现
+ * 结算中一个阶段通常只改动几列，选中一次只改动两个格子
+ */
+void GameWidget::updateBoard() {
+  for (int r = 0; r < ROW; r++) {
+    for (int c = 0; c < COL; c++) {
+      const GemType type = m_game->map().getGemType(r, c);
+      if (type != m_shownGems[r][c]) {
+        m_shownGems[r][c] = type;
+        update(cellRect(r, c));
+      }
+    }
+  }
+  if (m_selectedPos != m_shownSelected) {
+    update(selectionRect(m_shownSelected)); // 擦除旧选中框
+    update(selectionRect(m_selectedPos));
+    m_shownSelected = m_selectedPos;
+  }
+  const QRect hint = hintRect();
+  if (hint != m_shownHint) {
+    update(m_shownHint);
+    update(hint);
+    m_shownHint = hint;
+  }
+  if (ui->label_score->text() != m_shownScore) {
+    m_shownScore = ui->label_score->text();
+    update(scoreRect());
+  }
+}
+
+/**
+ * @brief 获取格子在窗口中的矩形实现
+ * 与 paintEvent、screenToRowCol 使用相同的居中偏移
+ * @param r 行
+ * @param c 列
+ * @return 矩形
+ */
+QRect GameWidget::cellRect(int r, int c) const {
+  const QRect boardRect = ui->frame_board->geometry();
+  const int offsetX = (boardRect.width() - GEM_SIZE * COL) / 2;
+  const int offsetY = (boardRect.height() - GEM_SIZE * ROW) / 2;
+  return QRect(boardRect.x() + offsetX + c * GEM_SIZE,
+               boardRect.y() + offsetY + r * GEM_SIZE, GEM_SIZE, GEM_SIZE);
+}
+
+/**
+ * @brief 获取选中框覆盖的矩形实现
+ * @param pos 选中格（列, 行）
+ * @return 矩形，未选时为空
+ */
+QRect GameWidget::selectionRect(QPoint pos) const {
+  if (pos == QPoint(-1, -1)) {
+    return QRect();
+  }
+  const int m = BoardRenderer::OVERLAY_MARGIN;
+  return cellRect(pos.y(), pos.x()).adjusted(-m, -m, m, m);
+}
+
+/**
+ * @brief 获取当前提示覆盖的矩形实现
+ * 两个提示格相邻，连接线落在它们的外接矩形内
+ * @return 矩形，无提示时为空
+ */
+QRect GameWidget::hintRect() const {
+  if (!m_isHinting || m_hintPos1 == QPoint(-1, -1) ||
+      m_hintPos2 == QPoint(-1, -1)) {
+    return QRect();
+  }
+  return selectionRect(m_hintPos1).united(selectionRect(m_hintPos2));
+}
+
+// 获取分数文字（含阴影）覆盖的矩形
+QRect GameWidget::scoreRect() const {
+  const int shadow = BoardRenderer::SHADOW_OFFSET;
+  return ui->label_score->geometry().adjusted(0, 0, shadow, shadow);
+}
+
 /**
  * @brief 设置游戏模式
  * @param mode 游戏模式（无尽模式/挑战模式）
@@ -592,14 +670,12 @@ void GameWidget::setChallengeLevel(int level) {
 
 /**
  * @brief 获取挑战模式下的关卡时间
+ * 规则在 Challenge.h 中，与批量模拟共用
  * @param level 关卡数
  * @return 关卡时间（秒），最低30秒
  */
 int GameWidget::getChallengeTime(int level) const {
-  int baseTime = 90;
-  int reduction = (level - 1) * 10; // 每关减少10秒，允许更多关卡
-  int minTime = 30;
-  return qMax(baseTime - reduction, minTime);
+  return challengeTime(level);
 }
 
 /**
@@ -608,8 +684,7 @@ int GameWidget::getChallengeTime(int level) const {
  * @return 目标分数，每关线性递增500
  */
 int GameWidget::getChallengeTargetScore(int level) const {
-  int baseScore = 1000;
-  return baseScore + (level - 1) * 500;
+  return challengeTargetScore(level);
 }
 
 /**
@@ -620,3 +695,74 @@ void GameWidget::setBgMusicPlayer(QMediaPlayer *player) {
   m_bgMusicPlayer = player;
   m_musicEnabled = true;
 }
+
+/**
+ * @brief 设置结算阶段的间隔
+ * 对正在进行的结算从下一个阶段起生效
+ * @param ms 间隔（毫秒）
+ */
+void GameWidget::setStepInterval(int ms) { m_stepInterval = qMax(ms, 0); }
+
+/**
+ * @brief 以指定种子开始新的一局
+ * @param seed 随机种子
+ */
+void GameWidget::newGame(uint64_t seed) {
+  m_stateTimer->stop();
+  initGame(seed);
+}
+
+/**
+ * @brief 执行一次交换
+ * @param move 交换操作
+ * @return true 表示交换被接受
+ */
+bool GameWidget::playMove(const Move &move) {
+  if (m_state == GAME_OVER || m_game->isResolving()) {
+    return false;
+  }
+  m_selectedPos = QPoint(-1, -1);
+  const bool accepted = applySwap(move.r1, move.c1, move.r2, move.c2);
+  updateBoard();
+  return accepted;
+}
+
+/**
+ * @brief 获取游戏会话
+ * @return 会话引用
+ */
+const GameSession &GameWidget::session() const { return *m_game; }
+
+/**
+ * @brief 取距上一个回放事件的时间
+ * @return 毫秒
+ */
+uint32_t GameWidget::replayDelta() {
+  return static_cast<uint32_t>(m_replayClock.restart());
+}
+
+/**
+ * @brief 保存本局回放
+ * 结算中途结束时，正在结算的交换不记入回放
+ */
+void GameWidget::saveReplay() {
+  const QString dirPath = "./datas/replays";
+  if (!QDir().mkpath(dirPath)) {
+    qDebug() << "无法创建回放目录" << dirPath;
+    return;
+  }
+  const QString fileName =
+      QString("%1/%2-%3-%4.bjr")
+          .arg(dirPath)
+          .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"))
+          .arg(m_gameMode == CHALLENGE ? "challenge" : "endless")
+          .arg(m_game->score());
+  const std::vector<uint8_t> bytes = m_replay.serialize();
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) ||
+      file.write(reinterpret_cast<const char *>(bytes.data()),
+                 static_cast<qint64>(bytes.size())) !=
+          static_cast<qint64>(bytes.size())) {
+    qDebug() << "无法写入回放文件" << fileName;
+  }
+}
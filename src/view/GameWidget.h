@@ -1,8 +1,14 @@
 #ifndef GAMEWIDGET_H
 #define GAMEWIDGET_H
 
+#include "AutoPlayer.h"
+#include "BoardRenderer.h"
+#include "Challenge.h"
 #include "Const.h"
-#include "GameMap.h"
+#include "GameSession.h"
+#include "HintEngine.h"
+#include "Replay.h"
+#include <QElapsedTimer>
 #include <QMediaPlayer>
 #include <QMouseEvent>
 #include <QPainter>
@@ -61,6 +67,35 @@ public:
    */
   void setBgMusicPlayer(QMediaPlayer *player);
 
+  /**
+   * @brief 设置结算阶段的间隔
+   * 默认 STEP_INTERVAL_MS；0 表示事件循环一空闲就推进下一阶段，
+   * 供无界面吞吐基准去掉动画节奏
+   * @param ms 间隔（毫秒）
+   */
+  void setStepInterval(int ms);
+
+  /**
+   * @brief 以指定种子开始新的一局
+   * 相同种子与相同的交换序列得到相同的对局
+   * @param seed 随机种子
+   */
+  void newGame(uint64_t seed);
+
+  /**
+   * @brief 执行一次交换
+   * 与玩家点击、自动对局走同一个入口；游戏结束或正在结算时不执行
+   * @param move 交换操作
+   * @return true 表示交换被接受并开始结算
+   */
+  bool playMove(const Move &move);
+
+  /**
+   * @brief 获取游戏会话（只读）
+   * @return 会话引用
+   */
+  const GameSession &session() const;
+
 signals:
   /**
    * @brief 游戏结束信号
@@ -74,13 +109,32 @@ signals:
    */
   void backToMenu();
 
+  /**
+   * @brief 结算阶段推进信号
+   * 定时器推进一个阶段并请求重绘后发出
+   * @param result 本阶段结果
+   */
+  void stepFinished(StepResult result);
+
 protected:
   /**
    * @brief 绘图事件
-   * 负责将游戏地图数据绘制为宝石图片
+   * 由分层渲染器在重绘区域内合成背景、宝石与覆盖层
    */
   void paintEvent(QPaintEvent *event) override;
 
+  /**
+   * @brief 尺寸变化事件
+   * 使背景层缓存失效
+   */
+  void resizeEvent(QResizeEvent *event) override;
+
+  /**
+   * @brief 状态变化事件
+   * 样式变化时使背景层缓存失效
+   */
+  void changeEvent(QEvent *event) override;
+
   /**
    * @brief 鼠标点击事件
    * 处理宝石的选中和交换逻辑
@@ -103,6 +157,12 @@ private slots:
    */
   void on_btn_undo_clicked();
 
+  /**
+   * @brief 自动按钮切换槽函数
+   * @param checked true 表示开启自动对局
+   */
+  void on_btn_auto_toggled(bool checked);
+
   /**
    * @brief 结束游戏按钮点击槽函数
    */
@@ -122,24 +182,28 @@ private slots:
 
 private:
   Ui::GameWidget *ui;   ///< UI 指针
-  GameMap *m_game;      ///< 游戏逻辑模型指针
+  GameSession *m_game;  ///< 游戏会话（回合规则与分数）
   QTimer *m_stateTimer; ///< 动画流程定时器
   QTimer *m_countTimer; ///< 计时定时器
+  int m_stepInterval;   ///< 结算阶段间隔（毫秒）
 
   // 游戏状态
   QPoint m_selectedPos; ///< 当前选中宝石的数组行列坐标 (-1,-1 表示未选)
   GameState m_state;    ///< 当前游戏阶段
   GameMode m_gameMode;  ///< 游戏模式
 
-  int m_score;          ///< 当前得分
   int m_challengeLevel; ///< 当前关卡
   int m_targetScore;    ///< 目标分数（闯关模式）
 
   QMediaPlayer *m_bgMusicPlayer; ///< 背景音乐播放器
   bool m_musicEnabled;           ///< 音乐开关状态
 
-  // 辅助函数
-  void initGame();     ///< 游戏初始化
+  /**
+   * @brief 游戏初始化
+   * 以给定种子开局并开始录制回放
+   * @param seed 随机种子，默认取熵源
+   */
+  void initGame(uint64_t seed = Random::entropySeed());
   int m_remainingTime; ///< 剩余时间（秒）
 
   QPushButton *m_musicBtn; ///< 音乐控制按钮
@@ -159,11 +223,106 @@ private:
   int getChallengeTargetScore(int level) const;
 
   // 提示功能相关
-  void findBestMove(); ///< 查找最佳移动
+  void findBestMove(); ///< 查找最佳移动（后台搜索，结果异步返回）
   QPoint m_hintPos1;   ///< 提示位置1
   QPoint m_hintPos2;   ///< 提示位置2
   bool m_isHinting;    ///< 是否正在显示提示
 
+  HintEngine *m_hintEngine; ///< 前瞻提示引擎（后台线程池）
+  int m_hintGeneration;     ///< 提示请求代数，局面被玩家改变后旧结果作废
+
+  /**
+   * @brief 显示提示搜索结果
+   * 在界面线程中执行；代数不一致或正在结算时丢弃结果
+   * @param generation 发起搜索时的代数
+   * @param result 搜索结果
+   */
+  void showHint(int generation, const HintResult &result);
+
+  /**
+   * @brief 交换两个宝石并开始结算
+   * 玩家点击与自动对局共用的交换入口
+   * @return true 表示交换被接受
+   */
+  bool applySwap(int r1, int c1, int r2, int c2);
+
+  // 自动对局相关
+  AutoPlayer *m_autoPlayer; ///< 蒙特卡洛树搜索自动对局器（后台线程池）
+  bool m_autoPlaying;       ///< 是否正在自动对局
+  int m_autoGeneration;     ///< 自动决策请求代数，局面改变后旧结果作废
+
+  /**
+   * @brief 请求自动对局的下一步
+   * 地图稳定时调用，决策在后台进行，结果由 playAutoMove 执行
+   */
+  void requestAutoMove();
+
+  /**
+   * @brief 执行自动对局的决策结果
+   * 在界面线程中执行；代数不一致、已关闭自动或正在结算时丢弃结果
+   * @param generation 发起决策时的代数
+   * @param result 决策结果
+   */
+  void playAutoMove(int generation, const AutoPlayResult &result);
+
+  // 回放录制相关
+  Replay m_replay;             ///< 本局回放
+  QElapsedTimer m_replayClock; ///< 距上一个回放事件的计时
+  Move m_pendingMove;          ///< 正在结算的交换，结算完成后记入回放
+  uint32_t m_pendingDelta;     ///< 正在结算的交换距上一事件的时间（毫秒）
+  bool m_hasPendingMove;       ///< 是否有待记录的交换
+
+  /**
+   * @brief 取距上一个回放事件的时间并重新计时
+   * @return 毫秒
+   */
+  uint32_t replayDelta();
+
+  /**
+   * @brief 保存本局回放
+   * 写到 ./datas/replays/，文件名含结束时间、模式与得分
+   */
+  void saveReplay();
+
+  BoardRenderer m_renderer; ///< 分层缓存的棋盘渲染器
+
+  // 局部重绘相关：记录最近一次登记重绘时的画面内容，只重绘与之不同的部分
+  GemType m_shownGems[ROW][COL]; ///< 已登记重绘的各格宝石
+  QPoint m_shownSelected;        ///< 已登记重绘的选中格
+  QRect m_shownHint;             ///< 已登记重绘的提示区域，空表示无提示
+  QString m_shownScore;          ///< 已登记重绘的分数文字
+
+  /**
+   * @brief 登记需要重绘的区域
+   * 与上次登记时比较各格宝石、选中框、提示与分数，只对变化的矩形调用 update(QRect)；
+   * 同一轮事件循环内的多次登记由 Qt 合并为一次绘制
+   */
+  void updateBoard();
+
+  /**
+   * @brief 获取格子在窗口中的矩形
+   * @param r 行
+   * @param c 列
+   * @return 矩形
+   */
+  QRect cellRect(int r, int c) const;
+
+  /**
+   * @brief 获取选中框覆盖的矩形
+   * @param pos 选中格（列, 行），(-1,-1) 表示未选
+   * @return 矩形，未选时为空
+   */
+  QRect selectionRect(QPoint pos) const;
+
+  /**
+   * @brief 获取当前提示覆盖的矩形
+   * @return 两个提示格及连接线的外接矩形，无提示时为空
+   */
+  QRect hintRect() const;
+
+  // 获取分数文字（含阴影）覆盖的矩形
+  QRect scoreRect() const;
+
   /**
    * @brief 坐标转换：屏幕像素坐标 -> 数组行列坐标
    * @param pt 屏幕像素坐标
@@ -0,0 +1,35 @@
+QT       += core gui multimedia
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+TARGET = BejeweledGame
+
+# 游戏规则库
+include(../model/gamecore.pri)
+
+# 包含路径
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    ../../main.cpp \
+    BoardRenderer.cpp \
+    GameWidget.cpp \
+    MenuWidget.cpp \
+    RankingWidget.cpp
+
+HEADERS += \
+    BoardRenderer.h \
+    GameWidget.h \
+    MenuWidget.h \
+    RankingWidget.h
+
+FORMS += \
+    GameWidget.ui \
+    MenuWidget.ui \
+    RankingWidget.ui
+
+RESOURCES += \
+    ../../resources.qrc
+
+DESTDIR = $$top_builddir/bin